@@ -98,6 +98,15 @@ INSTALL() {
   make -j8
   make install
 )
+# lz4
+(
+  CLONE https://github.com/lz4 lz4 --depth=1
+  make -C lib -j8 install                 \
+    CC=arm-linux-androideabi-clang        \
+    AR=arm-linux-androideabi-ar           \
+    PREFIX=$TOOLCHAIN/sysroot/usr         \
+    BUILD_SHARED=no
+)
 # toxcore
 (
   CLONE https://github.com/irungentoo toxcore --depth=1
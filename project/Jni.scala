@@ -35,6 +35,9 @@ object Jni extends Plugin {
     val ccOptions = settingKey[Seq[String]]("Flags to be passed to the native compiler when compiling")
     val ldOptions = settingKey[Seq[String]]("Flags to be passed to the native compiler when linking")
 
+    val optimization = settingKey[String]("Release optimisation mode [none, lto, pgo-generate, pgo-use]")
+    val profilePath = settingKey[File]("Profiles written by pgo-generate and read by pgo-use")
+
     val buildTool = settingKey[BuildTool.T]("Build tool to use [make, ninja]")
     val buildFlags = settingKey[Seq[String]]("Flags to be passed to the build tool")
 
@@ -280,6 +283,10 @@ object Jni extends Plugin {
     ccOptions := Nil,
     ldOptions := Nil,
 
+    // Default build unless TOX4J_OPTIMIZE is set; see CMakeLists.txt and tools/pgo-build.
+    optimization := Option(System.getenv("TOX4J_OPTIMIZE")).getOrElse("none"),
+    profilePath := nativeTarget.value / "profile",
+
     // Build with parallel tasks by default.
     buildTool := {
       import BuildTool._
@@ -327,6 +334,10 @@ object Jni extends Plugin {
     ccOptions ++= checkCcOptions(nativeCXX.value, "", Seq("-DGOOGLE_PROTOBUF_NO_RTTI")),
     ccOptions ++= checkCcOptions(nativeCXX.value, "", Seq("-DGTEST_HAS_RTTI=0")),
 
+    // Threads for background I/O (e.g. autosave).
+    ccOptions ++= checkCcOptions(nativeCXX.value, "", Seq("-pthread")),
+    ldOptions ++= checkCcOptions(nativeCXX.value, "", Seq("-pthread")),
+
     // Error on undefined references in shared object.
     ldOptions ++= checkCcOptions(nativeCXX.value, "", Seq("-Wl,-z,defs")),
 
@@ -393,6 +404,7 @@ object Jni extends Plugin {
 
         out.println(s"set(CMAKE_LIBRARY_OUTPUT_DIRECTORY ${binPath.value})")
         out.println(s"add_library(${libraryName.value} SHARED ${mainSources.mkString(" ")})")
+        out.println(s"set(TOX4J_LIBRARY ${libraryName.value})")
       } finally {
         out.close()
       }
@@ -548,6 +560,8 @@ SET(CMAKE_FIND_ROOT_PATH_MODE_INCLUDE ONLY)""")
             "-DDEPENDENCIES_FILE=" + cmakeDependenciesFile.value,
             "-DMAIN_FILE=" + cmakeMainFile.value,
             "-DTEST_FILE=" + cmakeTestFile.value,
+            "-DTOX4J_OPTIMIZE=" + optimization.value,
+            "-DTOX4J_PROFILE_DIR=" + profilePath.value,
             baseDirectory.value.getPath
           ) ++ flags,
           buildPath,
@@ -0,0 +1,43 @@
+#include "bench.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+
+/*
+ * Replaces the global operator new for the whole benchmark executable, including the library code it calls, so that
+ * benchmarks can check that a path does not allocate (bench_state::expect_no_allocations). Only C++ allocations are
+ * counted. The C libraries below the AV shim allocate on their own, e.g. the old A/V library callocs every RTP packet,
+ * and we cannot change that.
+ */
+
+namespace {
+
+std::atomic<size_t> allocations(0);
+
+}
+
+
+size_t allocation_count() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+
+// The library is built without exceptions, so running out of memory aborts instead of throwing std::bad_alloc.
+void *operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void *memory = std::malloc(size != 0 ? size : 1);
+    if (memory == nullptr) {
+        std::abort();
+    }
+    return memory;
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept {
+    std::free(memory);
+}
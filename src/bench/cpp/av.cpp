@@ -0,0 +1,180 @@
+#include "bench.h"
+
+#include "tox/av.h"
+#include "tox/core.h"
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+
+/*
+ * The audio send path of a running call between two instances in this process, talking over loopback.
+ */
+
+namespace {
+
+// Every callback is called unconditionally, so each one needs a function, even if the benchmark ignores the event.
+template<typename... Args>
+void ignore(Args...) { }
+
+
+struct side {
+    Tox *tox = nullptr;
+    ToxAV *av = nullptr;
+    bool connected = false;
+    bool incoming = false;
+    bool sending = false;
+};
+
+void on_friend_connection_status(Tox *, uint32_t, TOX_CONNECTION connection_status, void *user_data) {
+    static_cast<side *>(user_data)->connected = connection_status != TOX_CONNECTION_NONE;
+}
+
+void on_call(ToxAV *, uint32_t, bool, bool, void *user_data) {
+    static_cast<side *>(user_data)->incoming = true;
+}
+
+void on_call_state(ToxAV *, uint32_t, TOXAV_CALL_STATE state, void *user_data) {
+    static_cast<side *>(user_data)->sending = state == TOXAV_CALL_STATE_SENDING_A || state == TOXAV_CALL_STATE_SENDING_AV;
+}
+
+void register_callbacks(side &self) {
+    tox_callback_connection_status(self.tox, ignore, nullptr);
+    tox_callback_friend_name(self.tox, ignore, nullptr);
+    tox_callback_friend_status_message(self.tox, ignore, nullptr);
+    tox_callback_friend_status(self.tox, ignore, nullptr);
+    tox_callback_friend_connection_status(self.tox, on_friend_connection_status, &self);
+    tox_callback_friend_typing(self.tox, ignore, nullptr);
+    tox_callback_read_receipt(self.tox, ignore, nullptr);
+    tox_callback_friend_request(self.tox, ignore, nullptr);
+    tox_callback_friend_message(self.tox, ignore, nullptr);
+    tox_callback_friend_action(self.tox, ignore, nullptr);
+    tox_callback_file_control(self.tox, ignore, nullptr);
+    tox_callback_file_request_chunk(self.tox, ignore, nullptr);
+    tox_callback_file_receive(self.tox, ignore, nullptr);
+    tox_callback_file_receive_chunk(self.tox, ignore, nullptr);
+    tox_callback_file_progress(self.tox, ignore, nullptr);
+    tox_callback_friend_lossy_packet(self.tox, ignore, nullptr);
+    tox_callback_friend_lossless_packet(self.tox, ignore, nullptr);
+}
+
+void register_callbacks_av(side &self) {
+    toxav_callback_call(self.av, on_call, &self);
+    toxav_callback_call_state(self.av, on_call_state, &self);
+    toxav_callback_request_video_frame(self.av, ignore, nullptr);
+    toxav_callback_request_audio_frame(self.av, ignore, nullptr);
+    toxav_callback_receive_video_frame(self.av, ignore, nullptr);
+    toxav_callback_receive_audio_frame(self.av, ignore, nullptr);
+}
+
+// Runs both instances until the condition holds, or gives up after ten seconds.
+template<typename Condition>
+bool iterate_until(side *sides, Condition condition) {
+    auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        for (int i = 0; i < 2; i++) {
+            tox_iteration(sides[i].tox);
+            if (sides[i].av != nullptr) {
+                toxav_iteration(sides[i].av);
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+/*
+ * Side 0 calls side 1, which answers. Set up once and never torn down: connecting two instances takes seconds, far
+ * too long to repeat for every calibration run. Returns nullptr if the call could not be established.
+ */
+side *shared_call() {
+    static side sides[2];
+    static bool const established = [] {
+        Tox_Options options;
+        tox_options_default(&options);
+        options.ipv6_enabled = false;
+
+        for (side &self : sides) {
+            self.tox = tox_new(&options, nullptr, 0, nullptr);
+            if (self.tox == nullptr) {
+                return false;
+            }
+            register_callbacks(self);
+        }
+
+        uint8_t dht_id[TOX_PUBLIC_KEY_SIZE];
+        uint8_t public_key[TOX_PUBLIC_KEY_SIZE];
+        for (int i = 0; i < 2; i++) {
+            Tox *other = sides[1 - i].tox;
+            tox_get_dht_id(other, dht_id);
+            tox_bootstrap(sides[i].tox, "127.0.0.1", tox_get_udp_port(other, nullptr), dht_id, nullptr);
+            tox_self_get_public_key(other, public_key);
+            tox_friend_add_norequest(sides[i].tox, public_key, nullptr);
+        }
+
+        if (!iterate_until(sides, [] { return sides[0].connected && sides[1].connected; })) {
+            return false;
+        }
+
+        for (side &self : sides) {
+            self.av = toxav_new(self.tox, nullptr);
+            if (self.av == nullptr) {
+                return false;
+            }
+            register_callbacks_av(self);
+        }
+
+        // Friend number 0 on both sides is the other instance.
+        if (!toxav_call(sides[0].av, 0, 48, 0, nullptr)) {
+            return false;
+        }
+        if (!iterate_until(sides, [] { return sides[1].incoming; })) {
+            return false;
+        }
+        if (!toxav_answer(sides[1].av, 0, 48, 0, nullptr)) {
+            return false;
+        }
+        return iterate_until(sides, [] { return sides[0].sending; });
+    }();
+    return established ? sides : nullptr;
+}
+
+
+// One 20 ms frame per iteration. The first frames create the encoder and the resampler and size their buffers; after
+// that, the C++ part of the send path must not allocate.
+void send_audio_frame(bench_state &state, uint32_t sampling_rate, uint8_t channels) {
+    side *sides = shared_call();
+    if (sides == nullptr) {
+        state.skip("could not establish a call over loopback");
+        return;
+    }
+
+    size_t const samples = sampling_rate / 50;
+    std::vector<int16_t> pcm(samples * channels);
+    for (size_t i = 0; i < pcm.size(); i++) {
+        pcm[i] = (i * 440 % 48000) * 2 - 24000;
+    }
+
+    for (int i = 0; i < 100; i++) {
+        toxav_send_audio_frame(sides[0].av, 0, pcm.data(), samples, channels, sampling_rate, nullptr);
+    }
+
+    state.expect_no_allocations();
+    state.set_bytes(pcm.size() * sizeof(int16_t));
+    while (state.running()) {
+        keep(toxav_send_audio_frame(sides[0].av, 0, pcm.data(), samples, channels, sampling_rate, nullptr));
+    }
+}
+
+void send_audio_frame_48000_mono(bench_state &state) { send_audio_frame(state, 48000, 1); }
+void send_audio_frame_44100_stereo(bench_state &state) { send_audio_frame(state, 44100, 2); }
+
+BENCHMARK("av/send-audio-frame/48000m", send_audio_frame_48000_mono);
+BENCHMARK("av/send-audio-frame/44100s", send_audio_frame_44100_stereo);
+
+}
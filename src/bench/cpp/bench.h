@@ -0,0 +1,95 @@
+#pragma once
+
+#include <jni.h>
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+
+// Number of C++ allocations in this process so far, counted by the operator new in allocations.cpp.
+size_t allocation_count();
+
+
+/*
+ * Minimal benchmark harness. A benchmark is a function taking a bench_state. It does its set-up, then runs the
+ * measured code in a `while (state.running())` loop. The runner in main.cpp picks the iteration count, repeats the
+ * measurement and prints one JSON object per benchmark.
+ */
+class bench_state {
+public:
+    typedef std::chrono::steady_clock clock;
+
+    bench_state(JNIEnv *env, size_t iterations)
+    : env_(env)
+    , iterations_(iterations)
+    { }
+
+    // The clock starts on the first call and stops on the call that returns false, so set-up before the loop and
+    // clean-up after it are not measured.
+    bool running() {
+        if (done_ == 0) {
+            allocations_ = allocation_count();
+            start_ = clock::now();
+        }
+        if (done_ == iterations_) {
+            stop_ = clock::now();
+            allocations_ = allocation_count() - allocations_;
+            return false;
+        }
+        done_++;
+        return true;
+    }
+
+    // The embedded JVM, or nullptr if there is none.
+    JNIEnv *env() const { return env_; }
+
+    size_t iterations() const { return iterations_; }
+    clock::duration elapsed() const { return stop_ - start_; }
+
+    // Number of allocations in the measured loop. Set-up before it, including any warm-up, is not counted.
+    size_t allocations() const { return allocations_; }
+
+    // Make the run fail if the measured loop allocates.
+    void expect_no_allocations() { no_allocations_ = true; }
+    bool expects_no_allocations() const { return no_allocations_; }
+
+    // Payload processed per iteration, reported as throughput.
+    void set_bytes(size_t bytes) { bytes_ = bytes; }
+    size_t bytes() const { return bytes_; }
+
+    // Give up on this benchmark, e.g. because it needs a JVM.
+    void skip(std::string const &reason) { skipped_ = reason; }
+    std::string const &skipped() const { return skipped_; }
+
+private:
+    JNIEnv *const env_;
+    size_t const iterations_;
+    size_t done_ = 0;
+    size_t bytes_ = 0;
+    size_t allocations_ = 0;
+    bool no_allocations_ = false;
+    clock::time_point start_;
+    clock::time_point stop_;
+    std::string skipped_;
+};
+
+
+// Keep the compiler from discarding a computation whose result is otherwise unused.
+template<typename T>
+static inline void keep(T const &value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+
+typedef void (*bench_function)(bench_state &state);
+
+struct bench_registration {
+    bench_registration(char const *name, bench_function function);
+};
+
+#define BENCH_CAT(a, b) BENCH_CAT_(a, b)
+#define BENCH_CAT_(a, b) a##b
+
+#define BENCHMARK(NAME, FUNCTION) \
+    static bench_registration const BENCH_CAT(bench_registration_, __LINE__)(NAME, FUNCTION)
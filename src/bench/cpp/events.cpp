@@ -0,0 +1,216 @@
+#include "bench.h"
+
+#include "tox4j/Tox4j.h"
+
+#include <vector>
+
+
+/*
+ * Building one event of each kind in a CoreEvents or AvEvents object tree, then serialising it with ByteSize and
+ * SerializeToArray. This is how the callbacks and toxIteration worked before events were encoded straight into an
+ * event_stream; it is the baseline for the stream/ benchmarks in stream.cpp. Payload sizes are those of a typical
+ * event of the kind: a short message, a full file chunk, a 20 ms stereo audio frame, a 640x480 video frame.
+ */
+
+namespace {
+
+std::vector<uint8_t> const key(32, 0x42);
+std::vector<uint8_t> const text(128, 'x');
+std::vector<uint8_t> const name(32, 'n');
+std::vector<uint8_t> const chunk(1371, 0xaa);
+std::vector<uint8_t> const packet(1024, 0xbb);
+std::vector<int16_t> const pcm(960 * 2, 1000);
+std::vector<uint8_t> const plane(640 * 480, 0x80);
+
+
+namespace cp = core::proto;
+namespace ap = av::proto;
+
+
+template<typename Events, typename Build>
+void build_and_serialize(bench_state &state, Build build) {
+    Events events;
+    std::vector<char> buffer;
+    while (state.running()) {
+        build(events);
+
+        buffer.resize(events.ByteSize());
+        events.SerializeToArray(buffer.data(), buffer.size());
+        events.Clear();
+        keep(buffer.data());
+    }
+    state.set_bytes(buffer.size());
+}
+
+#define CORE_EVENT(NAME, ...)                                                   \
+    void core_##NAME(bench_state &state) {                                      \
+        build_and_serialize<cp::CoreEvents>(state, [](cp::CoreEvents &events) { \
+            __VA_ARGS__                                                         \
+        });                                                                     \
+    }                                                                           \
+    BENCHMARK("events/core/" #NAME, core_##NAME)
+
+#define AV_EVENT(NAME, ...)                                                     \
+    void av_##NAME(bench_state &state) {                                        \
+        build_and_serialize<ap::AvEvents>(state, [](ap::AvEvents &events) {     \
+            __VA_ARGS__                                                         \
+        });                                                                     \
+    }                                                                           \
+    BENCHMARK("events/av/" #NAME, av_##NAME)
+
+
+CORE_EVENT(ConnectionStatus, {
+    events.add_connectionstatus()->set_connectionstatus(cp::UDP4);
+});
+
+CORE_EVENT(FileControl, {
+    auto msg = events.add_filecontrol();
+    msg->set_friendnumber(1);
+    msg->set_filenumber(2);
+    msg->set_control(cp::FileControl::PAUSE);
+});
+
+CORE_EVENT(FileReceive, {
+    auto msg = events.add_filereceive();
+    msg->set_friendnumber(1);
+    msg->set_filenumber(2);
+    msg->set_kind(cp::FileReceive::DATA);
+    msg->set_filesize(1 << 20);
+    msg->set_filename(name.data(), name.size());
+});
+
+CORE_EVENT(FileReceiveChunk, {
+    auto msg = events.add_filereceivechunk();
+    msg->set_friendnumber(1);
+    msg->set_filenumber(2);
+    msg->set_position(4096);
+    msg->set_data(chunk.data(), chunk.size());
+});
+
+CORE_EVENT(FileRequestChunk, {
+    auto msg = events.add_filerequestchunk();
+    msg->set_friendnumber(1);
+    msg->set_filenumber(2);
+    msg->set_position(4096);
+    msg->set_length(chunk.size());
+});
+
+CORE_EVENT(FileProgress, {
+    auto msg = events.add_fileprogress();
+    msg->set_friendnumber(1);
+    msg->set_filenumber(2);
+    msg->set_position(4096);
+});
+
+CORE_EVENT(FriendAction, {
+    auto msg = events.add_friendaction();
+    msg->set_friendnumber(1);
+    msg->set_timedelta(0);
+    msg->set_action(text.data(), text.size());
+});
+
+CORE_EVENT(FriendConnectionStatus, {
+    auto msg = events.add_friendconnectionstatus();
+    msg->set_friendnumber(1);
+    msg->set_connectionstatus(cp::UDP4);
+});
+
+CORE_EVENT(FriendMessage, {
+    auto msg = events.add_friendmessage();
+    msg->set_friendnumber(1);
+    msg->set_timedelta(0);
+    msg->set_message(text.data(), text.size());
+});
+
+CORE_EVENT(FriendName, {
+    auto msg = events.add_friendname();
+    msg->set_friendnumber(1);
+    msg->set_name(name.data(), name.size());
+});
+
+CORE_EVENT(FriendRequest, {
+    auto msg = events.add_friendrequest();
+    msg->set_publickey(key.data(), key.size());
+    msg->set_timedelta(0);
+    msg->set_message(text.data(), text.size());
+});
+
+CORE_EVENT(FriendStatus, {
+    auto msg = events.add_friendstatus();
+    msg->set_friendnumber(1);
+    msg->set_status(cp::FriendStatus::AWAY);
+});
+
+CORE_EVENT(FriendStatusMessage, {
+    auto msg = events.add_friendstatusmessage();
+    msg->set_friendnumber(1);
+    msg->set_message(text.data(), text.size());
+});
+
+CORE_EVENT(FriendTyping, {
+    auto msg = events.add_friendtyping();
+    msg->set_friendnumber(1);
+    msg->set_istyping(true);
+});
+
+CORE_EVENT(FriendLosslessPacket, {
+    auto msg = events.add_friendlosslesspacket();
+    msg->set_friendnumber(1);
+    msg->set_data(packet.data(), packet.size());
+});
+
+CORE_EVENT(FriendLossyPacket, {
+    auto msg = events.add_friendlossypacket();
+    msg->set_friendnumber(1);
+    msg->set_data(packet.data(), packet.size());
+});
+
+CORE_EVENT(ReadReceipt, {
+    auto msg = events.add_readreceipt();
+    msg->set_friendnumber(1);
+    msg->set_messageid(42);
+});
+
+
+AV_EVENT(Call, {
+    auto msg = events.add_call();
+    msg->set_friendnumber(1);
+    msg->set_audioenabled(true);
+    msg->set_videoenabled(true);
+});
+
+AV_EVENT(CallState, {
+    auto msg = events.add_callstate();
+    msg->set_friendnumber(1);
+    msg->set_state(ap::CallState::SENDING_AV);
+});
+
+AV_EVENT(RequestAudioFrame, {
+    events.add_requestaudioframe()->set_friendnumber(1);
+});
+
+AV_EVENT(RequestVideoFrame, {
+    events.add_requestvideoframe()->set_friendnumber(1);
+});
+
+AV_EVENT(ReceiveAudioFrame, {
+    auto msg = events.add_receiveaudioframe();
+    msg->set_friendnumber(1);
+    for (int16_t sample : pcm) {
+        msg->add_pcm(sample);
+    }
+    msg->set_channels(2);
+    msg->set_samplingrate(48000);
+});
+
+AV_EVENT(ReceiveVideoFrame, {
+    auto msg = events.add_receivevideoframe();
+    msg->set_friendnumber(1);
+    msg->set_width(640);
+    msg->set_height(480);
+    msg->set_y(plane.data(), plane.size());
+    msg->set_u(plane.data(), plane.size() / 4);
+    msg->set_v(plane.data(), plane.size() / 4);
+});
+
+}
@@ -0,0 +1,121 @@
+#include "bench.h"
+
+#include "ToxCore/ToxCore.h"
+
+using CoreInstanceManager = instance_manager<tox_traits>;
+using CoreInstance = tox_instance<tox_traits>;
+
+
+/*
+ * Overhead of the instance bookkeeping around every native call. None of these touch the JVM on their success paths,
+ * so they run without one.
+ */
+
+namespace {
+
+// A subsystem that costs nothing to create or destroy, so that only instance_manager's own work is measured.
+struct null_subsystem { };
+
+struct null_deleter {
+    void operator()(null_subsystem *) { }
+};
+
+struct null_traits {
+    typedef null_subsystem subsystem;
+    typedef Events events;
+    typedef null_deleter deleter;
+};
+
+null_subsystem subsystem;
+
+
+// The Events object and the mutex are allocated as in toxNew.
+void add_kill_finalize(bench_state &state) {
+    typedef instance_manager<null_traits> manager;
+    typedef tox_instance<null_traits> instance;
+
+    while (state.running()) {
+        jint instance_number = manager::self.add(instance {
+            instance::pointer(&subsystem),
+            std::unique_ptr<Events>(new Events("core")),
+            std::unique_ptr<std::mutex>(new std::mutex)
+        });
+        manager::self.kill(state.env(), instance_number);
+        manager::self.finalize(state.env(), instance_number);
+    }
+}
+
+BENCHMARK("glue/instance-manager/add-kill-finalize", add_kill_finalize);
+
+
+// One real Tox instance, shared by all with_instance benchmarks and never killed. Creating it is too expensive to do
+// for every calibration run.
+jint shared_instance() {
+    static jint const instance_number = [] {
+        TOX_ERR_NEW error;
+        CoreInstance::pointer tox(tox_new(nullptr, nullptr, 0, &error));
+        if (!tox) {
+            return 0;
+        }
+
+        CoreInstance instance {
+            std::move(tox),
+            std::unique_ptr<Events>(new Events("core")),
+            std::unique_ptr<std::mutex>(new std::mutex)
+        };
+        return CoreInstanceManager::self.add(std::move(instance));
+    }();
+    return instance_number;
+}
+
+void with_instance_lookup(bench_state &state) {
+    jint const instance_number = shared_instance();
+    if (instance_number == 0) {
+        state.skip("tox_new failed");
+        return;
+    }
+
+    while (state.running()) {
+        int result = with_instance(state.env(), instance_number, [](Tox *tox, Events &events) {
+            unused(tox);
+            unused(events);
+            return 0;
+        });
+        keep(result);
+    }
+}
+
+// Stands in for a Tox API function, so that only with_error_handling is measured.
+uint32_t echo_query(Tox *tox, uint32_t value, TOX_ERR_FRIEND_QUERY *error) {
+    unused(tox);
+    *error = TOX_ERR_FRIEND_QUERY_OK;
+    return value;
+}
+
+void with_instance_error_handling(bench_state &state) {
+    jint const instance_number = shared_instance();
+    if (instance_number == 0) {
+        state.skip("tox_new failed");
+        return;
+    }
+
+    uint32_t value = 0;
+    while (state.running()) {
+        value = with_instance(state.env(), instance_number, "FriendGetPublicKey", [](TOX_ERR_FRIEND_QUERY error) {
+            switch (error) {
+                success_case(FRIEND_QUERY);
+                failure_case(FRIEND_QUERY, NULL);
+                failure_case(FRIEND_QUERY, FRIEND_NOT_FOUND);
+            }
+            return unhandled();
+        }, [](uint32_t result) {
+            return result + 1;
+        }, echo_query, value);
+    }
+    keep(value);
+}
+
+BENCHMARK("glue/with-instance/lookup", with_instance_lookup);
+BENCHMARK("glue/with-instance/error-handling", with_instance_error_handling);
+
+}
@@ -0,0 +1,109 @@
+#include "bench.h"
+
+#include "tox4j/Tox4j.h"
+#include "jniutil.h"
+
+#include <vector>
+
+
+/*
+ * Marshalling between native and Java arrays, and exception construction, in the embedded JVM. Each iteration
+ * deletes its local references so that the local reference table does not grow.
+ */
+
+namespace {
+
+bool need_jvm(bench_state &state) {
+    if (state.env() == nullptr) {
+        state.skip("no JVM");
+        return false;
+    }
+    return true;
+}
+
+
+void to_java_array(bench_state &state, size_t size) {
+    if (!need_jvm(state)) {
+        return;
+    }
+
+    JNIEnv *env = state.env();
+    std::vector<uint8_t> const data(size, 0x5a);
+    state.set_bytes(size);
+    while (state.running()) {
+        jbyteArray array = toJavaArray(env, data);
+        env->DeleteLocalRef(array);
+    }
+}
+
+void to_java_array_64(bench_state &state) { to_java_array(state, 64); }
+void to_java_array_4k(bench_state &state) { to_java_array(state, 4096); }
+void to_java_array_460k(bench_state &state) { to_java_array(state, 640 * 480 * 3 / 2); }
+
+BENCHMARK("jni/to-java-array/64", to_java_array_64);
+BENCHMARK("jni/to-java-array/4096", to_java_array_4k);
+BENCHMARK("jni/to-java-array/460800", to_java_array_460k);
+
+
+void byte_array(bench_state &state, size_t size) {
+    if (!need_jvm(state)) {
+        return;
+    }
+
+    JNIEnv *env = state.env();
+    jbyteArray array = env->NewByteArray(size);
+    state.set_bytes(size);
+    while (state.running()) {
+        ByteArray bytes(env, array);
+        keep(bytes.data()[0]);
+    }
+    env->DeleteLocalRef(array);
+}
+
+void byte_array_64(bench_state &state) { byte_array(state, 64); }
+void byte_array_460k(bench_state &state) { byte_array(state, 640 * 480 * 3 / 2); }
+
+BENCHMARK("jni/byte-array/64", byte_array_64);
+BENCHMARK("jni/byte-array/460800", byte_array_460k);
+
+
+void tox_exception(bench_state &state) {
+    if (!need_jvm(state)) {
+        return;
+    }
+
+    JNIEnv *env = state.env();
+    jclass exception_class = env->FindClass("im/tox/tox4j/core/exceptions/ToxFriendGetPublicKeyException");
+    if (exception_class == nullptr) {
+        env->ExceptionClear();
+        state.skip("tox4j classes are not on the class path");
+        return;
+    }
+    env->DeleteLocalRef(exception_class);
+
+    while (state.running()) {
+        env->PushLocalFrame(16);
+        throw_tox_exception(env, "core", "FriendGetPublicKey", "FRIEND_NOT_FOUND");
+        env->ExceptionClear();
+        env->PopLocalFrame(nullptr);
+    }
+}
+
+void illegal_state_exception(bench_state &state) {
+    if (!need_jvm(state)) {
+        return;
+    }
+
+    JNIEnv *env = state.env();
+    while (state.running()) {
+        env->PushLocalFrame(16);
+        throw_illegal_state_exception(env, 1, "Tox function invoked on killed tox instance");
+        env->ExceptionClear();
+        env->PopLocalFrame(nullptr);
+    }
+}
+
+BENCHMARK("jni/throw/tox-exception", tox_exception);
+BENCHMARK("jni/throw/illegal-state-exception", illegal_state_exception);
+
+}
@@ -0,0 +1,610 @@
+#include "tox/core.h"
+#include "tox4j/NativeStats.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <time.h>
+
+
+/*
+ * Usage: tox4j-loadgen [--nodes N] [--topology ring|star|mesh] [--duration S] [--drain S] [--connect-timeout S]
+ *                      [--messages RATE] [--message-size BYTES] [--files RATE] [--file-size BYTES]
+ *                      [--lossless RATE] [--lossy RATE] [--packet-size BYTES]
+ *
+ * Starts N Tox instances in this process, each driven by its own thread, bootstraps them to one another over
+ * 127.0.0.1 and makes them friends along the chosen topology. Once every friend connection is up, each node sends to
+ * each of its friends at the given rates (per second and friend; 0 disables a kind) for the given duration, then waits
+ * for in-flight traffic to drain.
+ *
+ * The traffic between the nodes goes over loopback, but the instances are not isolated from the network: toxcore has
+ * no option for the bind address, so every node listens on all interfaces, and it sends LAN discovery broadcasts.
+ * Run it on a host where that is acceptable.
+ *
+ * Every message, packet and file carries its send time, so the receiver measures delivery latency directly; for
+ * files it is the time until the last chunk arrived. Output is JSON lines, as for tox4j-bench: a context line, one
+ * line per traffic kind with throughput and latency percentiles, and one line per node with the CPU time of its
+ * thread. Toxcore runs no threads of its own, so that is the CPU cost of the instance.
+ *
+ * So far this tool has only been run against an in-process mock of the tox API, not against toxcore, so its numbers
+ * have not been validated on a real network stack.
+ */
+
+namespace {
+
+using std::chrono::steady_clock;
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+double thread_cpu_seconds() {
+    timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+
+enum traffic_kind {
+    MESSAGE,
+    FILE_DATA,
+    LOSSLESS,
+    LOSSY,
+    TRAFFIC_KINDS
+};
+
+char const *const traffic_names[TRAFFIC_KINDS] = { "message", "file", "lossless", "lossy" };
+
+struct options {
+    size_t nodes = 4;
+    std::string topology = "ring";
+    double duration = 10;
+    double drain = 2;
+    double connect_timeout = 60;
+    // Sends per second and friend, by traffic kind.
+    double rate[TRAFFIC_KINDS] = { 10, 0, 0, 0 };
+    size_t message_size = 128;
+    size_t file_size = 1 << 20;
+    size_t packet_size = 512;
+};
+
+// First byte of custom packets; toxcore reserves these ranges for them.
+uint8_t const lossless_packet_id = 160;
+uint8_t const lossy_packet_id = 200;
+
+enum run_phase {
+    CONNECTING,
+    RUNNING,
+    DRAINING,
+    STOPPED
+};
+
+std::atomic<int> phase(CONNECTING);
+// Traffic sent before this time (warm-up stragglers) is not counted.
+std::atomic<int64_t> run_start(0);
+
+
+struct traffic_stats {
+    uint64_t sent = 0;
+    uint64_t send_failed = 0;
+    uint64_t received = 0;
+    uint64_t bytes = 0;
+    std::vector<uint64_t> latency = std::vector<uint64_t>(native_latency_buckets);
+
+    void record(int64_t sent_at, size_t length) {
+        if (sent_at < run_start.load(std::memory_order_relaxed)) {
+            return;
+        }
+        received++;
+        bytes += length;
+        latency[native_latency_bucket(std::max<int64_t>(now_ns() - sent_at, 0))]++;
+    }
+
+    void merge(traffic_stats const &other) {
+        sent += other.sent;
+        send_failed += other.send_failed;
+        received += other.received;
+        bytes += other.bytes;
+        for (size_t i = 0; i < native_latency_buckets; i++) {
+            latency[i] += other.latency[i];
+        }
+    }
+
+    // Upper bound of the bucket holding the given percentile, in microseconds.
+    double percentile(double p) const {
+        uint64_t const rank = std::max<uint64_t>(1, received * p / 100);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < native_latency_buckets; i++) {
+            seen += latency[i];
+            if (seen >= rank) {
+                return native_latency_bucket_limit(i) / 1e3;
+            }
+        }
+        return 0;
+    }
+};
+
+
+struct node {
+    size_t index;
+    Tox *tox = nullptr;
+    options const *opts;
+
+    // Friend numbers of this node's peers and whether each connection is up.
+    std::vector<uint32_t> friends;
+    std::vector<bool> friend_online;
+    std::atomic<size_t> online { 0 };
+
+    // Next send time per friend and traffic kind.
+    std::vector<std::array<int64_t, TRAFFIC_KINDS>> next_send;
+    // Send times of incoming files, by (friend, file) number.
+    std::map<std::pair<uint32_t, uint32_t>, int64_t> incoming_files;
+    std::vector<uint8_t> buffer;
+
+    traffic_stats stats[TRAFFIC_KINDS];
+    uint64_t iterations = 0;
+    double cpu_seconds = 0;
+
+    std::thread thread;
+};
+
+
+// Timestamps are sent as 16 hex digits in messages and file names, which must be text, and as 8 raw bytes in
+// packets.
+void put_hex_time(uint8_t *out, int64_t time) {
+    static char const digits[] = "0123456789abcdef";
+    for (int i = 15; i >= 0; i--) {
+        out[i] = digits[time & 0xf];
+        time >>= 4;
+    }
+}
+
+int64_t get_hex_time(uint8_t const *in, size_t length) {
+    int64_t time = 0;
+    for (size_t i = 0; i < 16 && i < length; i++) {
+        char const c = in[i];
+        time = time << 4 | (c <= '9' ? c - '0' : c - 'a' + 10);
+    }
+    return time;
+}
+
+void put_raw_time(uint8_t *out, int64_t time) {
+    memcpy(out, &time, sizeof time);
+}
+
+int64_t get_raw_time(uint8_t const *in) {
+    int64_t time;
+    memcpy(&time, in, sizeof time);
+    return time;
+}
+
+
+// Every callback is called unconditionally, so each one needs a function, even if the load generator ignores the
+// event.
+template<typename... Args>
+void ignore(Args...) { }
+
+void on_friend_connection_status(Tox *, uint32_t friend_number, TOX_CONNECTION status, void *user_data) {
+    node &self = *static_cast<node *>(user_data);
+    if (friend_number >= self.friend_online.size()) {
+        return;
+    }
+    bool const online = status != TOX_CONNECTION_NONE;
+    if (online != self.friend_online[friend_number]) {
+        self.friend_online[friend_number] = online;
+        if (online) {
+            self.online++;
+        } else {
+            self.online--;
+        }
+    }
+}
+
+void on_friend_message(Tox *, uint32_t, uint8_t const *message, size_t length, void *user_data) {
+    node &self = *static_cast<node *>(user_data);
+    self.stats[MESSAGE].record(get_hex_time(message, length), length);
+}
+
+void on_lossless_packet(Tox *, uint32_t, uint8_t const *data, size_t length, void *user_data) {
+    node &self = *static_cast<node *>(user_data);
+    if (length >= 1 + sizeof(int64_t)) {
+        self.stats[LOSSLESS].record(get_raw_time(data + 1), length);
+    }
+}
+
+void on_lossy_packet(Tox *, uint32_t, uint8_t const *data, size_t length, void *user_data) {
+    node &self = *static_cast<node *>(user_data);
+    if (length >= 1 + sizeof(int64_t)) {
+        self.stats[LOSSY].record(get_raw_time(data + 1), length);
+    }
+}
+
+void on_file_receive(Tox *tox, uint32_t friend_number, uint32_t file_number, TOX_FILE_KIND, uint64_t,
+                     uint8_t const *filename, size_t filename_length, void *user_data) {
+    node &self = *static_cast<node *>(user_data);
+    self.incoming_files[std::make_pair(friend_number, file_number)] = get_hex_time(filename, filename_length);
+    tox_file_control(tox, friend_number, file_number, TOX_FILE_CONTROL_RESUME, nullptr);
+}
+
+void on_file_receive_chunk(Tox *, uint32_t friend_number, uint32_t file_number, uint64_t, uint8_t const *,
+                           size_t length, void *user_data) {
+    node &self = *static_cast<node *>(user_data);
+    auto found = self.incoming_files.find(std::make_pair(friend_number, file_number));
+    if (found == self.incoming_files.end()) {
+        return;
+    }
+
+    if (length != 0) {
+        if (found->second >= run_start.load(std::memory_order_relaxed)) {
+            self.stats[FILE_DATA].bytes += length;
+        }
+    } else {
+        // Completion: count the file and its latency, but not its bytes again.
+        self.stats[FILE_DATA].record(found->second, 0);
+        self.incoming_files.erase(found);
+    }
+}
+
+void on_file_request_chunk(Tox *tox, uint32_t friend_number, uint32_t file_number, uint64_t position, size_t length,
+                           void *user_data) {
+    node &self = *static_cast<node *>(user_data);
+    if (length == 0) {
+        return;
+    }
+    if (self.buffer.size() < length) {
+        self.buffer.resize(length, 'x');
+    }
+    tox_file_send_chunk(tox, friend_number, file_number, position, self.buffer.data(), length, nullptr);
+}
+
+
+bool send_one(node &self, uint32_t friend_number, traffic_kind kind) {
+    options const &opts = *self.opts;
+    int64_t const now = now_ns();
+
+    switch (kind) {
+        case MESSAGE: {
+            std::vector<uint8_t> message(opts.message_size, 'x');
+            put_hex_time(message.data(), now);
+            TOX_ERR_SEND_MESSAGE error;
+            tox_send_message(self.tox, friend_number, message.data(), message.size(), &error);
+            return error == TOX_ERR_SEND_MESSAGE_OK;
+        }
+        case FILE_DATA: {
+            uint8_t filename[16];
+            put_hex_time(filename, now);
+            TOX_ERR_FILE_SEND error;
+            tox_file_send(self.tox, friend_number, TOX_FILE_KIND_DATA, opts.file_size, filename, sizeof filename, &error);
+            return error == TOX_ERR_FILE_SEND_OK;
+        }
+        case LOSSLESS:
+        case LOSSY: {
+            std::vector<uint8_t> packet(opts.packet_size, 'x');
+            packet[0] = kind == LOSSLESS ? lossless_packet_id : lossy_packet_id;
+            put_raw_time(packet.data() + 1, now);
+            TOX_ERR_SEND_CUSTOM_PACKET error;
+            if (kind == LOSSLESS) {
+                tox_send_lossless_packet(self.tox, friend_number, packet.data(), packet.size(), &error);
+            } else {
+                tox_send_lossy_packet(self.tox, friend_number, packet.data(), packet.size(), &error);
+            }
+            return error == TOX_ERR_SEND_CUSTOM_PACKET_OK;
+        }
+        case TRAFFIC_KINDS:
+            break;
+    }
+    return false;
+}
+
+// Sends everything that is due and returns the time of the next send. A node that falls behind sends at most a few
+// messages per friend and iteration, so that it keeps iterating; the missed sends are not made up.
+int64_t send_due(node &self, int64_t now) {
+    options const &opts = *self.opts;
+    int64_t next = INT64_MAX;
+
+    for (size_t i = 0; i < self.friends.size(); i++) {
+        for (size_t kind = 0; kind < TRAFFIC_KINDS; kind++) {
+            if (opts.rate[kind] <= 0) {
+                continue;
+            }
+            int64_t const period = 1e9 / opts.rate[kind];
+            int64_t &due = self.next_send[i][kind];
+            if (due == 0) {
+                // Spread the first sends over one period so that the nodes do not send in lock-step.
+                due = now + period * (self.index + i) / (self.opts->nodes + self.friends.size());
+            }
+
+            for (int burst = 0; due <= now && burst < 8; burst++) {
+                if (send_one(self, self.friends[i], static_cast<traffic_kind>(kind))) {
+                    self.stats[kind].sent++;
+                } else {
+                    self.stats[kind].send_failed++;
+                }
+                due += period;
+            }
+            if (due <= now) {
+                due = now + period;
+            }
+            next = std::min(next, due);
+        }
+    }
+    return next;
+}
+
+void run_node(node &self) {
+    double cpu_start = 0;
+    bool measuring = false;
+
+    while (phase.load() != STOPPED) {
+        tox_iteration(self.tox);
+        self.iterations++;
+
+        int64_t const now = now_ns();
+        int64_t wake = now + tox_iteration_interval(self.tox) * int64_t(1000000);
+
+        int const current = phase.load();
+        if (current == RUNNING) {
+            if (!measuring) {
+                cpu_start = thread_cpu_seconds();
+                measuring = true;
+            }
+            wake = std::min(wake, send_due(self, now));
+        } else if (current == DRAINING && measuring) {
+            self.cpu_seconds = thread_cpu_seconds() - cpu_start;
+            measuring = false;
+        }
+
+        if (wake > now) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(wake - now));
+        }
+    }
+
+    if (measuring) {
+        self.cpu_seconds = thread_cpu_seconds() - cpu_start;
+    }
+}
+
+
+void usage(char const *program) {
+    fprintf(stderr,
+            "Usage: %s [--nodes N] [--topology ring|star|mesh] [--duration S] [--drain S] [--connect-timeout S]\n"
+            "       [--messages RATE] [--message-size BYTES] [--files RATE] [--file-size BYTES]\n"
+            "       [--lossless RATE] [--lossy RATE] [--packet-size BYTES]\n",
+            program);
+}
+
+bool parse_options(int argc, char **argv, options &opts) {
+    for (int i = 1; i < argc; i += 2) {
+        std::string const arg = argv[i];
+        if (i + 1 == argc) {
+            usage(argv[0]);
+            return false;
+        }
+
+        char const *value = argv[i + 1];
+        if (arg == "--nodes") {
+            opts.nodes = std::max(2, atoi(value));
+        } else if (arg == "--topology") {
+            opts.topology = value;
+        } else if (arg == "--duration") {
+            opts.duration = atof(value);
+        } else if (arg == "--drain") {
+            opts.drain = atof(value);
+        } else if (arg == "--connect-timeout") {
+            opts.connect_timeout = atof(value);
+        } else if (arg == "--messages") {
+            opts.rate[MESSAGE] = atof(value);
+        } else if (arg == "--message-size") {
+            opts.message_size = atoi(value);
+        } else if (arg == "--files") {
+            opts.rate[FILE_DATA] = atof(value);
+        } else if (arg == "--file-size") {
+            opts.file_size = atoll(value);
+        } else if (arg == "--lossless") {
+            opts.rate[LOSSLESS] = atof(value);
+        } else if (arg == "--lossy") {
+            opts.rate[LOSSY] = atof(value);
+        } else if (arg == "--packet-size") {
+            opts.packet_size = atoi(value);
+        } else {
+            usage(argv[0]);
+            return false;
+        }
+    }
+
+    if (opts.topology != "ring" && opts.topology != "star" && opts.topology != "mesh") {
+        usage(argv[0]);
+        return false;
+    }
+
+    // Room for the timestamps, within toxcore's limits.
+    opts.message_size = std::max<size_t>(16, std::min<size_t>(opts.message_size, TOX_MAX_MESSAGE_LENGTH));
+    opts.packet_size = std::max<size_t>(1 + sizeof(int64_t), std::min<size_t>(opts.packet_size, TOX_MAX_CUSTOM_PACKET_SIZE));
+    opts.duration = std::max(opts.duration, 0.1);
+    return true;
+}
+
+std::vector<std::pair<size_t, size_t>> make_links(options const &opts) {
+    std::vector<std::pair<size_t, size_t>> links;
+    for (size_t a = 0; a < opts.nodes; a++) {
+        for (size_t b = a + 1; b < opts.nodes; b++) {
+            bool const linked =
+                opts.topology == "mesh" ||
+                (opts.topology == "star" && a == 0) ||
+                (opts.topology == "ring" && (b == a + 1 || (a == 0 && b == opts.nodes - 1 && opts.nodes > 2)));
+            if (linked) {
+                links.push_back(std::make_pair(a, b));
+            }
+        }
+    }
+    return links;
+}
+
+bool start_node(node &self) {
+    Tox_Options tox_options;
+    tox_options_default(&tox_options);
+    tox_options.ipv6_enabled = false;
+
+    TOX_ERR_NEW error;
+    self.tox = tox_new(&tox_options, nullptr, 0, &error);
+    if (self.tox == nullptr) {
+        fprintf(stderr, "tox_new failed for node %zu with error %d\n", self.index, error);
+        return false;
+    }
+
+    tox_callback_connection_status(self.tox, ignore, nullptr);
+    tox_callback_friend_name(self.tox, ignore, nullptr);
+    tox_callback_friend_status_message(self.tox, ignore, nullptr);
+    tox_callback_friend_status(self.tox, ignore, nullptr);
+    tox_callback_friend_connection_status(self.tox, on_friend_connection_status, &self);
+    tox_callback_friend_typing(self.tox, ignore, nullptr);
+    tox_callback_read_receipt(self.tox, ignore, nullptr);
+    tox_callback_friend_request(self.tox, ignore, nullptr);
+    tox_callback_friend_message(self.tox, on_friend_message, &self);
+    tox_callback_friend_action(self.tox, ignore, nullptr);
+    tox_callback_file_control(self.tox, ignore, nullptr);
+    tox_callback_file_request_chunk(self.tox, on_file_request_chunk, &self);
+    tox_callback_file_receive(self.tox, on_file_receive, &self);
+    tox_callback_file_receive_chunk(self.tox, on_file_receive_chunk, &self);
+    tox_callback_file_progress(self.tox, ignore, nullptr);
+    tox_callback_friend_lossy_packet(self.tox, on_lossy_packet, &self);
+    tox_callback_friend_lossless_packet(self.tox, on_lossless_packet, &self);
+    return true;
+}
+
+void bootstrap(node &self, node const &peer) {
+    uint8_t dht_id[TOX_PUBLIC_KEY_SIZE];
+    tox_get_dht_id(peer.tox, dht_id);
+    uint16_t const port = tox_get_udp_port(peer.tox, nullptr);
+    tox_bootstrap(self.tox, "127.0.0.1", port, dht_id, nullptr);
+}
+
+uint32_t add_friend(node &self, node const &peer) {
+    uint8_t public_key[TOX_PUBLIC_KEY_SIZE];
+    tox_self_get_public_key(peer.tox, public_key);
+    uint32_t const friend_number = tox_friend_add_norequest(self.tox, public_key, nullptr);
+    self.friends.push_back(friend_number);
+    if (self.friend_online.size() <= friend_number) {
+        self.friend_online.resize(friend_number + 1);
+    }
+    return friend_number;
+}
+
+void print_results(options const &opts, std::vector<std::unique_ptr<node>> const &nodes, double connect_seconds) {
+    printf("{\"context\":{\"nodes\":%zu,\"topology\":\"%s\",\"links\":%zu,\"duration\":%.1f,\"connect_seconds\":%.2f}}\n",
+           opts.nodes, opts.topology.c_str(), make_links(opts).size(), opts.duration, connect_seconds);
+
+    size_t const sizes[TRAFFIC_KINDS] = { opts.message_size, opts.file_size, opts.packet_size, opts.packet_size };
+    for (size_t kind = 0; kind < TRAFFIC_KINDS; kind++) {
+        if (opts.rate[kind] <= 0) {
+            continue;
+        }
+        traffic_stats total;
+        for (auto const &instance : nodes) {
+            total.merge(instance->stats[kind]);
+        }
+        printf("{\"traffic\":\"%s\",\"rate\":%.1f,\"size\":%zu,\"sent\":%llu,\"send_failed\":%llu,\"received\":%llu,"
+               "\"per_second\":%.1f,\"mb_per_s\":%.3f,\"latency_p50_us\":%.1f,\"latency_p99_us\":%.1f}\n",
+               traffic_names[kind], opts.rate[kind], sizes[kind],
+               (unsigned long long) total.sent, (unsigned long long) total.send_failed,
+               (unsigned long long) total.received,
+               total.received / opts.duration, total.bytes / opts.duration / 1e6,
+               total.percentile(50), total.percentile(99));
+    }
+
+    for (auto const &instance : nodes) {
+        printf("{\"node\":%zu,\"friends\":%zu,\"iterations\":%llu,\"cpu_ms\":%.1f,\"cpu_percent\":%.1f}\n",
+               instance->index, instance->friends.size(), (unsigned long long) instance->iterations,
+               instance->cpu_seconds * 1e3, instance->cpu_seconds / opts.duration * 100);
+    }
+    fflush(stdout);
+}
+
+}
+
+
+int main(int argc, char **argv) {
+    options opts;
+    if (!parse_options(argc, argv, opts)) {
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::unique_ptr<node>> nodes;
+    for (size_t i = 0; i < opts.nodes; i++) {
+        nodes.emplace_back(new node);
+        nodes.back()->index = i;
+        nodes.back()->opts = &opts;
+        if (!start_node(*nodes.back())) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Every node knows its successor and node 0, so the DHT is connected whatever the topology.
+    for (size_t i = 0; i < opts.nodes; i++) {
+        bootstrap(*nodes[i], *nodes[(i + 1) % opts.nodes]);
+        if (i != 0) {
+            bootstrap(*nodes[i], *nodes[0]);
+        }
+    }
+
+    size_t connections = 0;
+    for (auto const &link : make_links(opts)) {
+        add_friend(*nodes[link.first], *nodes[link.second]);
+        add_friend(*nodes[link.second], *nodes[link.first]);
+        connections += 2;
+    }
+    for (auto const &instance : nodes) {
+        instance->next_send.resize(instance->friends.size());
+    }
+
+    for (auto const &instance : nodes) {
+        node *self = instance.get();
+        self->thread = std::thread([self] { run_node(*self); });
+    }
+
+    steady_clock::time_point const connect_start = steady_clock::now();
+    steady_clock::time_point const connect_deadline = connect_start + std::chrono::milliseconds(int64_t(opts.connect_timeout * 1e3));
+    size_t online = 0;
+    while (online < connections && steady_clock::now() < connect_deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        online = 0;
+        for (auto const &instance : nodes) {
+            online += instance->online.load();
+        }
+    }
+    double const connect_seconds = std::chrono::duration<double>(steady_clock::now() - connect_start).count();
+
+    bool const connected = online == connections;
+    if (connected) {
+        run_start = now_ns();
+        phase = RUNNING;
+        std::this_thread::sleep_for(std::chrono::milliseconds(int64_t(opts.duration * 1e3)));
+        phase = DRAINING;
+        std::this_thread::sleep_for(std::chrono::milliseconds(int64_t(opts.drain * 1e3)));
+    } else {
+        fprintf(stderr, "Only %zu of %zu friend connections came up within %.0f seconds\n",
+                online, connections, opts.connect_timeout);
+    }
+    phase = STOPPED;
+
+    for (auto const &instance : nodes) {
+        instance->thread.join();
+        tox_kill(instance->tox);
+    }
+
+    if (!connected) {
+        return EXIT_FAILURE;
+    }
+    print_results(opts, nodes, connect_seconds);
+    return EXIT_SUCCESS;
+}
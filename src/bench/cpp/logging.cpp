@@ -0,0 +1,53 @@
+#include "bench.h"
+
+#include "tox/logging.h"
+
+#include <array>
+
+
+/*
+ * Cost of a log statement. The enabled case writes to /dev/null and drains the ring from the logging thread every 128
+ * records, so that no record is dropped; it therefore includes the amortised formatting cost.
+ */
+
+namespace {
+
+std::array<uint8_t, 32> const key = { { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 } };
+
+void log_disabled(bench_state &state) {
+    log_set_level(LOG_OFF);
+    uint32_t friend_number = 0;
+    while (state.running()) {
+        LOG(TRACE, "friend {} key {}", friend_number++, log_hex(key));
+    }
+}
+
+void log_enabled(bench_state &state) {
+    log_set_file("/dev/null");
+    log_set_level(LOG_TRACE);
+    uint32_t friend_number = 0;
+    while (state.running()) {
+        LOG(TRACE, "friend {} key {}", friend_number, log_hex(key));
+        if (++friend_number % 128 == 0) {
+            log_flush();
+        }
+    }
+    log_set_level(LOG_OFF);
+    log_flush();
+    log_set_file(nullptr);
+}
+
+void hex_key(bench_state &state) {
+    char out[2 * 32];
+    state.set_bytes(key.size());
+    while (state.running()) {
+        hex_encode(key.data(), key.size(), out);
+        keep(out);
+    }
+}
+
+BENCHMARK("logging/disabled", log_disabled);
+BENCHMARK("logging/enabled", log_enabled);
+BENCHMARK("logging/hex-key", hex_key);
+
+}
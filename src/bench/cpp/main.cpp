@@ -0,0 +1,211 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+/*
+ * Usage: tox4j-bench [--min-time MS] [--repetitions N] [--classpath PATH] [--no-jvm] [FILTER...]
+ *
+ * Runs every benchmark whose name contains one of the filters (all if none are given). Output is one JSON object per
+ * line: first a context line describing the build, then one line per benchmark with nanoseconds and allocations per
+ * iteration over the repetitions. Benchmarks of the JNI marshalling run in an embedded JVM; the tox4j classes must be
+ * on its class path (--classpath or TOX4J_CLASSPATH) for the exception benchmarks.
+ *
+ * The exit status is non-zero if a benchmark that must not allocate did.
+ */
+
+// Optimisation mode of the build, set by CMake.
+#ifndef TOX4J_OPTIMIZE
+#define TOX4J_OPTIMIZE "none"
+#endif
+
+
+namespace {
+
+struct registered_benchmark {
+    char const *name;
+    bench_function function;
+};
+
+std::vector<registered_benchmark> &registry() {
+    static std::vector<registered_benchmark> benchmarks;
+    return benchmarks;
+}
+
+struct options {
+    double min_time = 0.1;
+    size_t repetitions = 5;
+    std::string classpath;
+    bool jvm = true;
+    std::vector<std::string> filters;
+};
+
+double seconds(bench_state::clock::duration duration) {
+    return std::chrono::duration<double>(duration).count();
+}
+
+bench_state run_once(registered_benchmark const &benchmark, JNIEnv *env, size_t iterations) {
+    bench_state state(env, iterations);
+    benchmark.function(state);
+    return state;
+}
+
+void print_skipped(char const *name, std::string const &reason) {
+    printf("{\"benchmark\":\"%s\",\"skipped\":\"%s\"}\n", name, reason.c_str());
+}
+
+// Returns false if the benchmark allocated although it must not.
+bool run(registered_benchmark const &benchmark, JNIEnv *env, options const &opts) {
+    // Grow the iteration count until one run takes a tenth of the target time, then extrapolate.
+    size_t iterations = 1;
+    double elapsed = 0;
+    while (true) {
+        bench_state state = run_once(benchmark, env, iterations);
+        if (!state.skipped().empty()) {
+            print_skipped(benchmark.name, state.skipped());
+            return true;
+        }
+        elapsed = seconds(state.elapsed());
+        if (elapsed >= opts.min_time / 10 || iterations >= 1000000000) {
+            break;
+        }
+        iterations *= 10;
+    }
+    iterations = std::max<size_t>(1, iterations * opts.min_time / std::max(elapsed, 1e-9));
+
+    std::vector<double> samples;
+    size_t bytes = 0;
+    size_t allocations = 0;
+    bool no_allocations = false;
+    for (size_t i = 0; i < opts.repetitions; i++) {
+        bench_state state = run_once(benchmark, env, iterations);
+        samples.push_back(seconds(state.elapsed()) * 1e9 / iterations);
+        bytes = state.bytes();
+        allocations += state.allocations();
+        no_allocations = state.expects_no_allocations();
+    }
+    std::sort(samples.begin(), samples.end());
+
+    double const median = samples[samples.size() / 2];
+    printf("{\"benchmark\":\"%s\",\"iterations\":%zu,\"repetitions\":%zu,"
+           "\"ns_min\":%.2f,\"ns_median\":%.2f,\"ns_max\":%.2f",
+           benchmark.name, iterations, samples.size(), samples.front(), median, samples.back());
+    if (bytes != 0) {
+        printf(",\"bytes\":%zu,\"mb_per_s\":%.1f", bytes, bytes / median * 1e3);
+    }
+    printf(",\"allocs_per_iter\":%.3f", double(allocations) / (iterations * samples.size()));
+    printf("}\n");
+    fflush(stdout);
+
+    if (no_allocations && allocations != 0) {
+        fprintf(stderr, "%s: %zu allocations in %zu iterations, expected none\n",
+                benchmark.name, allocations, iterations * samples.size());
+        return false;
+    }
+    return true;
+}
+
+bool selected(char const *name, std::vector<std::string> const &filters) {
+    return filters.empty() || std::any_of(filters.begin(), filters.end(), [=](std::string const &filter) {
+        return strstr(name, filter.c_str()) != nullptr;
+    });
+}
+
+JNIEnv *create_jvm(options const &opts) {
+#ifdef HAVE_JVM
+    std::string classpath = "-Djava.class.path=" + opts.classpath;
+    JavaVMOption vm_options[1];
+    vm_options[0].optionString = const_cast<char *>(classpath.c_str());
+    vm_options[0].extraInfo = nullptr;
+
+    JavaVMInitArgs args;
+    args.version = JNI_VERSION_1_6;
+    args.nOptions = 1;
+    args.options = vm_options;
+    args.ignoreUnrecognized = JNI_FALSE;
+
+    JavaVM *vm;
+    JNIEnv *env;
+    if (JNI_CreateJavaVM(&vm, reinterpret_cast<void **>(&env), &args) != JNI_OK) {
+        fprintf(stderr, "Could not create a JVM; JNI benchmarks are skipped\n");
+        return nullptr;
+    }
+    return env;
+#else
+    (void) opts;
+    return nullptr;
+#endif
+}
+
+bool parse_options(int argc, char **argv, options &opts) {
+    if (char const *classpath = getenv("TOX4J_CLASSPATH")) {
+        opts.classpath = classpath;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        std::string const arg = argv[i];
+        bool const has_value = i + 1 < argc;
+        if (arg == "--min-time" && has_value) {
+            opts.min_time = atof(argv[++i]) / 1000;
+        } else if (arg == "--repetitions" && has_value) {
+            opts.repetitions = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--classpath" && has_value) {
+            opts.classpath = argv[++i];
+        } else if (arg == "--no-jvm") {
+            opts.jvm = false;
+        } else if (arg.compare(0, 2, "--") == 0) {
+            fprintf(stderr, "Usage: %s [--min-time MS] [--repetitions N] [--classpath PATH] [--no-jvm] [FILTER...]\n",
+                    argv[0]);
+            return false;
+        } else {
+            opts.filters.push_back(arg);
+        }
+    }
+    return true;
+}
+
+}
+
+
+bench_registration::bench_registration(char const *name, bench_function function) {
+    registry().push_back(registered_benchmark { name, function });
+}
+
+
+int main(int argc, char **argv) {
+    options opts;
+    if (!parse_options(argc, argv, opts)) {
+        return EXIT_FAILURE;
+    }
+
+    JNIEnv *env = opts.jvm ? create_jvm(opts) : nullptr;
+
+    std::vector<registered_benchmark> benchmarks = registry();
+    std::sort(benchmarks.begin(), benchmarks.end(), [](registered_benchmark const &a, registered_benchmark const &b) {
+        return strcmp(a.name, b.name) < 0;
+    });
+
+    printf("{\"context\":{\"compiler\":\"%s\",\"optimize\":\"%s\",\"sse2\":%s,\"jvm\":%s}}\n",
+           __VERSION__,
+           TOX4J_OPTIMIZE,
+#ifdef __SSE2__
+           "true",
+#else
+           "false",
+#endif
+           env != nullptr ? "true" : "false");
+
+    bool success = true;
+    for (registered_benchmark const &benchmark : benchmarks) {
+        if (selected(benchmark.name, opts.filters)) {
+            success &= run(benchmark, env, opts);
+        }
+    }
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,170 @@
+#include "bench.h"
+
+#include "tox/call_stats.h"
+#include "tox/colorspace.h"
+#include "tox/resampler.h"
+#include "tox/scaler.h"
+#include "tox/scheduler.h"
+
+#include <cstdint>
+#include <vector>
+
+
+/*
+ * The per-frame kernels of the AV shim, at the frame sizes of a typical call.
+ */
+
+namespace {
+
+std::vector<uint8_t> noise(size_t size) {
+    std::vector<uint8_t> data(size);
+    uint32_t state = 12345;
+    for (uint8_t &byte : data) {
+        state = state * 1103515245 + 12345;
+        byte = state >> 16;
+    }
+    return data;
+}
+
+std::vector<int16_t> tone(size_t samples) {
+    std::vector<int16_t> pcm(samples);
+    for (size_t i = 0; i < samples; i++) {
+        pcm[i] = (i * 440 % 48000) * 2 - 24000;
+    }
+    return pcm;
+}
+
+
+// 20 ms of audio per iteration.
+void resample(bench_state &state, uint32_t in_rate, uint8_t in_channels, uint32_t out_rate, uint8_t out_channels) {
+    size_t const samples = in_rate / 50;
+    std::vector<int16_t> const pcm = tone(samples * in_channels);
+    std::vector<int16_t> out;
+
+    audio_resampler resampler;
+    resampler.configure(in_rate, in_channels, out_rate, out_channels);
+    // The first frame sizes the output buffer; after that, resampling must not allocate.
+    resampler.process(pcm.data(), samples, out);
+    state.expect_no_allocations();
+    state.set_bytes(pcm.size() * sizeof(int16_t));
+    while (state.running()) {
+        out.clear();
+        resampler.process(pcm.data(), samples, out);
+        keep(out.data());
+    }
+}
+
+void resample_44100_stereo_to_48000_mono(bench_state &state) { resample(state, 44100, 2, 48000, 1); }
+void resample_48000_stereo_to_24000_stereo(bench_state &state) { resample(state, 48000, 2, 24000, 2); }
+void resample_16000_mono_to_48000_stereo(bench_state &state) { resample(state, 16000, 1, 48000, 2); }
+
+BENCHMARK("media/resample/44100s-48000m", resample_44100_stereo_to_48000_mono);
+BENCHMARK("media/resample/48000s-24000s", resample_48000_stereo_to_24000_stereo);
+BENCHMARK("media/resample/16000m-48000s", resample_16000_mono_to_48000_stereo);
+
+
+uint16_t const width = 1280;
+uint16_t const height = 720;
+size_t const luma = size_t(width) * height;
+size_t const chroma = luma / 4;
+
+template<void (*Convert)(uint8_t const *, uint16_t, uint16_t, uint8_t *, uint8_t *, uint8_t *)>
+void convert(bench_state &state, size_t bytes_per_pixel_x2) {
+    std::vector<uint8_t> const src = noise(luma * bytes_per_pixel_x2 / 2);
+    std::vector<uint8_t> dst(luma + 2 * chroma);
+
+    state.set_bytes(src.size());
+    while (state.running()) {
+        Convert(src.data(), width, height, dst.data(), dst.data() + luma, dst.data() + luma + chroma);
+        keep(dst.data());
+    }
+}
+
+void convert_nv12(bench_state &state) { convert<nv12_to_i420>(state, 3); }
+void convert_rgba(bench_state &state) { convert<rgba_to_i420>(state, 8); }
+
+void convert_i444(bench_state &state) {
+    std::vector<uint8_t> const src = noise(luma * 3);
+    std::vector<uint8_t> dst(luma + 2 * chroma);
+
+    state.set_bytes(src.size());
+    while (state.running()) {
+        i444_to_i420(src.data(), src.data() + luma, src.data() + 2 * luma, width, height,
+                     dst.data(), dst.data() + luma, dst.data() + luma + chroma);
+        keep(dst.data());
+    }
+}
+
+void copy_padded_plane(bench_state &state) {
+    int const stride = width + 64;
+    std::vector<uint8_t> const src = noise(size_t(stride) * height);
+    std::vector<uint8_t> dst(luma);
+
+    state.set_bytes(luma);
+    while (state.running()) {
+        copy_plane(src.data(), stride, width, height, dst.data());
+        keep(dst.data());
+    }
+}
+
+BENCHMARK("media/colorspace/nv12-720p", convert_nv12);
+BENCHMARK("media/colorspace/rgba-720p", convert_rgba);
+BENCHMARK("media/colorspace/i444-720p", convert_i444);
+BENCHMARK("media/colorspace/copy-plane-720p", copy_padded_plane);
+
+
+void scale(bench_state &state, uint16_t out_width, uint16_t out_height) {
+    std::vector<uint8_t> const src = noise(luma + 2 * chroma);
+    std::vector<uint8_t> dst(size_t(out_width) * out_height * 3 / 2);
+
+    video_scaler scaler;
+    state.set_bytes(src.size());
+    while (state.running()) {
+        scaler.scale_i420(src.data(), width, height, dst.data(), out_width, out_height);
+        keep(dst.data());
+    }
+}
+
+void scale_halve(bench_state &state) { scale(state, 640, 360); }
+void scale_bilinear(bench_state &state) { scale(state, 854, 480); }
+
+BENCHMARK("media/scale/720p-360p", scale_halve);
+BENCHMARK("media/scale/720p-480p", scale_bilinear);
+
+
+void call_stats_frame(bench_state &state) {
+    stream_stats stats;
+    stream_stats::clock::time_point now = stream_stats::clock::now();
+    while (state.running()) {
+        now += std::chrono::milliseconds(20);
+        stats.on_request(now);
+        stats.on_sent(now + std::chrono::microseconds(300), 160, std::chrono::microseconds(250));
+        stats.on_received(now + std::chrono::microseconds(500));
+    }
+    keep(stats);
+}
+
+BENCHMARK("media/call-stats/frame", call_stats_frame);
+
+
+// One due request popped and rescheduled among 64 streams.
+void scheduler_request(bench_state &state) {
+    frame_scheduler scheduler;
+    frame_scheduler::clock::time_point now = frame_scheduler::clock::now();
+    for (uint32_t i = 0; i < 64; i++) {
+        scheduler.schedule({ now + std::chrono::microseconds(i * 300), i, 0, frame_scheduler::audio_stream });
+    }
+
+    frame_scheduler::entry request;
+    while (state.running()) {
+        now = scheduler.next_due();
+        scheduler.pop_due(now, request);
+        request.due += std::chrono::milliseconds(20);
+        scheduler.schedule(request);
+    }
+    keep(request);
+}
+
+BENCHMARK("media/scheduler/request", scheduler_request);
+
+}
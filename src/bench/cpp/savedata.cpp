@@ -0,0 +1,94 @@
+#include "bench.h"
+
+#include "ToxCore/ToxCore.h"
+
+#include <cstdint>
+#include <vector>
+
+
+/*
+ * Saving and loading a profile with many friends, plain and in the LZ4 container. The throughput is that of the
+ * output for saves and of the input for loads, so the two formats' rates also give their sizes.
+ */
+
+namespace {
+
+size_t const friends = 20000;
+
+
+Tox *new_offline_tox(uint8_t const *data, size_t length) {
+    struct Tox_Options options;
+    tox_options_default(&options);
+    options.udp_enabled = false;
+    return tox_new(&options, data, length, nullptr);
+}
+
+// One instance with the friends added, shared by all benchmarks and never killed. Adding them takes seconds.
+Tox *shared_tox() {
+    static Tox *const tox = [] {
+        Tox *tox = new_offline_tox(nullptr, 0);
+        if (tox == nullptr) {
+            return tox;
+        }
+
+        uint8_t key[TOX_PUBLIC_KEY_SIZE];
+        uint32_t state = 12345;
+        for (size_t i = 0; i < friends; i++) {
+            for (uint8_t &byte : key) {
+                state = state * 1103515245 + 12345;
+                byte = state >> 16;
+            }
+            tox_friend_add_norequest(tox, key, nullptr);
+        }
+        return tox;
+    }();
+    return tox;
+}
+
+std::vector<uint8_t> saved(Tox const *tox, TOX_SAVE_FORMAT format) {
+    std::vector<uint8_t> data(tox_save_formatted_size(tox, format));
+    data.resize(tox_save_formatted(tox, format, data.data()));
+    return data;
+}
+
+
+template<TOX_SAVE_FORMAT Format>
+void save(bench_state &state) {
+    Tox const *tox = shared_tox();
+    if (tox == nullptr) {
+        state.skip("tox_new failed");
+        return;
+    }
+
+    std::vector<uint8_t> data(tox_save_formatted_size(tox, Format));
+    size_t size = 0;
+    while (state.running()) {
+        size = tox_save_formatted(tox, Format, data.data());
+        keep(data);
+    }
+    state.set_bytes(size);
+}
+
+template<TOX_SAVE_FORMAT Format>
+void load(bench_state &state) {
+    Tox const *tox = shared_tox();
+    if (tox == nullptr) {
+        state.skip("tox_new failed");
+        return;
+    }
+
+    std::vector<uint8_t> const data = saved(tox, Format);
+    while (state.running()) {
+        Tox *loaded = new_offline_tox(data.data(), data.size());
+        keep(loaded);
+        tox_kill(loaded);
+    }
+    state.set_bytes(data.size());
+}
+
+BENCHMARK("savedata/save/plain", save<TOX_SAVE_FORMAT_PLAIN>);
+BENCHMARK("savedata/save/lz4", save<TOX_SAVE_FORMAT_LZ4>);
+BENCHMARK("savedata/load/plain", load<TOX_SAVE_FORMAT_PLAIN>);
+BENCHMARK("savedata/load/lz4", load<TOX_SAVE_FORMAT_LZ4>);
+
+}
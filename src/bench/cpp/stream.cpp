@@ -0,0 +1,215 @@
+#include "bench.h"
+
+#include "tox4j/Tox4j.h"
+
+#include <vector>
+
+
+/*
+ * Encoding one event of each kind into an event_stream as the callbacks in ToxCore/lifecycle.cpp and
+ * ToxAv/lifecycle.cpp do, then draining it as toxIteration and toxAvIteration do. Same events and payloads as the
+ * object tree benchmarks in events.cpp, so stream/core/X compares directly to events/core/X.
+ */
+
+namespace {
+
+std::vector<uint8_t> const key(32, 0x42);
+std::vector<uint8_t> const text(128, 'x');
+std::vector<uint8_t> const name(32, 'n');
+std::vector<uint8_t> const chunk(1371, 0xaa);
+std::vector<uint8_t> const packet(1024, 0xbb);
+std::vector<int16_t> const pcm(960 * 2, 1000);
+std::vector<uint8_t> const plane(640 * 480, 0x80);
+
+
+namespace cp = core::proto;
+namespace ap = av::proto;
+
+
+template<typename Encode>
+void encode_and_drain(bench_state &state, char const *module, Encode encode) {
+    event_stream events(module);
+    size_t size = 0;
+    while (state.running()) {
+        encode(events);
+
+        event_batch const batch = events.drain();
+        keep(batch.data);
+        size = batch.size;
+    }
+    state.set_bytes(size);
+}
+
+#define CORE_STREAM(NAME, ...)                                                  \
+    void core_##NAME(bench_state &state) {                                      \
+        encode_and_drain(state, "core", [](event_stream &events) {              \
+            __VA_ARGS__                                                         \
+        });                                                                     \
+    }                                                                           \
+    BENCHMARK("stream/core/" #NAME, core_##NAME)
+
+#define AV_STREAM(NAME, ...)                                                    \
+    void av_##NAME(bench_state &state) {                                        \
+        encode_and_drain(state, "av", [](event_stream &events) {                \
+            __VA_ARGS__                                                         \
+        });                                                                     \
+    }                                                                           \
+    BENCHMARK("stream/av/" #NAME, av_##NAME)
+
+
+CORE_STREAM(ConnectionStatus, {
+    event_writer msg(events, cp::CoreEvents::kConnectionStatusFieldNumber, 0);
+    msg.uint32(cp::ConnectionStatus::kConnectionStatusFieldNumber, cp::UDP4);
+});
+
+CORE_STREAM(FileControl, {
+    event_writer msg(events, cp::CoreEvents::kFileControlFieldNumber, 0);
+    msg.uint32(cp::FileControl::kFriendNumberFieldNumber, 1);
+    msg.uint32(cp::FileControl::kFileNumberFieldNumber, 2);
+    msg.uint32(cp::FileControl::kControlFieldNumber, cp::FileControl::PAUSE);
+});
+
+CORE_STREAM(FileReceive, {
+    event_writer msg(events, cp::CoreEvents::kFileReceiveFieldNumber, name.size());
+    msg.uint32(cp::FileReceive::kFriendNumberFieldNumber, 1);
+    msg.uint32(cp::FileReceive::kFileNumberFieldNumber, 2);
+    msg.uint32(cp::FileReceive::kKindFieldNumber, cp::FileReceive::DATA);
+    msg.uint64(cp::FileReceive::kFileSizeFieldNumber, 1 << 20);
+    msg.bytes(cp::FileReceive::kFilenameFieldNumber, name.data(), name.size());
+});
+
+CORE_STREAM(FileReceiveChunk, {
+    event_writer msg(events, cp::CoreEvents::kFileReceiveChunkFieldNumber, chunk.size());
+    msg.uint32(cp::FileReceiveChunk::kFriendNumberFieldNumber, 1);
+    msg.uint32(cp::FileReceiveChunk::kFileNumberFieldNumber, 2);
+    msg.uint64(cp::FileReceiveChunk::kPositionFieldNumber, 4096);
+    msg.bytes(cp::FileReceiveChunk::kDataFieldNumber, chunk.data(), chunk.size());
+});
+
+CORE_STREAM(FileRequestChunk, {
+    event_writer msg(events, cp::CoreEvents::kFileRequestChunkFieldNumber, 0);
+    msg.uint32(cp::FileRequestChunk::kFriendNumberFieldNumber, 1);
+    msg.uint32(cp::FileRequestChunk::kFileNumberFieldNumber, 2);
+    msg.uint64(cp::FileRequestChunk::kPositionFieldNumber, 4096);
+    msg.uint32(cp::FileRequestChunk::kLengthFieldNumber, chunk.size());
+});
+
+CORE_STREAM(FileProgress, {
+    event_writer msg(events, cp::CoreEvents::kFileProgressFieldNumber, 0);
+    msg.uint32(cp::FileProgress::kFriendNumberFieldNumber, 1);
+    msg.uint32(cp::FileProgress::kFileNumberFieldNumber, 2);
+    msg.uint64(cp::FileProgress::kPositionFieldNumber, 4096);
+});
+
+CORE_STREAM(FriendAction, {
+    event_writer msg(events, cp::CoreEvents::kFriendActionFieldNumber, text.size());
+    msg.uint32(cp::FriendAction::kFriendNumberFieldNumber, 1);
+    msg.time_delta(cp::FriendAction::kTimeDeltaFieldNumber);
+    msg.bytes(cp::FriendAction::kActionFieldNumber, text.data(), text.size());
+});
+
+CORE_STREAM(FriendConnectionStatus, {
+    event_writer msg(events, cp::CoreEvents::kFriendConnectionStatusFieldNumber, 0);
+    msg.uint32(cp::FriendConnectionStatus::kFriendNumberFieldNumber, 1);
+    msg.uint32(cp::FriendConnectionStatus::kConnectionStatusFieldNumber, cp::UDP4);
+});
+
+CORE_STREAM(FriendMessage, {
+    event_writer msg(events, cp::CoreEvents::kFriendMessageFieldNumber, text.size());
+    msg.uint32(cp::FriendMessage::kFriendNumberFieldNumber, 1);
+    msg.time_delta(cp::FriendMessage::kTimeDeltaFieldNumber);
+    msg.bytes(cp::FriendMessage::kMessageFieldNumber, text.data(), text.size());
+});
+
+CORE_STREAM(FriendName, {
+    event_writer msg(events, cp::CoreEvents::kFriendNameFieldNumber, name.size());
+    msg.uint32(cp::FriendName::kFriendNumberFieldNumber, 1);
+    msg.bytes(cp::FriendName::kNameFieldNumber, name.data(), name.size());
+});
+
+CORE_STREAM(FriendRequest, {
+    event_writer msg(events, cp::CoreEvents::kFriendRequestFieldNumber, key.size() + text.size());
+    msg.bytes(cp::FriendRequest::kPublicKeyFieldNumber, key.data(), key.size());
+    msg.time_delta(cp::FriendRequest::kTimeDeltaFieldNumber);
+    msg.bytes(cp::FriendRequest::kMessageFieldNumber, text.data(), text.size());
+});
+
+CORE_STREAM(FriendStatus, {
+    event_writer msg(events, cp::CoreEvents::kFriendStatusFieldNumber, 0);
+    msg.uint32(cp::FriendStatus::kFriendNumberFieldNumber, 1);
+    msg.uint32(cp::FriendStatus::kStatusFieldNumber, cp::FriendStatus::AWAY);
+});
+
+CORE_STREAM(FriendStatusMessage, {
+    event_writer msg(events, cp::CoreEvents::kFriendStatusMessageFieldNumber, text.size());
+    msg.uint32(cp::FriendStatusMessage::kFriendNumberFieldNumber, 1);
+    msg.bytes(cp::FriendStatusMessage::kMessageFieldNumber, text.data(), text.size());
+});
+
+CORE_STREAM(FriendTyping, {
+    event_writer msg(events, cp::CoreEvents::kFriendTypingFieldNumber, 0);
+    msg.uint32(cp::FriendTyping::kFriendNumberFieldNumber, 1);
+    msg.boolean(cp::FriendTyping::kIsTypingFieldNumber, true);
+});
+
+CORE_STREAM(FriendLosslessPacket, {
+    event_writer msg(events, cp::CoreEvents::kFriendLosslessPacketFieldNumber, packet.size());
+    msg.uint32(cp::FriendLosslessPacket::kFriendNumberFieldNumber, 1);
+    msg.bytes(cp::FriendLosslessPacket::kDataFieldNumber, packet.data(), packet.size());
+});
+
+CORE_STREAM(FriendLossyPacket, {
+    event_writer msg(events, cp::CoreEvents::kFriendLossyPacketFieldNumber, packet.size());
+    msg.uint32(cp::FriendLossyPacket::kFriendNumberFieldNumber, 1);
+    msg.bytes(cp::FriendLossyPacket::kDataFieldNumber, packet.data(), packet.size());
+});
+
+CORE_STREAM(ReadReceipt, {
+    event_writer msg(events, cp::CoreEvents::kReadReceiptFieldNumber, 0);
+    msg.uint32(cp::ReadReceipt::kFriendNumberFieldNumber, 1);
+    msg.uint32(cp::ReadReceipt::kMessageIdFieldNumber, 42);
+});
+
+
+AV_STREAM(Call, {
+    event_writer msg(events, ap::AvEvents::kCallFieldNumber, 0);
+    msg.uint32(ap::Call::kFriendNumberFieldNumber, 1);
+    msg.boolean(ap::Call::kAudioEnabledFieldNumber, true);
+    msg.boolean(ap::Call::kVideoEnabledFieldNumber, true);
+});
+
+AV_STREAM(CallState, {
+    event_writer msg(events, ap::AvEvents::kCallStateFieldNumber, 0);
+    msg.uint32(ap::CallState::kFriendNumberFieldNumber, 1);
+    msg.uint32(ap::CallState::kStateFieldNumber, ap::CallState::SENDING_AV);
+});
+
+AV_STREAM(RequestAudioFrame, {
+    event_writer msg(events, ap::AvEvents::kRequestAudioFrameFieldNumber, 0);
+    msg.uint32(ap::RequestAudioFrame::kFriendNumberFieldNumber, 1);
+});
+
+AV_STREAM(RequestVideoFrame, {
+    event_writer msg(events, ap::AvEvents::kRequestVideoFrameFieldNumber, 0);
+    msg.uint32(ap::RequestVideoFrame::kFriendNumberFieldNumber, 1);
+});
+
+AV_STREAM(ReceiveAudioFrame, {
+    event_writer msg(events, ap::AvEvents::kReceiveAudioFrameFieldNumber, pcm.size() * 10);
+    msg.uint32(ap::ReceiveAudioFrame::kFriendNumberFieldNumber, 1);
+    msg.packed_int32(ap::ReceiveAudioFrame::kPcmFieldNumber, pcm.data(), pcm.size());
+    msg.uint32(ap::ReceiveAudioFrame::kChannelsFieldNumber, 2);
+    msg.uint32(ap::ReceiveAudioFrame::kSamplingRateFieldNumber, 48000);
+});
+
+AV_STREAM(ReceiveVideoFrame, {
+    event_writer msg(events, ap::AvEvents::kReceiveVideoFrameFieldNumber, plane.size() * 3 / 2);
+    msg.uint32(ap::ReceiveVideoFrame::kFriendNumberFieldNumber, 1);
+    msg.uint32(ap::ReceiveVideoFrame::kWidthFieldNumber, 640);
+    msg.uint32(ap::ReceiveVideoFrame::kHeightFieldNumber, 480);
+    msg.bytes(ap::ReceiveVideoFrame::kYFieldNumber, plane.data(), plane.size());
+    msg.bytes(ap::ReceiveVideoFrame::kUFieldNumber, plane.data(), plane.size() / 4);
+    msg.bytes(ap::ReceiveVideoFrame::kVFieldNumber, plane.data(), plane.size() / 4);
+});
+
+}
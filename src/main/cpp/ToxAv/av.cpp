@@ -9,12 +9,43 @@
 JNIEXPORT jint JNICALL Java_im_tox_tox4j_ToxAvImpl_toxAvIterationInterval
   (JNIEnv *env, jclass, jint instanceNumber)
 {
-    return with_instance(env, instanceNumber, [=](ToxAV *av, Events &events) {
+    return with_instance(env, instanceNumber, "IterationInterval", [=](ToxAV *av, Events &events) {
         unused(events);
         return toxav_iteration_interval(av);
     });
 }
 
+/*
+ * Class:     im_tox_tox4j_ToxAvImpl
+ * Method:    toxAvSetMaxIterationInterval
+ * Signature: (II)V
+ */
+JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxAvImpl_toxAvSetMaxIterationInterval
+  (JNIEnv *env, jclass, jint instanceNumber, jint maxInterval)
+{
+    assert(maxInterval >= TOX_MIN_ITERATION_INTERVAL);
+    return with_instance(env, instanceNumber, "SetMaxIterationInterval", [=](ToxAV *av, Events &events) {
+        unused(events);
+        bool const ok = toxav_set_max_iteration_interval(av, maxInterval);
+        assert(ok);
+        unused(ok);
+    });
+}
+
+/*
+ * Class:     im_tox_tox4j_ToxAvImpl
+ * Method:    toxAvIterationWakeups
+ * Signature: (I)I
+ */
+JNIEXPORT jint JNICALL Java_im_tox_tox4j_ToxAvImpl_toxAvIterationWakeups
+  (JNIEnv *env, jclass, jint instanceNumber)
+{
+    return with_instance(env, instanceNumber, "IterationWakeups", [=](ToxAV *av, Events &events) {
+        unused(events);
+        return toxav_iteration_wakeups(av);
+    });
+}
+
 /*
  * Class:     im_tox_tox4j_ToxAvImpl
  * Method:    toxAvIteration
@@ -23,14 +54,34 @@ JNIEXPORT jint JNICALL Java_im_tox_tox4j_ToxAvImpl_toxAvIterationInterval
 JNIEXPORT jbyteArray JNICALL Java_im_tox_tox4j_ToxAvImpl_toxAvIteration
   (JNIEnv *env, jclass, jint instanceNumber)
 {
-    return with_instance(env, instanceNumber, [=](ToxAV *av, Events &events) {
+    return with_instance(env, instanceNumber, "Iteration", [=](ToxAV *av, Events &events) {
         toxav_iteration(av);
 
-        std::vector<char> buffer(events.ByteSize());
-        events.SerializeToArray(buffer.data(), buffer.size());
-        events.Clear();
+        event_batch const batch = events.drain();
+        return toJavaArray(env, batch.data, batch.size);
+    });
+}
 
-        return toJavaArray(env, buffer);
+/*
+ * Class:     im_tox_tox4j_ToxAvImpl
+ * Method:    toxAvIterationLimited
+ * Signature: (III)[B
+ */
+JNIEXPORT jbyteArray JNICALL Java_im_tox_tox4j_ToxAvImpl_toxAvIterationLimited
+  (JNIEnv *env, jclass, jint instanceNumber, jint maxEvents, jint maxBytes)
+{
+    assert(maxEvents > 0);
+    assert(maxBytes >= 0);
+    return with_instance(env, instanceNumber, "IterationLimited", [=](ToxAV *av, Events &events) {
+        // Keep frame requests on schedule while a backlog is handed out in slices, but only add to the backlog once
+        // what is left of it fits into one slice. Until then, received frames wait in toxav's jitter buffers, and
+        // frame requests are issued late and counted as such in the call stats.
+        if (!events.pending() || (toxav_iteration_due(av) && events.pending_bytes() <= size_t(maxBytes))) {
+            toxav_iteration(av);
+        }
+
+        event_batch const batch = events.drain(maxEvents, maxBytes);
+        return toJavaArray(env, batch.data, batch.size);
     });
 }
 
@@ -135,6 +186,14 @@ JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxAvImpl_toxAvSetVideoBitRate
     }, toxav_set_video_bit_rate, friendNumber, videoBitRate);
 }
 
+// Frame dimensions must be positive and fit the uint16_t of the native API. Checked before computing a pixel count
+// from them, which could otherwise be negative or overflow.
+static bool
+valid_frame_size(jint width, jint height)
+{
+    return width > 0 && height > 0 && width <= UINT16_MAX && height <= UINT16_MAX;
+}
+
 /*
  * Class:     im_tox_tox4j_ToxAvImpl
  * Method:    toxAvSendVideoFrame
@@ -143,7 +202,11 @@ JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxAvImpl_toxAvSetVideoBitRate
 JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxAvImpl_toxAvSendVideoFrame
   (JNIEnv *env, jclass, jint instanceNumber, jint friendNumber, jint width, jint height, jbyteArray y, jbyteArray u, jbyteArray v, jbyteArray a)
 {
-    size_t pixel_count = width * height;
+    if (!valid_frame_size(width, height)) {
+        throw_tox_exception(env, tox_traits::module, "SendFrame", "INVALID");
+        return;
+    }
+    size_t pixel_count = size_t(width) * size_t(height);
 
     ByteArray yData(env, y);
     ByteArray uData(env, u);
@@ -171,6 +234,54 @@ JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxAvImpl_toxAvSendVideoFrame
     }, toxav_send_video_frame, friendNumber, width, height, yData.data(), uData.data(), vData.data(), aData.data());
 }
 
+/*
+ * Class:     im_tox_tox4j_ToxAvImpl
+ * Method:    toxAvSendVideoFramePacked
+ * Signature: (IIIII[B)V
+ */
+JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxAvImpl_toxAvSendVideoFramePacked
+  (JNIEnv *env, jclass, jint instanceNumber, jint friendNumber, jint width, jint height, jint format, jbyteArray data)
+{
+    if (!valid_frame_size(width, height)) {
+        throw_tox_exception(env, tox_traits::module, "SendFrame", "INVALID");
+        return;
+    }
+    size_t pixel_count = size_t(width) * size_t(height);
+    size_t expected_size;
+    switch (format) {
+    case TOXAV_VIDEO_FORMAT_NV21:
+    case TOXAV_VIDEO_FORMAT_NV12:
+        expected_size = pixel_count * 3 / 2;
+        break;
+    case TOXAV_VIDEO_FORMAT_RGBA:
+    case TOXAV_VIDEO_FORMAT_BGRA:
+        expected_size = pixel_count * 4;
+        break;
+    default:
+        throw_tox_exception(env, tox_traits::module, "SendFrame", "INVALID");
+        return;
+    }
+
+    ByteArray frameData(env, data);
+    if (frameData.size() != expected_size) {
+        throw_tox_exception(env, tox_traits::module, "SendFrame", "BAD_LENGTH");
+        return;
+    }
+
+    return with_instance(env, instanceNumber, "SendFrame", [](TOXAV_ERR_SEND_FRAME error) {
+        switch (error) {
+            success_case(SEND_FRAME);
+            failure_case(SEND_FRAME, NULL);
+            failure_case(SEND_FRAME, FRIEND_NOT_FOUND);
+            failure_case(SEND_FRAME, FRIEND_NOT_IN_CALL);
+            failure_case(SEND_FRAME, NOT_REQUESTED);
+            failure_case(SEND_FRAME, INVALID);
+        }
+        return unhandled();
+    }, [](bool) {
+    }, toxav_send_video_frame_packed, friendNumber, width, height, (TOXAV_VIDEO_FORMAT) format, frameData.data());
+}
+
 /*
  * Class:     im_tox_tox4j_ToxAvImpl
  * Method:    toxAvSendAudioFrame
@@ -184,12 +295,21 @@ JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxAvImpl_toxAvSendAudioFrame
     assert(channels <= 255);
     assert(samplingRate >= 0);
 
-    ShortArray pcmData(env, pcm);
-    if (pcmData.size() != size_t (sampleCount * channels)) {
+    size_t length = pcm ? env->GetArrayLength(pcm) : 0;
+    if (length != size_t (sampleCount * channels)) {
         throw_tox_exception(env, tox_traits::module, "SendFrame", "BAD_LENGTH");
         return;
     }
 
+    // Copy the samples into a buffer that lives as long as the calling
+    // thread. It only grows when a frame is larger than any before it, so a
+    // steady audio stream sends without allocating.
+    static thread_local std::vector<int16_t> pcmData;
+    if (pcmData.size() < length)
+        pcmData.resize(length);
+    if (length != 0)
+        env->GetShortArrayRegion(pcm, 0, length, pcmData.data());
+
     return with_instance(env, instanceNumber, "SendFrame", [](TOXAV_ERR_SEND_FRAME error) {
         switch (error) {
             success_case(SEND_FRAME);
@@ -203,3 +323,125 @@ JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxAvImpl_toxAvSendAudioFrame
     }, [](bool) {
     }, toxav_send_audio_frame, friendNumber, pcmData.data(), sampleCount, channels, samplingRate);
 }
+
+/*
+ * Class:     im_tox_tox4j_ToxAvImpl
+ * Method:    toxAvMixerAddFriend
+ * Signature: (II)V
+ */
+JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxAvImpl_toxAvMixerAddFriend
+  (JNIEnv *env, jclass, jint instanceNumber, jint friendNumber)
+{
+    return with_instance(env, instanceNumber, "Mixer", [](TOXAV_ERR_MIXER error) {
+        switch (error) {
+            success_case(MIXER);
+            failure_case(MIXER, FRIEND_NOT_FOUND);
+            failure_case(MIXER, ALREADY_MIXED);
+            failure_case(MIXER, NOT_MIXED);
+        }
+        return unhandled();
+    }, [](bool) {
+    }, toxav_mixer_add_friend, friendNumber);
+}
+
+/*
+ * Class:     im_tox_tox4j_ToxAvImpl
+ * Method:    toxAvMixerRemoveFriend
+ * Signature: (II)V
+ */
+JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxAvImpl_toxAvMixerRemoveFriend
+  (JNIEnv *env, jclass, jint instanceNumber, jint friendNumber)
+{
+    return with_instance(env, instanceNumber, "Mixer", [](TOXAV_ERR_MIXER error) {
+        switch (error) {
+            success_case(MIXER);
+            failure_case(MIXER, FRIEND_NOT_FOUND);
+            failure_case(MIXER, ALREADY_MIXED);
+            failure_case(MIXER, NOT_MIXED);
+        }
+        return unhandled();
+    }, [](bool) {
+    }, toxav_mixer_remove_friend, friendNumber);
+}
+
+static void set_stream_stats(proto::StreamStats *message, ToxAV_Stream_Stats const &stats)
+{
+    message->set_framesrequested(stats.frames_requested);
+    message->set_framessent(stats.frames_sent);
+    message->set_framesreceived(stats.frames_received);
+    message->set_framesdropped(stats.frames_dropped);
+    message->set_encodetimeaverage(stats.encode_time_average);
+    message->set_encodetimemax(stats.encode_time_max);
+    message->set_bitrate(stats.bit_rate);
+    message->set_configuredbitrate(stats.configured_bit_rate);
+    message->set_jitter(stats.jitter);
+    message->set_sendlatencymax(stats.send_latency_max);
+    for (uint32_t count : stats.send_latency) {
+        message->add_sendlatency(count);
+    }
+}
+
+/*
+ * Class:     im_tox_tox4j_ToxAvImpl
+ * Method:    toxAvGetCallStats
+ * Signature: (II)[B
+ */
+JNIEXPORT jbyteArray JNICALL Java_im_tox_tox4j_ToxAvImpl_toxAvGetCallStats
+  (JNIEnv *env, jclass, jint instanceNumber, jint friendNumber)
+{
+    ToxAV_Call_Stats stats;
+    return with_instance(env, instanceNumber, "CallStats", [](TOXAV_ERR_CALL_STATS error) {
+        switch (error) {
+            success_case(CALL_STATS);
+            failure_case(CALL_STATS, FRIEND_NOT_IN_CALL);
+        }
+        return unhandled();
+    }, [&](bool) {
+        proto::CallStats message;
+
+        proto::VideoSendStats *videoSend = message.mutable_videosend();
+        videoSend->set_frames(stats.video_send.frames);
+        videoSend->set_scaledframes(stats.video_send.scaled_frames);
+        videoSend->set_lastconverttime(stats.video_send.last_convert_time);
+        videoSend->set_lastscaletime(stats.video_send.last_scale_time);
+        videoSend->set_lastencodetime(stats.video_send.last_encode_time);
+        videoSend->set_maxconverttime(stats.video_send.max_convert_time);
+        videoSend->set_maxscaletime(stats.video_send.max_scale_time);
+        videoSend->set_maxencodetime(stats.video_send.max_encode_time);
+
+        proto::VideoReceiveStats *videoReceive = message.mutable_videoreceive();
+        videoReceive->set_frames(stats.video_receive.frames);
+        videoReceive->set_bufferallocations(stats.video_receive.buffer_allocations);
+        videoReceive->set_lastcopytime(stats.video_receive.last_copy_time);
+        videoReceive->set_maxcopytime(stats.video_receive.max_copy_time);
+
+        proto::RequestStats *requests = message.mutable_requests();
+        requests->set_audiorequests(stats.requests.audio_requests);
+        requests->set_videorequests(stats.requests.video_requests);
+        requests->set_skippeddeadlines(stats.requests.skipped_deadlines);
+        requests->set_maxlateness(stats.requests.max_lateness);
+        for (uint32_t count : stats.requests.lateness) {
+            requests->add_lateness(count);
+        }
+
+        set_stream_stats(message.mutable_audio(), stats.audio);
+        set_stream_stats(message.mutable_video(), stats.video);
+
+        std::vector<char> buffer(message.ByteSize());
+        message.SerializeToArray(buffer.data(), buffer.size());
+        return toJavaArray(env, buffer);
+    }, toxav_get_call_stats, friendNumber, &stats);
+}
+
+/*
+ * Class:     im_tox_tox4j_ToxAvImpl
+ * Method:    toxAvGetMemoryUsage
+ * Signature: (I)[J
+ */
+JNIEXPORT jlongArray JNICALL Java_im_tox_tox4j_ToxAvImpl_toxAvGetMemoryUsage
+  (JNIEnv *env, jclass, jint instanceNumber)
+{
+    return with_instance(env, instanceNumber, "GetMemoryUsage", [=](ToxAV *av, Events &events) {
+        return toJavaArray(env, av_memory_usage(av, events));
+    });
+}
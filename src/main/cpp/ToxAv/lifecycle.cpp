@@ -8,24 +8,24 @@ static void tox4j_call_cb(ToxAV *av, uint32_t friend_number, bool audio_enabled,
 {
     unused(av);
     Events &events = *static_cast<Events *>(user_data);
-    auto msg = events.add_call();
-    msg->set_friendnumber(friend_number);
-    msg->set_audioenabled(audio_enabled);
-    msg->set_videoenabled(video_enabled);
+    event_writer msg(events, proto::AvEvents::kCallFieldNumber, 0);
+    msg.uint32(proto::Call::kFriendNumberFieldNumber, friend_number);
+    msg.boolean(proto::Call::kAudioEnabledFieldNumber, audio_enabled);
+    msg.boolean(proto::Call::kVideoEnabledFieldNumber, video_enabled);
 }
 
 static void tox4j_call_state_cb(ToxAV *av, uint32_t friend_number, TOXAV_CALL_STATE state, void *user_data)
 {
     unused(av);
     Events &events = *static_cast<Events *>(user_data);
-    auto msg = events.add_callstate();
-    msg->set_friendnumber(friend_number);
+    event_writer msg(events, proto::AvEvents::kCallStateFieldNumber, 0);
+    msg.uint32(proto::CallState::kFriendNumberFieldNumber, friend_number);
 
     using proto::CallState;
     switch (state) {
-#define call_state_case(STATE)                  \
-        case TOXAV_CALL_STATE_##STATE:          \
-            msg->set_state(CallState::STATE);   \
+#define call_state_case(STATE)                                          \
+        case TOXAV_CALL_STATE_##STATE:                                  \
+            msg.uint32(CallState::kStateFieldNumber, CallState::STATE); \
             break
         call_state_case(RINGING);
         call_state_case(SENDING_NONE);
@@ -43,16 +43,16 @@ static void tox4j_request_audio_frame_cb(ToxAV *av, uint32_t friend_number, void
 {
     unused(av);
     Events &events = *static_cast<Events *>(user_data);
-    auto msg = events.add_requestaudioframe();
-    msg->set_friendnumber(friend_number);
+    event_writer msg(events, proto::AvEvents::kRequestAudioFrameFieldNumber, 0);
+    msg.uint32(proto::RequestAudioFrame::kFriendNumberFieldNumber, friend_number);
 }
 
 static void tox4j_request_video_frame_cb(ToxAV *av, uint32_t friend_number, void *user_data)
 {
     unused(av);
     Events &events = *static_cast<Events *>(user_data);
-    auto msg = events.add_requestvideoframe();
-    msg->set_friendnumber(friend_number);
+    event_writer msg(events, proto::AvEvents::kRequestVideoFrameFieldNumber, 0);
+    msg.uint32(proto::RequestVideoFrame::kFriendNumberFieldNumber, friend_number);
 }
 
 static void tox4j_receive_audio_frame_cb(ToxAV *av, uint32_t friend_number,
@@ -64,15 +64,12 @@ static void tox4j_receive_audio_frame_cb(ToxAV *av, uint32_t friend_number,
 {
     unused(av);
     Events &events = *static_cast<Events *>(user_data);
-    auto msg = events.add_receiveaudioframe();
-    msg->set_friendnumber(friend_number);
-
-    for (size_t i = 0; i < sample_count * channels; i++) {
-        msg->add_pcm(pcm[i]);
-    }
-
-    msg->set_channels(channels);
-    msg->set_samplingrate(sampling_rate);
+    size_t const samples = sample_count * channels;
+    event_writer msg(events, proto::AvEvents::kReceiveAudioFrameFieldNumber, samples * 10);
+    msg.uint32(proto::ReceiveAudioFrame::kFriendNumberFieldNumber, friend_number);
+    msg.packed_int32(proto::ReceiveAudioFrame::kPcmFieldNumber, pcm, samples);
+    msg.uint32(proto::ReceiveAudioFrame::kChannelsFieldNumber, channels);
+    msg.uint32(proto::ReceiveAudioFrame::kSamplingRateFieldNumber, sampling_rate);
 }
 
 static void tox4j_receive_video_frame_cb(ToxAV *av, uint32_t friend_number,
@@ -82,15 +79,18 @@ static void tox4j_receive_video_frame_cb(ToxAV *av, uint32_t friend_number,
 {
     unused(av);
     Events &events = *static_cast<Events *>(user_data);
-    auto msg = events.add_receivevideoframe();
-    msg->set_friendnumber(friend_number);
-    msg->set_width(width);
-    msg->set_height(height);
-    msg->set_y(y, width * height);
-    msg->set_u(u, width * height);
-    msg->set_v(v, width * height);
+    size_t const luma = size_t(width) * height;
+    size_t const chroma = size_t((width + 1) / 2) * ((height + 1) / 2);
+    event_writer msg(events, proto::AvEvents::kReceiveVideoFrameFieldNumber,
+                     luma + 2 * chroma + (a != nullptr ? luma : 0));
+    msg.uint32(proto::ReceiveVideoFrame::kFriendNumberFieldNumber, friend_number);
+    msg.uint32(proto::ReceiveVideoFrame::kWidthFieldNumber, width);
+    msg.uint32(proto::ReceiveVideoFrame::kHeightFieldNumber, height);
+    msg.bytes(proto::ReceiveVideoFrame::kYFieldNumber, y, luma);
+    msg.bytes(proto::ReceiveVideoFrame::kUFieldNumber, u, chroma);
+    msg.bytes(proto::ReceiveVideoFrame::kVFieldNumber, v, chroma);
     if (a != nullptr) {
-        msg->set_a(a, width * height);
+        msg.bytes(proto::ReceiveVideoFrame::kAFieldNumber, a, luma);
     }
 }
 
@@ -107,7 +107,7 @@ JNIEXPORT jint JNICALL Java_im_tox_tox4j_ToxAvImpl_toxAvNew
         TOXAV_ERR_NEW error;
         AvInstance::pointer av(toxav_new(tox, &error));
 
-        std::unique_ptr<Events> events(new Events);
+        std::unique_ptr<Events> events(new Events(tox_traits::module));
 
         // Set up our callbacks.
         toxav_callback_call               (av.get(), tox4j_call_cb,                events.get());
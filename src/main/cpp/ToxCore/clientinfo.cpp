@@ -9,7 +9,7 @@
 JNIEXPORT jbyteArray JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSelfGetPublicKey
   (JNIEnv *env, jclass, jint instanceNumber)
 {
-    return with_instance(env, instanceNumber, [=](Tox *tox, Events &events) {
+    return with_instance(env, instanceNumber, "SelfGetPublicKey", [=](Tox *tox, Events &events) {
         unused(events);
         std::vector<uint8_t> public_key(TOX_PUBLIC_KEY_SIZE);
         tox_self_get_public_key(tox, public_key.data());
@@ -25,7 +25,7 @@ JNIEXPORT jbyteArray JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSelfGetPublicKey
 JNIEXPORT jbyteArray JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSelfGetSecretKey
   (JNIEnv *env, jclass, jint instanceNumber)
 {
-    return with_instance(env, instanceNumber, [=](Tox *tox, Events &events) {
+    return with_instance(env, instanceNumber, "SelfGetSecretKey", [=](Tox *tox, Events &events) {
         unused(events);
         std::vector<uint8_t> secret_key(TOX_SECRET_KEY_SIZE);
         tox_self_get_secret_key(tox, secret_key.data());
@@ -41,7 +41,7 @@ JNIEXPORT jbyteArray JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSelfGetSecretKey
 JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSelfSetNospam
   (JNIEnv *env, jclass, jint instanceNumber, jint nospam)
 {
-    return with_instance(env, instanceNumber, [=](Tox *tox, Events &events) {
+    return with_instance(env, instanceNumber, "SelfSetNospam", [=](Tox *tox, Events &events) {
         unused(events);
         tox_self_set_nospam(tox, nospam);
     });
@@ -55,7 +55,7 @@ JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSelfSetNospam
 JNIEXPORT jint JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSelfGetNospam
   (JNIEnv *env, jclass, jint instanceNumber)
 {
-    return with_instance(env, instanceNumber, [=](Tox *tox, Events &events) {
+    return with_instance(env, instanceNumber, "SelfGetNospam", [=](Tox *tox, Events &events) {
         unused(events);
         return tox_self_get_nospam(tox);
     });
@@ -69,7 +69,7 @@ JNIEXPORT jint JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSelfGetNospam
 JNIEXPORT jbyteArray JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSelfGetAddress
   (JNIEnv *env, jclass, jint instanceNumber)
 {
-    return with_instance(env, instanceNumber, [=](Tox *tox, Events &events) {
+    return with_instance(env, instanceNumber, "SelfGetAddress", [=](Tox *tox, Events &events) {
         unused(events);
         std::vector<uint8_t> address(TOX_ADDRESS_SIZE);
         tox_self_get_address(tox, address.data());
@@ -109,7 +109,7 @@ JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSelfSetName
 JNIEXPORT jbyteArray JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSelfGetName
   (JNIEnv *env, jclass, jint instanceNumber)
 {
-    return with_instance(env, instanceNumber, [=](Tox *tox, Events &events) -> jbyteArray {
+    return with_instance(env, instanceNumber, "SelfGetName", [=](Tox *tox, Events &events) -> jbyteArray {
         unused(events);
         size_t size = tox_self_get_name_size(tox);
         if (size == 0) {
@@ -143,7 +143,7 @@ JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSelfSetStatusMessage
 JNIEXPORT jbyteArray JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSelfGetStatusMessage
   (JNIEnv *env, jclass, jint instanceNumber)
 {
-    return with_instance(env, instanceNumber, [=](Tox *tox, Events &events) -> jbyteArray {
+    return with_instance(env, instanceNumber, "SelfGetStatusMessage", [=](Tox *tox, Events &events) -> jbyteArray {
         unused(events);
         size_t size = tox_self_get_status_message_size(tox);
         if (size == 0) {
@@ -164,7 +164,7 @@ JNIEXPORT jbyteArray JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSelfGetStatusMessa
 JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSelfSetStatus
   (JNIEnv *env, jclass, jint instanceNumber, jint status)
 {
-    return with_instance(env, instanceNumber, [=](Tox *tox, Events &events) {
+    return with_instance(env, instanceNumber, "SelfSetStatus", [=](Tox *tox, Events &events) {
         unused(events);
         tox_self_set_status(tox, (TOX_STATUS) status); // TODO: better use a switch
     });
@@ -178,7 +178,7 @@ JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSelfSetStatus
 JNIEXPORT jint JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSelfGetStatus
   (JNIEnv *env, jclass, jint instanceNumber)
 {
-    return with_instance(env, instanceNumber, [=](Tox *tox, Events &events) {
+    return with_instance(env, instanceNumber, "SelfGetStatus", [=](Tox *tox, Events &events) {
         unused(events);
         return tox_self_get_status(tox);
     });
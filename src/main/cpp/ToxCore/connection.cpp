@@ -92,7 +92,7 @@ JNIEXPORT jint JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxGetTcpPort
 JNIEXPORT jbyteArray JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxGetDhtId
   (JNIEnv *env, jclass, jint instanceNumber)
 {
-    return with_instance(env, instanceNumber, [=](Tox *tox, Events &events) {
+    return with_instance(env, instanceNumber, "GetDhtId", [=](Tox *tox, Events &events) {
         unused(events);
         std::vector<uint8_t> dht_id(TOX_PUBLIC_KEY_SIZE);
         tox_get_dht_id(tox, dht_id.data());
@@ -108,12 +108,43 @@ JNIEXPORT jbyteArray JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxGetDhtId
 JNIEXPORT jint JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxIterationInterval
   (JNIEnv *env, jclass, jint instanceNumber)
 {
-    return with_instance(env, instanceNumber, [=](Tox *tox, Events &events) {
+    return with_instance(env, instanceNumber, "IterationInterval", [=](Tox *tox, Events &events) {
         unused(events);
         return tox_iteration_interval(tox);
     });
 }
 
+/*
+ * Class:     im_tox_tox4jToxCoreImpl
+ * Method:    toxSetMaxIterationInterval
+ * Signature: (II)V
+ */
+JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSetMaxIterationInterval
+  (JNIEnv *env, jclass, jint instanceNumber, jint maxInterval)
+{
+    assert(maxInterval >= TOX_MIN_ITERATION_INTERVAL);
+    return with_instance(env, instanceNumber, "SetMaxIterationInterval", [=](Tox *tox, Events &events) {
+        unused(events);
+        bool const ok = tox_set_max_iteration_interval(tox, maxInterval);
+        assert(ok);
+        unused(ok);
+    });
+}
+
+/*
+ * Class:     im_tox_tox4jToxCoreImpl
+ * Method:    toxIterationWakeups
+ * Signature: (I)I
+ */
+JNIEXPORT jint JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxIterationWakeups
+  (JNIEnv *env, jclass, jint instanceNumber)
+{
+    return with_instance(env, instanceNumber, "IterationWakeups", [=](Tox *tox, Events &events) {
+        unused(events);
+        return tox_iteration_wakeups(tox);
+    });
+}
+
 /*
  * Class:     im_tox_tox4jToxCoreImpl
  * Method:    toxIteration
@@ -122,13 +153,36 @@ JNIEXPORT jint JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxIterationInterval
 JNIEXPORT jbyteArray JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxIteration
   (JNIEnv *env, jclass, jint instanceNumber)
 {
-    return with_instance(env, instanceNumber, [=](Tox *tox, Events &events) {
+    return with_instance(env, instanceNumber, "Iteration", [=](Tox *tox, Events &events) {
+        // Usually 0, unless the last call was a partial drain.
+        tox_set_event_backlog(tox, events.pending_bytes());
         tox_iteration(tox);
 
-        std::vector<char> buffer(events.ByteSize());
-        events.SerializeToArray(buffer.data(), buffer.size());
-        events.Clear();
+        event_batch const batch = events.drain();
+        return toJavaArray(env, batch.data, batch.size);
+    });
+}
+
+/*
+ * Class:     im_tox_tox4jToxCoreImpl
+ * Method:    toxIterationLimited
+ * Signature: (III)[B
+ */
+JNIEXPORT jbyteArray JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxIterationLimited
+  (JNIEnv *env, jclass, jint instanceNumber, jint maxEvents, jint maxBytes)
+{
+    assert(maxEvents > 0);
+    assert(maxBytes >= 0);
+    return with_instance(env, instanceNumber, "IterationLimited", [=](Tox *tox, Events &events) {
+        // Service the network on schedule even while a backlog is handed out in slices. The event budget counts
+        // the backlog, so with a budget set it stays bounded: throttled transfers stay paused and lossy packets are
+        // dropped until it has been drained below the budget.
+        if (!events.pending() || tox_iteration_due(tox)) {
+            tox_set_event_backlog(tox, events.pending_bytes());
+            tox_iteration(tox);
+        }
 
-        return toJavaArray(env, buffer);
+        event_batch const batch = events.drain(maxEvents, maxBytes);
+        return toJavaArray(env, batch.data, batch.size);
     });
 }
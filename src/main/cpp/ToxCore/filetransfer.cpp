@@ -49,13 +49,40 @@ JNIEXPORT jint JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxFileSend
     }, tox_file_send, friendNumber, (TOX_FILE_KIND) kind, fileSize, filenameData.data(), filenameData.size());
 }
 
+/*
+ * Class:     im_tox_tox4jToxCoreImpl
+ * Method:    toxFileSendFromPath
+ * Signature: (IIILjava/lang/String;[B)I
+ */
+JNIEXPORT jint JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxFileSendFromPath
+  (JNIEnv *env, jclass, jint instanceNumber, jint friendNumber, jint kind, jstring path, jbyteArray filename)
+{
+    UTFChars pathChars(env, path);
+    ByteArray filenameData(env, filename);
+    return with_instance(env, instanceNumber, "FileSendFromPath", [](TOX_ERR_FILE_SEND_FROM_PATH error) {
+        switch (error) {
+            success_case(FILE_SEND_FROM_PATH);
+            failure_case(FILE_SEND_FROM_PATH, NULL);
+            failure_case(FILE_SEND_FROM_PATH, FRIEND_NOT_FOUND);
+            failure_case(FILE_SEND_FROM_PATH, FRIEND_NOT_CONNECTED);
+            failure_case(FILE_SEND_FROM_PATH, NAME_EMPTY);
+            failure_case(FILE_SEND_FROM_PATH, NAME_TOO_LONG);
+            failure_case(FILE_SEND_FROM_PATH, TOO_MANY);
+            failure_case(FILE_SEND_FROM_PATH, IO);
+        }
+        return unhandled();
+    }, [](uint32_t file_number) {
+        return file_number;
+    }, tox_file_send_from_path, friendNumber, (TOX_FILE_KIND) kind, pathChars.data(), filenameData.data(), filenameData.size());
+}
+
 /*
  * Class:     im_tox_tox4jToxCoreImpl
  * Method:    toxFileSendChunk
- * Signature: (III[B)V
+ * Signature: (IIIJ[B)V
  */
 JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxFileSendChunk
-  (JNIEnv *env, jclass, jint instanceNumber, jint friendNumber, jint fileNumber, jbyteArray chunk)
+  (JNIEnv *env, jclass, jint instanceNumber, jint friendNumber, jint fileNumber, jlong position, jbyteArray chunk)
 {
     ByteArray chunkData(env, chunk);
     return with_instance(env, instanceNumber, "FileSendChunk", [](TOX_ERR_FILE_SEND_CHUNK error) {
@@ -66,8 +93,31 @@ JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxFileSendChunk
             failure_case(FILE_SEND_CHUNK, FRIEND_NOT_CONNECTED);
             failure_case(FILE_SEND_CHUNK, NOT_FOUND);
             failure_case(FILE_SEND_CHUNK, TOO_LARGE);
+            failure_case(FILE_SEND_CHUNK, WRONG_POSITION);
+        }
+        return unhandled();
+    }, [](bool) {
+    }, tox_file_send_chunk, friendNumber, fileNumber, position, chunkData.data(), chunkData.size());
+}
+
+/*
+ * Class:     im_tox_tox4jToxCoreImpl
+ * Method:    toxFileSetSink
+ * Signature: (IIILjava/lang/String;)V
+ */
+JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxFileSetSink
+  (JNIEnv *env, jclass, jint instanceNumber, jint friendNumber, jint fileNumber, jstring path)
+{
+    UTFChars pathChars(env, path);
+    return with_instance(env, instanceNumber, "FileSetSink", [](TOX_ERR_FILE_SET_SINK error) {
+        switch (error) {
+            success_case(FILE_SET_SINK);
+            failure_case(FILE_SET_SINK, NULL);
+            failure_case(FILE_SET_SINK, FRIEND_NOT_FOUND);
+            failure_case(FILE_SET_SINK, NOT_FOUND);
+            failure_case(FILE_SET_SINK, IO);
         }
         return unhandled();
     }, [](bool) {
-    }, tox_file_send_chunk, friendNumber, fileNumber, chunkData.data(), chunkData.size());
+    }, tox_file_set_sink, friendNumber, fileNumber, pathChars.data());
 }
@@ -4,12 +4,11 @@ using CoreInstanceManager = instance_manager<tox_traits>;
 using CoreInstance = tox_instance<tox_traits>;
 
 
-template<typename Message>
-void add_connectionstatus(Message &msg, TOX_CONNECTION connection_status)
+static void add_connectionstatus(event_writer &msg, int field, TOX_CONNECTION connection_status)
 {
 #define connection_case(STATUS)                         \
         case TOX_CONNECTION_##STATUS:                   \
-            msg->set_connectionstatus(Socket::STATUS);  \
+            msg.uint32(field, Socket::STATUS);          \
             break
 
     using proto::Socket;
@@ -28,45 +27,45 @@ static void tox4j_connection_status_cb(Tox *tox, TOX_CONNECTION connection_statu
 {
     unused(tox);
     Events &events = *static_cast<Events *>(user_data);
-    auto msg = events.add_connectionstatus();
-    add_connectionstatus(msg, connection_status);
+    event_writer msg(events, proto::CoreEvents::kConnectionStatusFieldNumber, 0);
+    add_connectionstatus(msg, proto::ConnectionStatus::kConnectionStatusFieldNumber, connection_status);
 }
 
 static void tox4j_friend_name_cb(Tox *tox, uint32_t friend_number, uint8_t const *name, size_t length, void *user_data)
 {
     unused(tox);
     Events &events = *static_cast<Events *>(user_data);
-    auto msg = events.add_friendname();
-    msg->set_friendnumber(friend_number);
-    msg->set_name(name, length);
+    event_writer msg(events, proto::CoreEvents::kFriendNameFieldNumber, length);
+    msg.uint32(proto::FriendName::kFriendNumberFieldNumber, friend_number);
+    msg.bytes(proto::FriendName::kNameFieldNumber, name, length);
 }
 
 static void tox4j_friend_status_message_cb(Tox *tox, uint32_t friend_number, uint8_t const *message, size_t length, void *user_data)
 {
     unused(tox);
     Events &events = *static_cast<Events *>(user_data);
-    auto msg = events.add_friendstatusmessage();
-    msg->set_friendnumber(friend_number);
-    msg->set_message(message, length);
+    event_writer msg(events, proto::CoreEvents::kFriendStatusMessageFieldNumber, length);
+    msg.uint32(proto::FriendStatusMessage::kFriendNumberFieldNumber, friend_number);
+    msg.bytes(proto::FriendStatusMessage::kMessageFieldNumber, message, length);
 }
 
 static void tox4j_friend_status_cb(Tox *tox, uint32_t friend_number, TOX_STATUS status, void *user_data)
 {
     unused(tox);
     Events &events = *static_cast<Events *>(user_data);
-    auto msg = events.add_friendstatus();
-    msg->set_friendnumber(friend_number);
+    event_writer msg(events, proto::CoreEvents::kFriendStatusFieldNumber, 0);
+    msg.uint32(proto::FriendStatus::kFriendNumberFieldNumber, friend_number);
 
     using proto::FriendStatus;
     switch (status) {
         case TOX_STATUS_NONE:
-            msg->set_status(FriendStatus::NONE);
+            msg.uint32(FriendStatus::kStatusFieldNumber, FriendStatus::NONE);
             break;
         case TOX_STATUS_AWAY:
-            msg->set_status(FriendStatus::AWAY);
+            msg.uint32(FriendStatus::kStatusFieldNumber, FriendStatus::AWAY);
             break;
         case TOX_STATUS_BUSY:
-            msg->set_status(FriendStatus::BUSY);
+            msg.uint32(FriendStatus::kStatusFieldNumber, FriendStatus::BUSY);
             break;
     }
 }
@@ -75,77 +74,77 @@ static void tox4j_friend_connection_status_cb(Tox *tox, uint32_t friend_number,
 {
     unused(tox);
     Events &events = *static_cast<Events *>(user_data);
-    auto msg = events.add_friendconnectionstatus();
-    msg->set_friendnumber(friend_number);
-    add_connectionstatus(msg, connection_status);
+    event_writer msg(events, proto::CoreEvents::kFriendConnectionStatusFieldNumber, 0);
+    msg.uint32(proto::FriendConnectionStatus::kFriendNumberFieldNumber, friend_number);
+    add_connectionstatus(msg, proto::FriendConnectionStatus::kConnectionStatusFieldNumber, connection_status);
 }
 
 static void tox4j_friend_typing_cb(Tox *tox, uint32_t friend_number, bool is_typing, void *user_data)
 {
     unused(tox);
     Events &events = *static_cast<Events *>(user_data);
-    auto msg = events.add_friendtyping();
-    msg->set_friendnumber(friend_number);
-    msg->set_istyping(is_typing);
+    event_writer msg(events, proto::CoreEvents::kFriendTypingFieldNumber, 0);
+    msg.uint32(proto::FriendTyping::kFriendNumberFieldNumber, friend_number);
+    msg.boolean(proto::FriendTyping::kIsTypingFieldNumber, is_typing);
 }
 
 static void tox4j_read_receipt_cb(Tox *tox, uint32_t friend_number, uint32_t message_id, void *user_data)
 {
     unused(tox);
     Events &events = *static_cast<Events *>(user_data);
-    auto msg = events.add_readreceipt();
-    msg->set_friendnumber(friend_number);
-    msg->set_messageid(message_id);
+    event_writer msg(events, proto::CoreEvents::kReadReceiptFieldNumber, 0);
+    msg.uint32(proto::ReadReceipt::kFriendNumberFieldNumber, friend_number);
+    msg.uint32(proto::ReadReceipt::kMessageIdFieldNumber, message_id);
 }
 
 static void tox4j_friend_request_cb(Tox *tox, uint8_t const *public_key, /*uint32_t time_delta, */uint8_t const *message, size_t length, void *user_data)
 {
     unused(tox);
     Events &events = *static_cast<Events *>(user_data);
-    auto msg = events.add_friendrequest();
-    msg->set_publickey(public_key, TOX_PUBLIC_KEY_SIZE);
-    msg->set_timedelta(0);
-    msg->set_message(message, length);
+    event_writer msg(events, proto::CoreEvents::kFriendRequestFieldNumber, TOX_PUBLIC_KEY_SIZE + length);
+    msg.bytes(proto::FriendRequest::kPublicKeyFieldNumber, public_key, TOX_PUBLIC_KEY_SIZE);
+    msg.time_delta(proto::FriendRequest::kTimeDeltaFieldNumber);
+    msg.bytes(proto::FriendRequest::kMessageFieldNumber, message, length);
 }
 
 static void tox4j_friend_message_cb(Tox *tox, uint32_t friend_number, /*uint32_t time_delta, */uint8_t const *message, size_t length, void *user_data)
 {
     unused(tox);
     Events &events = *static_cast<Events *>(user_data);
-    auto msg = events.add_friendmessage();
-    msg->set_friendnumber(friend_number);
-    msg->set_timedelta(0);
-    msg->set_message(message, length);
+    event_writer msg(events, proto::CoreEvents::kFriendMessageFieldNumber, length);
+    msg.uint32(proto::FriendMessage::kFriendNumberFieldNumber, friend_number);
+    msg.time_delta(proto::FriendMessage::kTimeDeltaFieldNumber);
+    msg.bytes(proto::FriendMessage::kMessageFieldNumber, message, length);
 }
 
 static void tox4j_friend_action_cb(Tox *tox, uint32_t friend_number, /*uint32_t time_delta, */uint8_t const *action, size_t length, void *user_data)
 {
     unused(tox);
     Events &events = *static_cast<Events *>(user_data);
-    auto msg = events.add_friendaction();
-    msg->set_friendnumber(friend_number);
-    msg->set_timedelta(0);
-    msg->set_action(action, length);
+    event_writer msg(events, proto::CoreEvents::kFriendActionFieldNumber, length);
+    msg.uint32(proto::FriendAction::kFriendNumberFieldNumber, friend_number);
+    msg.time_delta(proto::FriendAction::kTimeDeltaFieldNumber);
+    msg.bytes(proto::FriendAction::kActionFieldNumber, action, length);
 }
 
 static void tox4j_file_control_cb(Tox *tox, uint32_t friend_number, uint32_t file_number, TOX_FILE_CONTROL control, void *user_data)
 {
     unused(tox);
     Events &events = *static_cast<Events *>(user_data);
-    auto msg = events.add_filecontrol();
-    msg->set_friendnumber(friend_number);
-    msg->set_filenumber(file_number);
+    event_writer msg(events, proto::CoreEvents::kFileControlFieldNumber, 0);
+    msg.uint32(proto::FileControl::kFriendNumberFieldNumber, friend_number);
+    msg.uint32(proto::FileControl::kFileNumberFieldNumber, file_number);
 
     using proto::FileControl;
     switch (control) {
         case TOX_FILE_CONTROL_RESUME:
-            msg->set_control(FileControl::RESUME);
+            msg.uint32(FileControl::kControlFieldNumber, FileControl::RESUME);
             break;
         case TOX_FILE_CONTROL_PAUSE:
-            msg->set_control(FileControl::PAUSE);
+            msg.uint32(FileControl::kControlFieldNumber, FileControl::PAUSE);
             break;
         case TOX_FILE_CONTROL_CANCEL:
-            msg->set_control(FileControl::CANCEL);
+            msg.uint32(FileControl::kControlFieldNumber, FileControl::CANCEL);
             break;
     }
 }
@@ -154,72 +153,81 @@ static void tox4j_file_request_chunk_cb(Tox *tox, uint32_t friend_number, uint32
 {
     unused(tox);
     Events &events = *static_cast<Events *>(user_data);
-    auto msg = events.add_filerequestchunk();
-    msg->set_friendnumber(friend_number);
-    msg->set_filenumber(file_number);
-    msg->set_position(position);
-    msg->set_length(length);
+    event_writer msg(events, proto::CoreEvents::kFileRequestChunkFieldNumber, 0);
+    msg.uint32(proto::FileRequestChunk::kFriendNumberFieldNumber, friend_number);
+    msg.uint32(proto::FileRequestChunk::kFileNumberFieldNumber, file_number);
+    msg.uint64(proto::FileRequestChunk::kPositionFieldNumber, position);
+    msg.uint32(proto::FileRequestChunk::kLengthFieldNumber, length);
 }
 
 static void tox4j_file_receive_cb(Tox *tox, uint32_t friend_number, uint32_t file_number, TOX_FILE_KIND kind, uint64_t file_size, uint8_t const *filename, size_t filename_length, void *user_data)
 {
     unused(tox);
     Events &events = *static_cast<Events *>(user_data);
-    auto msg = events.add_filereceive();
-    msg->set_friendnumber(friend_number);
-    msg->set_filenumber(file_number);
+    event_writer msg(events, proto::CoreEvents::kFileReceiveFieldNumber, filename_length);
+    msg.uint32(proto::FileReceive::kFriendNumberFieldNumber, friend_number);
+    msg.uint32(proto::FileReceive::kFileNumberFieldNumber, file_number);
 
     using proto::FileReceive;
     switch (kind) {
         case TOX_FILE_KIND_DATA:
-            msg->set_kind(FileReceive::DATA);
+            msg.uint32(FileReceive::kKindFieldNumber, FileReceive::DATA);
             break;
         case TOX_FILE_KIND_AVATAR:
-            msg->set_kind(FileReceive::AVATAR);
+            msg.uint32(FileReceive::kKindFieldNumber, FileReceive::AVATAR);
             break;
     }
 
-    msg->set_filesize(file_size);
-    msg->set_filename(filename, filename_length);
+    msg.uint64(FileReceive::kFileSizeFieldNumber, file_size);
+    msg.bytes(FileReceive::kFilenameFieldNumber, filename, filename_length);
 }
 
 static void tox4j_file_receive_chunk_cb(Tox *tox, uint32_t friend_number, uint32_t file_number, uint64_t position, uint8_t const *data, size_t length, void *user_data)
 {
     unused(tox);
     Events &events = *static_cast<Events *>(user_data);
-    auto msg = events.add_filereceivechunk();
-    msg->set_friendnumber(friend_number);
-    msg->set_filenumber(file_number);
-    msg->set_position(position);
-    msg->set_data(data, length);
+    event_writer msg(events, proto::CoreEvents::kFileReceiveChunkFieldNumber, length);
+    msg.uint32(proto::FileReceiveChunk::kFriendNumberFieldNumber, friend_number);
+    msg.uint32(proto::FileReceiveChunk::kFileNumberFieldNumber, file_number);
+    msg.uint64(proto::FileReceiveChunk::kPositionFieldNumber, position);
+    msg.bytes(proto::FileReceiveChunk::kDataFieldNumber, data, length);
+}
+
+static void tox4j_file_progress_cb(Tox *tox, uint32_t friend_number, uint32_t file_number, uint64_t position, void *user_data)
+{
+    unused(tox);
+    Events &events = *static_cast<Events *>(user_data);
+    event_writer msg(events, proto::CoreEvents::kFileProgressFieldNumber, 0);
+    msg.uint32(proto::FileProgress::kFriendNumberFieldNumber, friend_number);
+    msg.uint32(proto::FileProgress::kFileNumberFieldNumber, file_number);
+    msg.uint64(proto::FileProgress::kPositionFieldNumber, position);
 }
 
 static void tox4j_friend_lossy_packet_cb(Tox *tox, uint32_t friend_number, uint8_t const *data, size_t length, void *user_data)
 {
     unused(tox);
     Events &events = *static_cast<Events *>(user_data);
-    auto msg = events.add_friendlossypacket();
-    msg->set_friendnumber(friend_number);
-    msg->set_data(data, length);
+    event_writer msg(events, proto::CoreEvents::kFriendLossyPacketFieldNumber, length);
+    msg.uint32(proto::FriendLossyPacket::kFriendNumberFieldNumber, friend_number);
+    msg.bytes(proto::FriendLossyPacket::kDataFieldNumber, data, length);
 }
 
 static void tox4j_friend_lossless_packet_cb(Tox *tox, uint32_t friend_number, uint8_t const *data, size_t length, void *user_data)
 {
     unused(tox);
     Events &events = *static_cast<Events *>(user_data);
-    auto msg = events.add_friendlosslesspacket();
-    msg->set_friendnumber(friend_number);
-    msg->set_data(data, length);
+    event_writer msg(events, proto::CoreEvents::kFriendLosslessPacketFieldNumber, length);
+    msg.uint32(proto::FriendLosslessPacket::kFriendNumberFieldNumber, friend_number);
+    msg.bytes(proto::FriendLosslessPacket::kDataFieldNumber, data, length);
 }
 
 
-/*
- * Class:     im_tox_tox4jToxCoreImpl
- * Method:    toxNew
- * Signature: (ZZILjava/lang/String;I)I
- */
-JNIEXPORT jint JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxNew
-  (JNIEnv *env, jclass, jbyteArray saveData, jboolean ipv6Enabled, jboolean udpEnabled, jint proxyType, jstring proxyAddress, jint proxyPort)
+// Common part of toxNew and toxNewFromFile. The create function is called
+// with the options followed by args.
+template<typename CreateFunc, typename... Args>
+static jint
+tox4j_new(JNIEnv *env, jboolean ipv6Enabled, jboolean udpEnabled, jint proxyType, jstring proxyAddress, jint proxyPort,
+          CreateFunc create, Args... args)
 {
     assert(proxyType >= 0);
     assert(proxyPort >= 0);
@@ -249,8 +257,6 @@ JNIEXPORT jint JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxNew
     opts->proxy_address = proxy_address.data();
     opts->proxy_port = proxyPort;
 
-    ByteArray save_data(env, saveData);
-
     return with_error_handling(env, "New", [](TOX_ERR_NEW error) {
         switch (error) {
             success_case(NEW);
@@ -262,6 +268,7 @@ JNIEXPORT jint JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxNew
             failure_case(NEW, PROXY_NOT_FOUND);
             failure_case(NEW, LOAD_ENCRYPTED);
             failure_case(NEW, LOAD_BAD_FORMAT);
+            failure_case(NEW, LOAD_IO);
         }
         return unhandled();
     }, [env](Tox *tox_pointer) {
@@ -269,7 +276,7 @@ JNIEXPORT jint JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxNew
         assert(tox != nullptr);
 
         // Create the master events object.
-        std::unique_ptr<Events> events(new Events);
+        std::unique_ptr<Events> events(new Events(tox_traits::module));
 
         // Set up our callbacks.
         tox_callback_connection_status       (tox.get(), tox4j_connection_status_cb,        events.get());
@@ -286,6 +293,7 @@ JNIEXPORT jint JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxNew
         tox_callback_file_request_chunk      (tox.get(), tox4j_file_request_chunk_cb,       events.get());
         tox_callback_file_receive            (tox.get(), tox4j_file_receive_cb,             events.get());
         tox_callback_file_receive_chunk      (tox.get(), tox4j_file_receive_chunk_cb,       events.get());
+        tox_callback_file_progress           (tox.get(), tox4j_file_progress_cb,            events.get());
         tox_callback_friend_lossy_packet     (tox.get(), tox4j_friend_lossy_packet_cb,      events.get());
         tox_callback_friend_lossless_packet  (tox.get(), tox4j_friend_lossless_packet_cb,   events.get());
 
@@ -298,9 +306,36 @@ JNIEXPORT jint JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxNew
 
         // This call locks the instance manager.
         return CoreInstanceManager::self.add(std::move(instance));
-    }, tox_new, opts.get(), save_data.data(), save_data.size());
+    }, create, opts.get(), args...);
+}
+
+/*
+ * Class:     im_tox_tox4jToxCoreImpl
+ * Method:    toxNew
+ * Signature: ([BZZILjava/lang/String;I)I
+ */
+JNIEXPORT jint JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxNew
+  (JNIEnv *env, jclass, jbyteArray saveData, jboolean ipv6Enabled, jboolean udpEnabled, jint proxyType, jstring proxyAddress, jint proxyPort)
+{
+    ByteArray save_data(env, saveData);
+    return tox4j_new(env, ipv6Enabled, udpEnabled, proxyType, proxyAddress, proxyPort,
+                     tox_new, save_data.data(), save_data.size());
 }
 
+/*
+ * Class:     im_tox_tox4jToxCoreImpl
+ * Method:    toxNewFromFile
+ * Signature: (Ljava/lang/String;ZZILjava/lang/String;I)I
+ */
+JNIEXPORT jint JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxNewFromFile
+  (JNIEnv *env, jclass, jstring path, jboolean ipv6Enabled, jboolean udpEnabled, jint proxyType, jstring proxyAddress, jint proxyPort)
+{
+    UTFChars path_chars(env, path);
+    return tox4j_new(env, ipv6Enabled, udpEnabled, proxyType, proxyAddress, proxyPort,
+                     tox_new_from_file, path_chars.data());
+}
+
+
 /*
  * Class:     im_tox_tox4jToxCoreImpl
  * Method:    toxKill
@@ -331,7 +366,7 @@ JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxCoreImpl_finalize
 JNIEXPORT jbyteArray JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSave
   (JNIEnv *env, jclass, jint instanceNumber)
 {
-    return with_instance(env, instanceNumber, [=](Tox *tox, Events &events) {
+    return with_instance(env, instanceNumber, "Save", [=](Tox *tox, Events &events) {
         unused(events);
         std::vector<uint8_t> buffer(tox_save_size(tox));
         tox_save(tox, buffer.data());
@@ -339,3 +374,134 @@ JNIEXPORT jbyteArray JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSave
         return toJavaArray(env, buffer);
     });
 }
+
+/*
+ * Class:     im_tox_tox4jToxCoreImpl
+ * Method:    toxSaveFormatted
+ * Signature: (II)[B
+ */
+JNIEXPORT jbyteArray JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSaveFormatted
+  (JNIEnv *env, jclass, jint instanceNumber, jint format)
+{
+    assert(format >= 0);
+    assert(format <= TOX_SAVE_FORMAT_LZ4);
+    return with_instance(env, instanceNumber, "SaveFormatted", [=](Tox *tox, Events &events) {
+        unused(events);
+        std::vector<uint8_t> buffer(tox_save_formatted_size(tox, (TOX_SAVE_FORMAT) format));
+        buffer.resize(tox_save_formatted(tox, (TOX_SAVE_FORMAT) format, buffer.data()));
+
+        return toJavaArray(env, buffer);
+    });
+}
+
+/*
+ * Class:     im_tox_tox4jToxCoreImpl
+ * Method:    toxSetAutosave
+ * Signature: (ILjava/lang/String;I)V
+ */
+JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSetAutosave
+  (JNIEnv *env, jclass, jint instanceNumber, jstring path, jint minInterval)
+{
+    UTFChars pathChars(env, path);
+    return with_instance(env, instanceNumber, "SetAutosave", [](TOX_ERR_SET_AUTOSAVE error) {
+        switch (error) {
+            success_case(SET_AUTOSAVE);
+            failure_case(SET_AUTOSAVE, IO);
+        }
+        return unhandled();
+    }, [](bool) {
+    }, tox_set_autosave, pathChars.data(), minInterval);
+}
+
+/*
+ * Class:     im_tox_tox4jToxCoreImpl
+ * Method:    toxSetAutosaveFormat
+ * Signature: (II)V
+ */
+JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSetAutosaveFormat
+  (JNIEnv *env, jclass, jint instanceNumber, jint format)
+{
+    assert(format >= 0);
+    assert(format <= TOX_SAVE_FORMAT_LZ4);
+    return with_instance(env, instanceNumber, "SetAutosaveFormat", [=](Tox *tox, Events &events) {
+        unused(events);
+        tox_set_autosave_format(tox, (TOX_SAVE_FORMAT) format);
+    });
+}
+
+/*
+ * Class:     im_tox_tox4jToxCoreImpl
+ * Method:    toxGetAutosaveStats
+ * Signature: (I)[I
+ */
+JNIEXPORT jintArray JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxGetAutosaveStats
+  (JNIEnv *env, jclass, jint instanceNumber)
+{
+    return with_instance(env, instanceNumber, "GetAutosaveStats", [=](Tox *tox, Events &events) {
+        unused(events);
+        Tox_Autosave_Stats stats;
+        tox_get_autosave_stats(tox, &stats);
+
+        std::vector<uint32_t> values {
+            stats.saves,
+            stats.skipped,
+            stats.failures,
+            stats.last_latency,
+            stats.max_latency,
+        };
+        return toJavaArray(env, values);
+    });
+}
+
+/*
+ * Class:     im_tox_tox4jToxCoreImpl
+ * Method:    toxSetEventBudget
+ * Signature: (III)V
+ */
+JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSetEventBudget
+  (JNIEnv *env, jclass, jint instanceNumber, jint budget, jint overflow)
+{
+    assert(budget >= 0);
+    assert(overflow >= 0);
+    assert(overflow <= TOX_EVENT_OVERFLOW_DROP_LOSSY);
+    return with_instance(env, instanceNumber, "SetEventBudget", [=](Tox *tox, Events &events) {
+        unused(events);
+        tox_set_event_budget(tox, budget, (TOX_EVENT_OVERFLOW) overflow);
+    });
+}
+
+/*
+ * Class:     im_tox_tox4jToxCoreImpl
+ * Method:    toxGetEventBudgetStats
+ * Signature: (I)[J
+ */
+JNIEXPORT jlongArray JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxGetEventBudgetStats
+  (JNIEnv *env, jclass, jint instanceNumber)
+{
+    return with_instance(env, instanceNumber, "GetEventBudgetStats", [=](Tox *tox, Events &events) {
+        unused(events);
+        Tox_Event_Budget_Stats stats;
+        tox_get_event_budget_stats(tox, &stats);
+
+        std::vector<uint64_t> values {
+            stats.high_watermark,
+            stats.overflows,
+            stats.paused,
+            stats.dropped,
+        };
+        return toJavaArray(env, values);
+    });
+}
+
+/*
+ * Class:     im_tox_tox4jToxCoreImpl
+ * Method:    toxGetMemoryUsage
+ * Signature: (I)[J
+ */
+JNIEXPORT jlongArray JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxGetMemoryUsage
+  (JNIEnv *env, jclass, jint instanceNumber)
+{
+    return with_instance(env, instanceNumber, "GetMemoryUsage", [=](Tox *tox, Events &events) {
+        return toJavaArray(env, core_memory_usage(tox, events));
+    });
+}
@@ -0,0 +1,34 @@
+#include "ToxCore.h"
+
+/*
+ * Class:     im_tox_tox4jToxCoreImpl
+ * Method:    toxSetNativeStatsEnabled
+ * Signature: (Z)V
+ */
+JNIEXPORT void JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxSetNativeStatsEnabled
+  (JNIEnv *, jclass, jboolean enabled)
+{
+    set_native_stats_enabled(enabled);
+}
+
+/*
+ * Class:     im_tox_tox4jToxCoreImpl
+ * Method:    toxGetNativeStats
+ * Signature: ()[B
+ */
+JNIEXPORT jbyteArray JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxGetNativeStats
+  (JNIEnv *env, jclass)
+{
+    return toJavaArray(env, native_stats_snapshot());
+}
+
+/*
+ * Class:     im_tox_tox4jToxCoreImpl
+ * Method:    toxGetNativeMemoryUsage
+ * Signature: ()[J
+ */
+JNIEXPORT jlongArray JNICALL Java_im_tox_tox4j_ToxCoreImpl_toxGetNativeMemoryUsage
+  (JNIEnv *env, jclass)
+{
+    return toJavaArray(env, native_memory_usage());
+}
@@ -97,10 +97,16 @@ using java_array_t = typename java_array<typename std::make_signed<CType>::type>
 
 template<typename T>
 typename java_array_t<T>::array_type
-toJavaArray(JNIEnv *env, std::vector<T> const &data) {
+toJavaArray(JNIEnv *env, T const *data, size_t size) {
     typedef typename java_array_t<T>::java_type java_type;
     static_assert(sizeof(T) == sizeof(java_type), "Size requirements for Java array not met");
-    return java_array_t<T>::make(env, data.size(), reinterpret_cast<java_type const *>(data.data()));
+    return java_array_t<T>::make(env, size, reinterpret_cast<java_type const *>(data));
+}
+
+template<typename T>
+typename java_array_t<T>::array_type
+toJavaArray(JNIEnv *env, std::vector<T> const &data) {
+    return toJavaArray(env, data.data(), data.size());
 }
 
 #endif /* JNIUTIL_H */
\ No newline at end of file
@@ -0,0 +1,262 @@
+#include "autosave.h"
+#include "memory.h"
+#include "savedata.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+
+// FNV-1a over 64 bit words, with the high half folded down after each step
+// so that changes anywhere in a word reach all bits. Save data runs to
+// megabytes and is hashed with the instance locked, so we take eight bytes at
+// a time. We only need to recognise unchanged data, not resist collisions.
+static uint64_t
+hash (std::vector<uint8_t> const &data)
+{
+  uint64_t const prime = 0x100000001b3;
+  uint64_t hash = 0xcbf29ce484222325;
+
+  uint8_t const *bytes = data.data ();
+  size_t length = data.size ();
+  for (; length >= sizeof (uint64_t); bytes += sizeof (uint64_t), length -= sizeof (uint64_t))
+    {
+      uint64_t word;
+      std::memcpy (&word, bytes, sizeof word);
+      hash = (hash ^ word) * prime;
+      hash ^= hash >> 32;
+    }
+  for (; length != 0; bytes++, length--)
+    hash = (hash ^ *bytes) * prime;
+  return hash;
+}
+
+
+// Create a temporary file with a unique name next to path, so that we never
+// write to a file someone else left there. Returns its descriptor and stores
+// its name in tmp, or returns -1.
+static int
+create_temporary (std::string const &path, std::string &tmp)
+{
+  tmp = path + ".XXXXXX";
+  int fd = mkstemp (&tmp[0]);
+  if (fd != -1)
+    fcntl (fd, F_SETFD, FD_CLOEXEC);
+  return fd;
+}
+
+
+static std::string
+directory_of (std::string const &path)
+{
+  size_t slash = path.rfind ('/');
+  if (slash == std::string::npos)
+    return ".";
+  if (slash == 0)
+    return "/";
+  return path.substr (0, slash);
+}
+
+
+static bool
+write_all (int fd, uint8_t const *data, size_t length)
+{
+  while (length != 0)
+    {
+      ssize_t written = write (fd, data, length);
+      if (written == -1)
+        {
+          if (errno == EINTR)
+            continue;
+          return false;
+        }
+      data += written;
+      length -= written;
+    }
+  return true;
+}
+
+
+// Write data to a temporary file next to path, flush it to disk and rename
+// it over path. Either the old or the new save survives a crash.
+static bool
+write_atomically (std::string const &path, std::vector<uint8_t> const &data)
+{
+  std::string tmp;
+  int fd = create_temporary (path, tmp);
+  if (fd == -1)
+    return false;
+
+  if (!write_all (fd, data.data (), data.size ()) || fsync (fd) != 0)
+    {
+      close (fd);
+      unlink (tmp.c_str ());
+      return false;
+    }
+  if (close (fd) != 0 || rename (tmp.c_str (), path.c_str ()) != 0)
+    {
+      unlink (tmp.c_str ());
+      return false;
+    }
+
+  // Make the rename itself durable.
+  int dir = open (directory_of (path).c_str (), O_RDONLY | O_CLOEXEC);
+  if (dir != -1)
+    {
+      fsync (dir);
+      close (dir);
+    }
+  return true;
+}
+
+
+autosave_writer::~autosave_writer ()
+{
+  if (!writer.joinable ())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock (mutex);
+    stopping = true;
+  }
+  wakeup.notify_one ();
+  // The writer finishes a pending save before it exits.
+  writer.join ();
+}
+
+
+bool
+autosave_writer::configure (char const *path, uint32_t min_interval)
+{
+  if (path == nullptr)
+    {
+      this->path.clear ();
+      return true;
+    }
+
+  // Check that we can create a temporary file now, rather than failing
+  // silently on every save.
+  std::string tmp;
+  int fd = create_temporary (path, tmp);
+  if (fd == -1)
+    return false;
+  close (fd);
+  unlink (tmp.c_str ());
+
+  this->path = path;
+  this->min_interval = std::chrono::milliseconds (min_interval);
+  // Take the first snapshot right away.
+  last_snapshot = clock::time_point ();
+
+  std::lock_guard<std::mutex> lock (mutex);
+  // The new file doesn't have the last saved data yet.
+  has_hash = false;
+  if (!writer.joinable ())
+    writer = std::thread (&autosave_writer::run, this);
+  return true;
+}
+
+
+bool
+autosave_writer::due (clock::time_point now) const
+{
+  return enabled () && now - last_snapshot >= min_interval;
+}
+
+
+void
+autosave_writer::submit (std::vector<uint8_t> &data, clock::time_point now, bool compress)
+{
+  last_snapshot = now;
+  uint64_t data_hash = hash (data);
+
+  {
+    std::lock_guard<std::mutex> lock (mutex);
+    if (has_hash && data_hash == last_hash && compress == last_compress)
+      {
+        counters.skipped++;
+        return;
+      }
+    last_hash = data_hash;
+    last_compress = compress;
+    has_hash = true;
+
+    // If the writer hasn't picked up the previous snapshot yet, this one
+    // replaces it.
+    pending.swap (data);
+    pending_path = path;
+    pending_compress = compress;
+    has_pending = true;
+  }
+  wakeup.notify_one ();
+}
+
+
+autosave_writer::stats
+autosave_writer::get_stats () const
+{
+  std::lock_guard<std::mutex> lock (mutex);
+  return counters;
+}
+
+size_t
+autosave_writer::heap_size () const
+{
+  std::lock_guard<std::mutex> lock (mutex);
+  // The writer thread's own buffer is not visible here; while it is idle, it
+  // is about as large as the pending one.
+  return ::heap_size (path) + ::heap_size (pending_path) + 2 * ::heap_size (pending) + compressed_capacity;
+}
+
+
+void
+autosave_writer::run ()
+{
+  std::vector<uint8_t> data;
+  std::vector<uint8_t> compressed;
+  std::string target;
+
+  std::unique_lock<std::mutex> lock (mutex);
+  while (true)
+    {
+      wakeup.wait (lock, [this] { return stopping || has_pending; });
+      if (!has_pending)
+        break;
+
+      data.swap (pending);
+      target.swap (pending_path);
+      bool const compress = pending_compress;
+      has_pending = false;
+
+      lock.unlock ();
+      auto start = clock::now ();
+      if (compress)
+        {
+          compressed.resize (savedata_compressed_bound (data.size ()));
+          compressed.resize (savedata_compress (data.data (), data.size (), compressed.data ()));
+        }
+      bool success = write_atomically (target, compress ? compressed : data);
+      auto latency = std::chrono::duration_cast<std::chrono::microseconds> (clock::now () - start).count ();
+      lock.lock ();
+      compressed_capacity = compressed.capacity ();
+
+      if (success)
+        {
+          counters.saves++;
+          counters.last_latency = latency;
+          counters.max_latency = std::max (counters.max_latency, counters.last_latency);
+        }
+      else
+        {
+          counters.failures++;
+          // Write the same data again with the next snapshot.
+          has_hash = false;
+        }
+    }
+}
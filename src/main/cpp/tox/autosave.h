@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+// Periodically writes save data to a file on a background thread. The owner
+// takes snapshots on its own thread (with the instance locked) and submits
+// them. Snapshots identical to the last one are skipped, and the others are
+// compressed, if asked to, on the background thread. Each write goes to a
+// temporary file which is synced and then renamed over the target, so the
+// target always contains a complete save.
+struct autosave_writer
+{
+  typedef std::chrono::steady_clock clock;
+
+  struct stats
+  {
+    uint32_t saves = 0;
+    uint32_t skipped = 0;
+    uint32_t failures = 0;
+    // Time to compress, write, sync and rename a save, in microseconds.
+    uint32_t last_latency = 0;
+    uint32_t max_latency = 0;
+  };
+
+  autosave_writer () { }
+  ~autosave_writer ();
+
+  autosave_writer (autosave_writer const &) = delete;
+
+  // Set the target path and minimum interval between snapshots in
+  // milliseconds. A NULL path disables autosaving. Fails if the directory of
+  // the path is not writable.
+  bool configure (char const *path, uint32_t min_interval);
+
+  bool enabled () const { return !path.empty (); }
+
+  // Whether the owner should take a snapshot now.
+  bool due (clock::time_point now) const;
+
+  // Hand a snapshot of plain save data to the writer, to be written as is or
+  // in a compressed container. The contents of data are exchanged with a
+  // previously used buffer, so the caller can reuse it without allocating.
+  void submit (std::vector<uint8_t> &data, clock::time_point now, bool compress);
+
+  stats get_stats () const;
+
+  // Heap memory held by the writer's buffers, in bytes.
+  size_t heap_size () const;
+
+private:
+  void run ();
+
+  // Owner thread only.
+  std::string path;
+  std::chrono::milliseconds min_interval { 0 };
+  clock::time_point last_snapshot;
+
+  // Shared with the writer thread.
+  mutable std::mutex mutex;
+  std::condition_variable wakeup;
+  std::thread writer;
+  bool stopping = false;
+
+  // Of the plain data, and whether it was submitted for compression.
+  uint64_t last_hash = 0;
+  bool last_compress = false;
+  bool has_hash = false;
+
+  std::vector<uint8_t> pending;
+  std::string pending_path;
+  bool pending_compress = false;
+  bool has_pending = false;
+  // Capacity of the writer thread's compression buffer.
+  size_t compressed_capacity = 0;
+
+  stats counters;
+};
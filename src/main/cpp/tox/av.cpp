@@ -3,18 +3,85 @@
 
 #include <tox/toxav.h>
 
+#include "call_stats.h"
+#include "colorspace.h"
 #include "core_private.h"
+#include "mixer.h"
+#include "resampler.h"
+#include "scaler.h"
+#include "scheduler.h"
 
+#include <array>
+#include <chrono>
 #include <cstdio>
+#include <memory>
+
+
+// Audio format used for every call.
+static uint32_t const audio_sample_rate = 8000;
+static uint8_t const audio_channels = 1;
+static uint32_t const audio_frame_duration = 60;
+
+// Interval between two request_video_frame events of a call: 25 frames per
+// second.
+static uint32_t const video_frame_duration = 40;
+
+static_assert (TOXAV_LATENESS_BUCKETS == latency_buckets, "histogram sizes differ");
+
+// Marks toxav call indices without a call in the call table.
+static uint32_t const no_friend = UINT32_MAX;
+
+
+static bool
+is_sending_audio (TOXAV_CALL_STATE state)
+{
+  return state == TOXAV_CALL_STATE_SENDING_A
+      || state == TOXAV_CALL_STATE_SENDING_AV;
+}
+
+static bool
+is_sending_video (TOXAV_CALL_STATE state)
+{
+  return state == TOXAV_CALL_STATE_SENDING_V
+      || state == TOXAV_CALL_STATE_SENDING_AV;
+}
 
 
 struct av_call
 {
+  // Largest encoded audio frame we hand to toxav_send_audio.
+  static size_t const max_audio_frame_size = 1500;
+
   int32_t index;
   ToxAvCSettings settings = ToxAvCSettings ();
   TOXAV_CALL_STATE state = TOXAV_CALL_STATE_END;
-  bool audio_event_pending = false;
-  bool video_event_pending = false;
+  // Bumped whenever the call (re)starts its streams, which invalidates the
+  // scheduler entries of the previous ones.
+  uint32_t generation = 0;
+  new_ToxAV_Request_Stats request_stats = new_ToxAV_Request_Stats ();
+  stream_stats audio_quality;
+  stream_stats video_quality;
+
+  // Scratch space for the encoder, reused for every frame so that sending
+  // audio doesn't allocate.
+  std::array<uint8_t, max_audio_frame_size> audio_encode_buffer;
+
+  // Converts audio in other formats to the call settings. Converted samples
+  // wait here until there are enough for a whole frame.
+  audio_resampler resampler;
+  std::vector<int16_t> audio_pending;
+
+  // The outgoing video frame in I420, the frame downscaled to the call's
+  // maximum resolution if it was larger, and the encoder's output.
+  std::vector<uint8_t> video_frame;
+  video_scaler scaler;
+  std::vector<uint8_t> scaled_frame;
+  std::vector<uint8_t> video_encode_buffer;
+  new_ToxAV_Video_Send_Stats video_stats = new_ToxAV_Video_Send_Stats ();
+
+  // Received frames whose rows are padded are packed into I420 here.
+  std::vector<uint8_t> received_frame;
+  new_ToxAV_Video_Receive_Stats video_receive_stats = new_ToxAV_Video_Receive_Stats ();
 
   explicit av_call (int32_t call_index)
     : index (call_index)
@@ -27,8 +94,16 @@ struct new_ToxAV
 {
   ToxAv *av;
   new_Tox *tox;
-  std::map<int32_t, uint32_t> call_to_friend;
-  std::map<uint32_t, av_call> friend_to_call;
+  // Calls by friend number, and friend numbers by toxav call index. Both are
+  // small dense integers, so the tables are plain vectors. Calls are held by
+  // pointer so that references stay valid while the table grows.
+  std::vector<std::unique_ptr<av_call>> calls;
+  std::vector<uint32_t> call_friends;
+  frame_scheduler scheduler;
+  iteration_policy iteration;
+  audio_mixer mixer;
+  // Heap growth while toxav created the instance, for toxav_get_memory_usage.
+  size_t av_footprint = 0;
 
   struct
   {
@@ -40,36 +115,73 @@ struct new_ToxAV
     callback<toxav_receive_video_frame_cb> receive_video_frame;
   } callbacks;
 
+  av_call *find_call (uint32_t friend_number) const
+  {
+    if (friend_number >= calls.size ())
+      return nullptr;
+    return calls[friend_number].get ();
+  }
+
   av_call &get_call (uint32_t friend_number)
   {
-    auto found = friend_to_call.find (friend_number);
-    assert (found != friend_to_call.end ());
+    av_call *call = find_call (friend_number);
+    assert (call != nullptr);
+
+    return *call;
+  }
+
+  av_call &add_call (uint32_t friend_number, int32_t call_index)
+  {
+    assert (find_call (friend_number) == nullptr);
+    assert (call_index >= 0);
+
+    if (friend_number >= calls.size ())
+      calls.resize (friend_number + 1);
+    if (size_t (call_index) >= call_friends.size ())
+      call_friends.resize (call_index + 1, no_friend);
+
+    calls[friend_number].reset (new av_call (call_index));
+    call_friends[call_index] = friend_number;
+    return *calls[friend_number];
+  }
+
+  bool has_calls () const
+  {
+    for (auto const &call : calls)
+      if (call)
+        return true;
+    return false;
+  }
 
-    return found->second;
+  // Schedule the first request of each stream the call is sending.
+  void start_streams (uint32_t friend_number, av_call &call)
+  {
+    auto now = frame_scheduler::clock::now ();
+    call.generation++;
+    if (is_sending_audio (call.state))
+      scheduler.schedule ({ now, friend_number, call.generation, frame_scheduler::audio_stream });
+    if (is_sending_video (call.state))
+      scheduler.schedule ({ now, friend_number, call.generation, frame_scheduler::video_stream });
   }
 
   struct CB
   {
     static uint32_t get_friend_number (new_ToxAV *self, int32_t call_idx)
     {
-      auto found = self->call_to_friend.find (call_idx);
-      assert (found != self->call_to_friend.end ());
+      assert (call_idx >= 0 && size_t (call_idx) < self->call_friends.size ());
+      assert (self->call_friends[call_idx] != no_friend);
 
-      return found->second;
+      return self->call_friends[call_idx];
     }
 
     static void callstate_OnInvite (void *agent, int32_t call_idx, void *userdata)
     {
       auto self = static_cast<new_ToxAV *> (userdata);
 
-      auto found = self->call_to_friend.find (call_idx);
-      assert (found == self->call_to_friend.end ());
+      assert (size_t (call_idx) >= self->call_friends.size () || self->call_friends[call_idx] == no_friend);
 
       int peer_id = toxav_get_peer_id (self->av, call_idx, 0);
-      self->call_to_friend[call_idx] = peer_id;
-      self->friend_to_call.insert (std::make_pair (peer_id, av_call (call_idx)));
-
-      av_call &call = self->get_call (peer_id);
+      av_call &call = self->add_call (peer_id, call_idx);
 
       bool audio_enabled;
       bool video_enabled;
@@ -131,6 +243,7 @@ struct new_ToxAV
         }
       assert (call.state != state);
       call.state = state;
+      self->start_streams (friend_number, call);
 
       // Prepare codecs regardless of whether we're actually going to send
       // anything right now.
@@ -195,11 +308,21 @@ struct new_ToxAV
       uint32_t friend_number = get_friend_number (self, call_idx);
 
       av_call &call = self->get_call (friend_number);
+      call.audio_quality.on_received (stream_stats::clock::now ());
+
       ToxAvCSettings settings;
       toxav_get_peer_csettings (self->av, call.index, 0, &settings);
 
       size_t sample_count = settings.audio_channels * settings.audio_sample_rate * call.settings.audio_frame_duration / 1000;
 
+      // Conference participants' audio goes to the mixer instead of the
+      // client.
+      if (self->mixer.contains (friend_number))
+        {
+          self->mixer.push (friend_number, pcm, sample_count / settings.audio_channels, settings.audio_channels, settings.audio_sample_rate);
+          return;
+        }
+
       auto cb = self->callbacks.receive_audio_frame;
       cb.func (self, friend_number, pcm, sample_count, settings.audio_channels, settings.audio_sample_rate, cb.user_data);
     }
@@ -207,8 +330,51 @@ struct new_ToxAV
     static void video (void *agent, int32_t call_idx, vpx_image_t const *img, void *userdata)
     {
       auto self = static_cast<new_ToxAV *> (userdata);
-      assert (self != nullptr);
-      assert (false);
+      uint32_t friend_number = get_friend_number (self, call_idx);
+
+      av_call &call = self->get_call (friend_number);
+      auto &stats = call.video_receive_stats;
+      auto start = std::chrono::steady_clock::now ();
+      call.video_quality.on_received (start);
+
+      uint16_t const width = img->d_w;
+      uint16_t const height = img->d_h;
+      uint16_t const chroma_width = (width + img->x_chroma_shift) >> img->x_chroma_shift;
+      uint16_t const chroma_height = (height + img->y_chroma_shift) >> img->y_chroma_shift;
+
+      uint8_t const *y = img->planes[VPX_PLANE_Y];
+      uint8_t const *u = img->planes[VPX_PLANE_U];
+      uint8_t const *v = img->planes[VPX_PLANE_V];
+
+      // The decoder pads its rows. Unless it happens not to, pack the planes
+      // into the call's buffer, which only grows when the resolution does.
+      if (img->stride[VPX_PLANE_Y] != width
+          || img->stride[VPX_PLANE_U] != chroma_width
+          || img->stride[VPX_PLANE_V] != chroma_width)
+        {
+          size_t const luma = size_t (width) * height;
+          size_t const chroma = size_t (chroma_width) * chroma_height;
+          if (luma + 2 * chroma > call.received_frame.capacity ())
+            stats.buffer_allocations++;
+          call.received_frame.resize (luma + 2 * chroma);
+
+          uint8_t *frame = call.received_frame.data ();
+          copy_plane (y, img->stride[VPX_PLANE_Y], width, height, frame);
+          copy_plane (u, img->stride[VPX_PLANE_U], chroma_width, chroma_height, frame + luma);
+          copy_plane (v, img->stride[VPX_PLANE_V], chroma_width, chroma_height, frame + luma + chroma);
+          y = frame;
+          u = frame + luma;
+          v = frame + luma + chroma;
+        }
+
+      stats.frames++;
+      stats.last_copy_time = std::chrono::duration_cast<std::chrono::microseconds> (
+        std::chrono::steady_clock::now () - start).count ();
+      stats.max_copy_time = std::max (stats.max_copy_time, stats.last_copy_time);
+
+      // VP8 has no alpha channel.
+      auto cb = self->callbacks.receive_video_frame;
+      cb.func (self, friend_number, width, height, y, u, v, nullptr, cb.user_data);
     }
   };
 
@@ -228,6 +394,8 @@ struct new_ToxAV
     toxav_register_callstate_callback (av, CB::callstate_OnSelfCSChange, av_OnSelfCSChange, this);
     toxav_register_audio_callback (av, CB::audio, this);
     toxav_register_video_callback (av, CB::video, this);
+
+    mixer.configure (audio_sample_rate, audio_channels, audio_frame_duration);
   }
 };
 
@@ -247,6 +415,7 @@ new_toxav_new (new_Tox *tox, TOXAV_ERR_NEW *error)
       return nullptr;
     }
 
+  size_t const heap_before = heap_in_use ();
   ToxAv *av = toxav_new (tox->tox, tox_count_friendlist (tox->tox) * 2 + 100);
   if (!av)
     {
@@ -257,7 +426,9 @@ new_toxav_new (new_Tox *tox, TOXAV_ERR_NEW *error)
   tox->has_av = true;
 
   if (error) *error = TOXAV_ERR_NEW_MALLOC;
-  return new new_ToxAV (av, tox);
+  new_ToxAV *new_av = new new_ToxAV (av, tox);
+  new_av->av_footprint = std::max (heap_in_use (), heap_before) - heap_before;
+  return new_av;
 }
 
 void
@@ -279,7 +450,49 @@ new_toxav_get_tox (new_ToxAV *av)
 uint32_t
 new_toxav_iteration_interval (new_ToxAV const *av)
 {
-  return toxav_do_interval (av->av);
+  uint32_t interval = av->iteration.interval (toxav_do_interval (av->av), false);
+  if (av->scheduler.empty ())
+    return interval;
+
+  // Wake up for the next frame deadline. Rounding up costs at most a
+  // millisecond of lateness, rounding down would make the client spin until
+  // the deadline.
+  auto until = av->scheduler.next_due () - frame_scheduler::clock::now ();
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds> (until + std::chrono::milliseconds (1) - std::chrono::nanoseconds (1)).count ();
+  return std::min (interval, uint32_t (std::max (ms, decltype (ms) (0))));
+}
+
+bool
+new_toxav_set_max_iteration_interval (new_ToxAV *av, uint32_t max_interval)
+{
+  return av->iteration.set_max_interval (max_interval);
+}
+
+bool
+new_toxav_iteration_due (new_ToxAV const *av)
+{
+  return av->iteration.due (new_toxav_iteration_interval (av));
+}
+
+uint32_t
+new_toxav_iteration_wakeups (new_ToxAV const *av)
+{
+  return av->iteration.last_wakeups_per_second ();
+}
+
+static void
+record_request (new_ToxAV_Request_Stats &stats, bool video, uint32_t skipped, frame_scheduler::clock::duration lateness)
+{
+  if (video)
+    stats.video_requests++;
+  else
+    stats.audio_requests++;
+  stats.skipped_deadlines += skipped;
+
+  uint32_t const micros = std::chrono::duration_cast<std::chrono::microseconds> (lateness).count ();
+  stats.max_lateness = std::max (stats.max_lateness, micros);
+
+  stats.lateness[latency_bucket (micros)]++;
 }
 
 void
@@ -287,38 +500,61 @@ new_toxav_iteration (new_ToxAV *av)
 {
   toxav_do (av->av);
 
-  // For all active calls transfers that we didn't invoke a request_*_frame
-  // event for, do so now.
-  for (auto &pair : av->friend_to_call)
+  // Issue every frame request whose deadline has passed, and schedule the
+  // stream's next one.
+  auto now = frame_scheduler::clock::now ();
+  frame_scheduler::entry request;
+  while (av->scheduler.pop_due (now, request))
     {
-      uint32_t friend_number = pair.first;
-      av_call &call = pair.second;
+      av_call *call = av->find_call (request.friend_number);
+      if (!call || call->generation != request.generation)
+        continue;
 
-      switch (call.state)
+      bool const video = request.kind == frame_scheduler::video_stream;
+      if (video ? !is_sending_video (call->state) : !is_sending_audio (call->state))
+        continue;
+
+      frame_scheduler::clock::duration const period = std::chrono::milliseconds (
+        video ? video_frame_duration : std::max<uint32_t> (call->settings.audio_frame_duration, 1));
+
+      // If the client iterated so late that further deadlines have passed,
+      // skip them rather than firing a burst of requests.
+      auto const lateness = now - request.due;
+      auto const skipped = lateness / period;
+      record_request (call->request_stats, video, skipped, lateness);
+      stream_stats &quality = video ? call->video_quality : call->audio_quality;
+      quality.on_skipped (skipped);
+
+      request.due += (skipped + 1) * period;
+      av->scheduler.schedule (request);
+
+      if (video)
         {
-        case TOXAV_CALL_STATE_SENDING_V:
-        case TOXAV_CALL_STATE_SENDING_AV:
-          if (!call.video_event_pending)
-            {
-              auto cb = av->callbacks.request_video_frame;
-              cb.func (av, friend_number, cb.user_data);
-              call.video_event_pending = true;
-              if (call.state == TOXAV_CALL_STATE_SENDING_V)
-                break;
-            }
-        case TOXAV_CALL_STATE_SENDING_A:
-          if (!call.audio_event_pending)
-            {
-              auto cb = av->callbacks.request_audio_frame;
-              cb.func (av, friend_number, cb.user_data);
-              call.audio_event_pending = true;
-              break;
-            }
-        default:
-          // Do nothing in the other states.
-          break;
+          quality.on_request (now);
+          auto cb = av->callbacks.request_video_frame;
+          cb.func (av, request.friend_number, cb.user_data);
+        }
+      // The mixer supplies audio for conference participants.
+      else if (!av->mixer.contains (request.friend_number))
+        {
+          quality.on_request (now);
+          auto cb = av->callbacks.request_audio_frame;
+          cb.func (av, request.friend_number, cb.user_data);
         }
     }
+
+  av->mixer.mix (audio_mixer::clock::now (),
+                 [av] (uint32_t friend_number, int16_t const *pcm, size_t frame_size, uint8_t channels, uint32_t sampling_rate)
+    {
+      av_call const *call = av->find_call (friend_number);
+      if (!call || !is_sending_audio (call->state))
+        return;
+      new_toxav_send_audio_frame (av, friend_number, pcm, frame_size, channels, sampling_rate, nullptr);
+    });
+
+  // Any call, even one that is only ringing, keeps the interval from being
+  // stretched.
+  av->iteration.iterated (toxav_do_interval (av->av), !av->has_calls ());
 }
 
 static ToxAvCSettings
@@ -330,9 +566,9 @@ make_settings (uint32_t audio_bit_rate, uint32_t video_bit_rate)
     {
       settings.call_type = av_TypeAudio;
       settings.audio_bitrate = audio_bit_rate * 1000;
-      settings.audio_frame_duration = 60;
-      settings.audio_sample_rate = 8000;
-      settings.audio_channels = 1;
+      settings.audio_frame_duration = audio_frame_duration;
+      settings.audio_sample_rate = audio_sample_rate;
+      settings.audio_channels = audio_channels;
     }
   if (video_bit_rate != 0)
     {
@@ -350,7 +586,7 @@ new_toxav_call (new_ToxAV *av, uint32_t friend_number, uint32_t audio_bit_rate,
 {
   auto settings = make_settings (audio_bit_rate, video_bit_rate);
 
-  assert (av->friend_to_call.find (friend_number) == av->friend_to_call.end ());
+  assert (av->find_call (friend_number) == nullptr);
 
   int call_index;
   if (int result = toxav_call (av->av, &call_index, friend_number, &settings, 0x7fffffff))
@@ -359,12 +595,9 @@ new_toxav_call (new_ToxAV *av, uint32_t friend_number, uint32_t audio_bit_rate,
       assert (false);
     }
 
-  av_call call (call_index);
+  av_call &call = av->add_call (friend_number, call_index);
   call.settings = settings;
 
-  av->call_to_friend[call_index] = friend_number;
-  av->friend_to_call.insert (std::make_pair (friend_number, call));
-
   if (error) *error = TOXAV_ERR_CALL_OK;
   return true;
 }
@@ -378,14 +611,14 @@ new_toxav_callback_call (new_ToxAV *av, toxav_call_cb *function, void *user_data
 bool
 new_toxav_answer (new_ToxAV *av, uint32_t friend_number, uint32_t audio_bit_rate, uint32_t video_bit_rate, TOXAV_ERR_ANSWER *error)
 {
-  auto found = av->friend_to_call.find (friend_number);
-  if (found == av->friend_to_call.end ())
+  av_call *found = av->find_call (friend_number);
+  if (!found)
     {
       if (error) *error = TOXAV_ERR_ANSWER_FRIEND_NOT_CALLING;
       return false;
     }
 
-  av_call &call = found->second;
+  av_call &call = *found;
 
   auto settings = make_settings (audio_bit_rate, video_bit_rate);
   call.settings = settings;
@@ -430,14 +663,163 @@ new_toxav_callback_request_video_frame (new_ToxAV *av, toxav_request_video_frame
   av->callbacks.request_video_frame = { function, user_data };
 }
 
+// Find the call a video frame is sent on, and make room for the frame in
+// I420. Returns NULL on error.
+static av_call *
+prepare_video_frame (new_ToxAV *av, uint32_t friend_number, uint16_t width, uint16_t height, TOXAV_ERR_SEND_FRAME *error)
+{
+  if (width == 0 || height == 0 || width % 2 != 0 || height % 2 != 0)
+    {
+      if (error) *error = TOXAV_ERR_SEND_FRAME_INVALID;
+      return nullptr;
+    }
+
+  if (!tox_friend_exists (av->tox->tox, friend_number))
+    {
+      if (error) *error = TOXAV_ERR_SEND_FRAME_FRIEND_NOT_FOUND;
+      return nullptr;
+    }
+
+  av_call *call = av->find_call (friend_number);
+  if (!call || !is_sending_video (call->state))
+    {
+      if (error) *error = TOXAV_ERR_SEND_FRAME_FRIEND_NOT_IN_CALL;
+      return nullptr;
+    }
+
+  call->video_frame.resize (size_t (width) * height * 3 / 2);
+  return call;
+}
+
+typedef std::chrono::steady_clock video_clock;
+
+static uint32_t
+microseconds_between (video_clock::time_point start, video_clock::time_point end)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds> (end - start).count ();
+}
+
+// Downscale the converted frame if it exceeds the call's maximum resolution,
+// then encode and send it. The conversion started at start.
+static bool
+encode_video_frame (new_ToxAV *av, av_call &call, uint16_t width, uint16_t height,
+                    video_clock::time_point start, TOXAV_ERR_SEND_FRAME *error)
+{
+  auto &stats = call.video_stats;
+  auto converted = video_clock::now ();
+
+  uint8_t *frame = call.video_frame.data ();
+  uint16_t out_width, out_height;
+  video_scaler::fit (width, height, call.settings.max_video_width, call.settings.max_video_height,
+                     out_width, out_height);
+  if (out_width != width || out_height != height)
+    {
+      call.scaled_frame.resize (size_t (out_width) * out_height * 3 / 2);
+      call.scaler.scale_i420 (frame, width, height, call.scaled_frame.data (), out_width, out_height);
+      frame = call.scaled_frame.data ();
+    }
+  auto scaled = video_clock::now ();
+
+  vpx_image_t image;
+  vpx_img_wrap (&image, VPX_IMG_FMT_I420, out_width, out_height, 1, frame);
+
+  // An encoded frame is practically never larger than the raw frame.
+  auto &dest = call.video_encode_buffer;
+  dest.resize (size_t (out_width) * out_height * 3 / 2);
+  int result = toxav_prepare_video_frame (av->av, call.index, dest.data (), dest.size (), &image);
+  if (result <= 0)
+    {
+      if (error) *error = TOXAV_ERR_SEND_FRAME_INVALID;
+      return false;
+    }
+  auto encoded = video_clock::now ();
+  if (toxav_send_video (av->av, call.index, dest.data (), result) < 0)
+    assert (false);
+
+  call.video_quality.on_sent (encoded, result, encoded - scaled);
+
+  stats.frames++;
+  if (frame != call.video_frame.data ())
+    stats.scaled_frames++;
+  stats.last_convert_time = microseconds_between (start, converted);
+  stats.last_scale_time = microseconds_between (converted, scaled);
+  stats.last_encode_time = microseconds_between (scaled, encoded);
+  stats.max_convert_time = std::max (stats.max_convert_time, stats.last_convert_time);
+  stats.max_scale_time = std::max (stats.max_scale_time, stats.last_scale_time);
+  stats.max_encode_time = std::max (stats.max_encode_time, stats.last_encode_time);
+
+  if (error) *error = TOXAV_ERR_SEND_FRAME_OK;
+  return true;
+}
+
 bool
 new_toxav_send_video_frame (new_ToxAV *av, uint32_t friend_number,
                             uint16_t width, uint16_t height,
                             uint8_t const *y, uint8_t const *u, uint8_t const *v, uint8_t const *a,
                             TOXAV_ERR_SEND_FRAME *error)
 {
-  assert (false);
-  return false;
+  if (!y || !u || !v)
+    {
+      if (error) *error = TOXAV_ERR_SEND_FRAME_NULL;
+      return false;
+    }
+
+  av_call *call = prepare_video_frame (av, friend_number, width, height, error);
+  if (!call)
+    return false;
+
+  auto start = video_clock::now ();
+
+  // The encoder has no alpha channel, so a is ignored.
+  size_t const luma = size_t (width) * height;
+  uint8_t *frame = call->video_frame.data ();
+  i444_to_i420 (y, u, v, width, height, frame, frame + luma, frame + luma + luma / 4);
+
+  return encode_video_frame (av, *call, width, height, start, error);
+}
+
+bool
+new_toxav_send_video_frame_packed (new_ToxAV *av, uint32_t friend_number,
+                                   uint16_t width, uint16_t height,
+                                   TOXAV_VIDEO_FORMAT format, uint8_t const *data,
+                                   TOXAV_ERR_SEND_FRAME *error)
+{
+  if (!data)
+    {
+      if (error) *error = TOXAV_ERR_SEND_FRAME_NULL;
+      return false;
+    }
+
+  av_call *call = prepare_video_frame (av, friend_number, width, height, error);
+  if (!call)
+    return false;
+
+  auto start = video_clock::now ();
+
+  size_t const luma = size_t (width) * height;
+  uint8_t *y = call->video_frame.data ();
+  uint8_t *u = y + luma;
+  uint8_t *v = u + luma / 4;
+  switch (format)
+    {
+    case TOXAV_VIDEO_FORMAT_NV21:
+      nv21_to_i420 (data, width, height, y, u, v);
+      break;
+    case TOXAV_VIDEO_FORMAT_NV12:
+      nv12_to_i420 (data, width, height, y, u, v);
+      break;
+    case TOXAV_VIDEO_FORMAT_RGBA:
+      rgba_to_i420 (data, width, height, y, u, v);
+      break;
+    case TOXAV_VIDEO_FORMAT_BGRA:
+      bgra_to_i420 (data, width, height, y, u, v);
+      break;
+    default:
+      if (error) *error = TOXAV_ERR_SEND_FRAME_INVALID;
+      return false;
+    }
+
+  return encode_video_frame (av, *call, width, height, start, error);
 }
 
 void
@@ -446,6 +828,21 @@ new_toxav_callback_request_audio_frame (new_ToxAV *av, toxav_request_audio_frame
   av->callbacks.request_audio_frame = { function, user_data };
 }
 
+static void
+encode_audio_frame (new_ToxAV *av, av_call &call, int16_t const *pcm, size_t frame_size)
+{
+  auto &dest = call.audio_encode_buffer;
+  auto start = stream_stats::clock::now ();
+  int result = toxav_prepare_audio_frame (av->av, call.index, dest.data (), dest.size (), pcm, frame_size);
+  if (result <= 0)
+    assert (false);
+  auto encoded = stream_stats::clock::now ();
+  if (toxav_send_audio (av->av, call.index, dest.data (), result) < 0)
+    assert (false);
+
+  call.audio_quality.on_sent (encoded, result, encoded - start);
+}
+
 bool
 new_toxav_send_audio_frame (new_ToxAV *av, uint32_t friend_number,
                             int16_t const *pcm,
@@ -454,19 +851,44 @@ new_toxav_send_audio_frame (new_ToxAV *av, uint32_t friend_number,
                             uint32_t sampling_rate,
                             TOXAV_ERR_SEND_FRAME *error)
 {
+  if (!pcm)
+    {
+      if (error) *error = TOXAV_ERR_SEND_FRAME_NULL;
+      return false;
+    }
+
+  if (sample_count == 0 || channels == 0 || sampling_rate == 0)
+    {
+      if (error) *error = TOXAV_ERR_SEND_FRAME_INVALID;
+      return false;
+    }
+
   av_call &call = av->get_call (friend_number);
-  assert (sample_count == sampling_rate * channels * call.settings.audio_frame_duration / 1000);
-  assert (channels == call.settings.audio_channels);
-  assert (sampling_rate == call.settings.audio_sample_rate);
+  size_t const frame_size = call.settings.audio_sample_rate * call.settings.audio_frame_duration / 1000;
+  uint8_t const frame_channels = call.settings.audio_channels;
 
-  std::vector<uint8_t> dest (1500);
-  int result = toxav_prepare_audio_frame (av->av, call.index, dest.data (), dest.size (), (int16_t const *) pcm, sample_count * channels);
-  if (result <= 0)
-    assert (false);
-  if (toxav_send_audio (av->av, call.index, dest.data(), result) < 0)
-    assert (false);
+  if (sampling_rate == call.settings.audio_sample_rate
+      && channels == frame_channels
+      && sample_count == frame_size
+      && call.audio_pending.empty ())
+    {
+      // Already in the call format: encode straight from the caller's buffer.
+      encode_audio_frame (av, call, pcm, frame_size);
+    }
+  else
+    {
+      call.resampler.configure (sampling_rate, channels, call.settings.audio_sample_rate, frame_channels);
+      call.resampler.process (pcm, sample_count, call.audio_pending);
 
-  call.audio_event_pending = false;
+      size_t const frame_length = frame_size * frame_channels;
+      size_t offset = 0;
+      while (call.audio_pending.size () - offset >= frame_length)
+        {
+          encode_audio_frame (av, call, call.audio_pending.data () + offset, frame_size);
+          offset += frame_length;
+        }
+      call.audio_pending.erase (call.audio_pending.begin (), call.audio_pending.begin () + offset);
+    }
 
   if (error) *error = TOXAV_ERR_SEND_FRAME_OK;
   return true;
@@ -478,8 +900,96 @@ new_toxav_callback_receive_video_frame (new_ToxAV *av, toxav_receive_video_frame
   av->callbacks.receive_video_frame = { function, user_data };
 }
 
+static void
+fill_stream_stats (stream_stats const &quality, uint32_t configured_bit_rate, new_ToxAV_Stream_Stats &stats)
+{
+  stats.frames_requested = quality.requested;
+  stats.frames_sent = quality.sent;
+  stats.frames_received = quality.received;
+  stats.frames_dropped = quality.dropped;
+  stats.encode_time_average = quality.sent == 0 ? 0 : quality.encode_time_total / quality.sent;
+  stats.encode_time_max = quality.encode_time_max;
+  stats.bit_rate = quality.bit_rate;
+  stats.configured_bit_rate = configured_bit_rate;
+  stats.jitter = quality.jitter;
+  stats.send_latency_max = quality.send_latency_max;
+  std::copy (std::begin (quality.send_latency), std::end (quality.send_latency), stats.send_latency);
+}
+
+bool
+new_toxav_get_call_stats (new_ToxAV const *av, uint32_t friend_number,
+                          struct new_ToxAV_Call_Stats *stats,
+                          TOXAV_ERR_CALL_STATS *error)
+{
+  av_call const *call = av->find_call (friend_number);
+  if (!call)
+    {
+      if (error) *error = TOXAV_ERR_CALL_STATS_FRIEND_NOT_IN_CALL;
+      return false;
+    }
+
+  stats->video_send = call->video_stats;
+  stats->video_receive = call->video_receive_stats;
+  stats->requests = call->request_stats;
+  // The settings hold the audio bit rate in bit/s and the video bit rate in
+  // kbit/s.
+  fill_stream_stats (call->audio_quality, call->settings.audio_bitrate / 1000, stats->audio);
+  fill_stream_stats (call->video_quality, call->settings.video_bitrate, stats->video);
+  if (error) *error = TOXAV_ERR_CALL_STATS_OK;
+  return true;
+}
+
+void
+new_toxav_get_memory_usage (new_ToxAV const *av, struct new_ToxAV_Memory_Usage *usage)
+{
+  usage->av_estimate = av->av_footprint;
+
+  usage->calls = 0;
+  for (auto const &call : av->calls)
+    if (call)
+      usage->calls += sizeof (av_call) + call->resampler.heap_size () + call->scaler.heap_size ()
+                    + heap_size (call->audio_pending) + heap_size (call->video_frame)
+                    + heap_size (call->scaled_frame) + heap_size (call->video_encode_buffer)
+                    + heap_size (call->received_frame);
+
+  usage->mixing = av->scheduler.heap_size () + av->mixer.heap_size ();
+  usage->instance = sizeof (new_ToxAV) + heap_size (av->calls) + heap_size (av->call_friends);
+}
+
 void
 new_toxav_callback_receive_audio_frame (new_ToxAV *av, toxav_receive_audio_frame_cb *function, void *user_data)
 {
   av->callbacks.receive_audio_frame = { function, user_data };
 }
+
+bool
+new_toxav_mixer_add_friend (new_ToxAV *av, uint32_t friend_number, TOXAV_ERR_MIXER *error)
+{
+  if (!tox_friend_exists (av->tox->tox, friend_number))
+    {
+      if (error) *error = TOXAV_ERR_MIXER_FRIEND_NOT_FOUND;
+      return false;
+    }
+
+  if (!av->mixer.add (friend_number))
+    {
+      if (error) *error = TOXAV_ERR_MIXER_ALREADY_MIXED;
+      return false;
+    }
+
+  if (error) *error = TOXAV_ERR_MIXER_OK;
+  return true;
+}
+
+bool
+new_toxav_mixer_remove_friend (new_ToxAV *av, uint32_t friend_number, TOXAV_ERR_MIXER *error)
+{
+  if (!av->mixer.remove (friend_number))
+    {
+      if (error) *error = TOXAV_ERR_MIXER_NOT_MIXED;
+      return false;
+    }
+
+  if (error) *error = TOXAV_ERR_MIXER_OK;
+  return true;
+}
@@ -82,6 +82,8 @@ Tox *toxav_get_tox(ToxAV *av);
 /**
  * Returns the interval in milliseconds when the next toxav_iteration should be
  * called. If no call is active at the moment, this function returns 200.
+ * While calls are sending, the interval ends no earlier than the next frame
+ * request deadline.
  */
 uint32_t toxav_iteration_interval(ToxAV const *av);
 
@@ -93,6 +95,30 @@ uint32_t toxav_iteration_interval(ToxAV const *av);
  */
 void toxav_iteration(ToxAV *av);
 
+/**
+ * Set the upper bound in milliseconds for toxav_iteration_interval().
+ *
+ * While any call is sending audio or video, the interval is kept short. When
+ * there are no calls at all, it is doubled on every iteration until it reaches
+ * this cap. The default cap is 1000 milliseconds.
+ *
+ * @return false, leaving the cap unchanged, if max_interval is below
+ *   TOX_MIN_ITERATION_INTERVAL.
+ */
+bool toxav_set_max_iteration_interval(ToxAV *av, uint32_t max_interval);
+
+/**
+ * Return whether toxav_iteration_interval() milliseconds have passed since the
+ * end of the last toxav_iteration.
+ */
+bool toxav_iteration_due(ToxAV const *av);
+
+/**
+ * Return the number of times toxav_iteration was called during the last
+ * complete one-second window.
+ */
+uint32_t toxav_iteration_wakeups(ToxAV const *av);
+
 
 /*******************************************************************************
  *
@@ -421,6 +447,10 @@ typedef enum TOXAV_ERR_SEND_FRAME {
 /**
  * The function type for the `request_video_frame` callback.
  *
+ * While a call is sending video, this event is emitted once per video frame
+ * interval of 40 milliseconds (25 frames per second), from the toxav_iteration
+ * following each deadline.
+ *
  * @param friend_number The friend number of the friend for which the next video
  *   frame should be sent.
  */
@@ -438,7 +468,9 @@ void toxav_callback_request_video_frame(ToxAV *av, toxav_request_video_frame_cb
  * This is called in response to receiving the `request_video_frame` event.
  *
  * Each plane should contain (width * height) pixels. The Alpha plane can be
- * NULL, in which case every pixel is assumed fully opaque.
+ * NULL, in which case every pixel is assumed fully opaque. The chroma planes
+ * are averaged over 2x2 blocks for the encoder, which also has no use for the
+ * Alpha plane. Width and height must be even.
  *
  * @param friend_number The friend number of the friend to which to send a video
  *   frame.
@@ -455,9 +487,100 @@ bool toxav_send_video_frame(ToxAV *av, uint32_t friend_number,
                             TOXAV_ERR_SEND_FRAME *error);
 
 
+/**
+ * Pixel formats accepted by toxav_send_video_frame_packed.
+ */
+typedef enum TOXAV_VIDEO_FORMAT {
+  /**
+   * Y plane followed by interleaved V and U at half resolution, as produced by
+   * Android cameras. (width * height * 3 / 2) bytes.
+   */
+  TOXAV_VIDEO_FORMAT_NV21,
+  /**
+   * Like NV21, but with U before V in each chroma pair.
+   */
+  TOXAV_VIDEO_FORMAT_NV12,
+  /**
+   * 4 bytes per pixel: red, green, blue, and an ignored alpha byte.
+   * (width * height * 4) bytes.
+   */
+  TOXAV_VIDEO_FORMAT_RGBA,
+  /**
+   * Like RGBA, with blue and red swapped, as produced by most desktop capture
+   * APIs.
+   */
+  TOXAV_VIDEO_FORMAT_BGRA
+} TOXAV_VIDEO_FORMAT;
+
+/**
+ * Send a video frame in a packed or semi-planar format to a friend.
+ *
+ * The frame is converted to the encoder's planar format natively. Rows are
+ * tightly packed. Width and height must be even.
+ *
+ * @see toxav_send_video_frame for the error codes.
+ */
+bool toxav_send_video_frame_packed(ToxAV *av, uint32_t friend_number,
+                                   uint16_t width, uint16_t height,
+                                   TOXAV_VIDEO_FORMAT format, uint8_t const *data,
+                                   TOXAV_ERR_SEND_FRAME *error);
+
+
+/**
+ * Per-call counters for the video send path. Frames larger than the call's
+ * maximum resolution are downscaled to fit, keeping their aspect ratio, before
+ * they are encoded. Times are in microseconds and cover the conversion to the
+ * encoder's format, the downscaling and the encoding of a single frame.
+ */
+struct ToxAV_Video_Send_Stats {
+  /**
+   * Number of video frames sent in this call.
+   */
+  uint32_t frames;
+
+  /**
+   * Number of those frames that had to be downscaled.
+   */
+  uint32_t scaled_frames;
+
+  /**
+   * Conversion time of the last frame.
+   */
+  uint32_t last_convert_time;
+
+  /**
+   * Downscaling time of the last frame, 0 if it was not scaled.
+   */
+  uint32_t last_scale_time;
+
+  /**
+   * Encoding time of the last frame.
+   */
+  uint32_t last_encode_time;
+
+  /**
+   * Highest conversion time of any frame.
+   */
+  uint32_t max_convert_time;
+
+  /**
+   * Highest downscaling time of any frame.
+   */
+  uint32_t max_scale_time;
+
+  /**
+   * Highest encoding time of any frame.
+   */
+  uint32_t max_encode_time;
+};
+
+
 /**
  * The function type for the `request_audio_frame` callback.
  *
+ * While a call is sending audio, this event is emitted once per audio frame
+ * duration, from the toxav_iteration following each deadline.
+ *
  * @param friend_number The friend number of the friend for which the next audio
  *   frame should be sent.
  */
@@ -480,18 +603,22 @@ void toxav_callback_request_audio_frame(ToxAV *av, toxav_request_audio_frame_cb
  * this means the expected format is LRLRLR... with samples for left and right
  * alternating.
  *
+ * Audio in a different sampling rate or channel count than the call uses is
+ * resampled and mixed before encoding. Frames need not match the call's frame
+ * length: samples are buffered until a whole frame can be encoded, so a single
+ * call may send no frame or several.
+ *
  * @param friend_number The friend number of the friend to which to send an
  *   audio frame.
  * @param pcm An array of audio samples. The size of this array must be
  *   sample_count * channels.
- * @param sample_count Number of samples in this frame. Valid numbers here are
- *   ((sample rate) * (audio length) / 1000), where audio length can be
- *   2.5, 5, 10, 20, 40 or 60 millseconds.
+ * @param sample_count Number of samples per channel in this frame. Must be
+ *   at least 1.
  * @param channels Number of audio channels. Must be at least 1 for mono.
  *   For voice over IP, more than 2 channels (stereo) typically doesn't make
  *   sense, but up to 255 channels are supported.
- * @param sampling_rate Audio sampling rate used in this frame. Valid sampling
- *   rates are 8000, 12000, 16000, 24000, or 48000.
+ * @param sampling_rate Audio sampling rate used in this frame, in Hz. Any
+ *   non-zero rate is accepted.
  */
 bool toxav_send_audio_frame(ToxAV *av, uint32_t friend_number,
                             int16_t const *pcm,
@@ -501,6 +628,47 @@ bool toxav_send_audio_frame(ToxAV *av, uint32_t friend_number,
                             TOXAV_ERR_SEND_FRAME *error);
 
 
+#define TOXAV_LATENESS_BUCKETS		8
+
+/**
+ * Per-call counters for the frame request events. Each request is issued by
+ * the first toxav_iteration after its deadline, so its lateness depends on how
+ * punctually the client follows toxav_iteration_interval. Lateness is in
+ * microseconds.
+ */
+struct ToxAV_Request_Stats {
+  /**
+   * Number of `request_audio_frame` deadlines passed. Deadlines of conference
+   * participants are counted, although the mixer serves them.
+   */
+  uint32_t audio_requests;
+
+  /**
+   * Number of `request_video_frame` events emitted.
+   */
+  uint32_t video_requests;
+
+  /**
+   * Number of deadlines that had already passed by the time the request for
+   * an earlier one was issued. No requests are emitted for these.
+   */
+  uint32_t skipped_deadlines;
+
+  /**
+   * Highest lateness of any request.
+   */
+  uint32_t max_lateness;
+
+  /**
+   * Lateness histogram. Bucket i counts the requests that were at least
+   * 2^(i-1) but less than 2^i milliseconds late. Bucket 0 counts requests less
+   * than a millisecond late, the last bucket all requests above its lower
+   * bound.
+   */
+  uint32_t lateness[TOXAV_LATENESS_BUCKETS];
+};
+
+
 
 /*******************************************************************************
  *
@@ -512,8 +680,11 @@ bool toxav_send_audio_frame(ToxAV *av, uint32_t friend_number,
 /**
  * The function type for the `receive_video_frame` callback.
  *
- * Each plane contains (width * height) pixels. The Alpha plane can be NULL, in
- * which case every pixel should be assumed fully opaque.
+ * The frame is planar I420 with tightly packed rows: the Y plane contains
+ * (width * height) pixels, the U and V planes ((width + 1) / 2) *
+ * ((height + 1) / 2) pixels each. The Alpha plane can be NULL, in which case
+ * every pixel should be assumed fully opaque. The planes are only valid during
+ * the callback.
  *
  * @param friend_number The friend number of the friend who sent a video frame.
  * @param width Width of the frame in pixels.
@@ -534,6 +705,34 @@ typedef void toxav_receive_video_frame_cb(ToxAV *av, uint32_t friend_number,
 void toxav_callback_receive_video_frame(ToxAV *av, toxav_receive_video_frame_cb *function, void *user_data);
 
 
+/**
+ * Per-call counters for the video receive path. Decoded frames with padded
+ * rows are packed into a buffer owned by the call, which is only reallocated
+ * when the frame size grows. Times are in microseconds.
+ */
+struct ToxAV_Video_Receive_Stats {
+  /**
+   * Number of video frames received in this call.
+   */
+  uint32_t frames;
+
+  /**
+   * Number of times the frame buffer had to be allocated or grown.
+   */
+  uint32_t buffer_allocations;
+
+  /**
+   * Time spent packing the last frame.
+   */
+  uint32_t last_copy_time;
+
+  /**
+   * Highest time spent packing any frame.
+   */
+  uint32_t max_copy_time;
+};
+
+
 /**
  * The function type for the `receive_audio_frame` callback.
  *
@@ -556,3 +755,173 @@ typedef void toxav_receive_audio_frame_cb(ToxAV *av, uint32_t friend_number,
  * Set the callback for the `receive_audio_frame` event. Pass NULL to unset.
  */
 void toxav_callback_receive_audio_frame(ToxAV *av, toxav_receive_audio_frame_cb *function, void *user_data);
+
+
+/*******************************************************************************
+ *
+ * :: Conference mixing
+ *
+ ******************************************************************************/
+
+
+typedef enum TOXAV_ERR_MIXER {
+  TOXAV_ERR_MIXER_OK,
+  /**
+   * The friend_number passed did not designate a valid friend.
+   */
+  TOXAV_ERR_MIXER_FRIEND_NOT_FOUND,
+  /**
+   * The friend is already taking part in the conference.
+   */
+  TOXAV_ERR_MIXER_ALREADY_MIXED,
+  /**
+   * The friend is not taking part in the conference.
+   */
+  TOXAV_ERR_MIXER_NOT_MIXED
+} TOXAV_ERR_MIXER;
+
+/**
+ * Add a friend to the conference mixed by this A/V session.
+ *
+ * Audio received from conference participants is not passed to the
+ * `receive_audio_frame` callback, and no `request_audio_frame` events are
+ * emitted for them. Instead, the session mixes all participants' audio and
+ * sends each of them the mix of everyone else, once per audio frame duration.
+ * The friend may be added before or during a call; mixes are only sent while
+ * the call is sending audio.
+ */
+bool toxav_mixer_add_friend(ToxAV *av, uint32_t friend_number, TOXAV_ERR_MIXER *error);
+
+/**
+ * Remove a friend from the conference. Their audio goes to the client again.
+ */
+bool toxav_mixer_remove_friend(ToxAV *av, uint32_t friend_number, TOXAV_ERR_MIXER *error);
+
+
+/*******************************************************************************
+ *
+ * :: Call statistics
+ *
+ ******************************************************************************/
+
+
+/**
+ * Quality counters for the audio or the video of a call. Times are in
+ * microseconds, bit rates in kbit/s.
+ */
+struct ToxAV_Stream_Stats {
+  /**
+   * Number of `request_*_frame` events emitted.
+   */
+  uint32_t frames_requested;
+
+  /**
+   * Number of encoded frames sent.
+   */
+  uint32_t frames_sent;
+
+  /**
+   * Number of frames received from the friend.
+   */
+  uint32_t frames_received;
+
+  /**
+   * Number of frames that were not sent in time: requests that were still
+   * unanswered when the next one was due, and deadlines that passed without
+   * a request because toxav_iteration was called too late.
+   */
+  uint32_t frames_dropped;
+
+  /**
+   * Average and highest encoding time of a sent frame.
+   */
+  uint32_t encode_time_average;
+  uint32_t encode_time_max;
+
+  /**
+   * Bit rate of the encoded frames over the last complete second, and the bit
+   * rate the call was set up with.
+   */
+  uint32_t bit_rate;
+  uint32_t configured_bit_rate;
+
+  /**
+   * Inter-arrival jitter of received frames: the smoothed difference between
+   * the intervals between consecutive frames.
+   */
+  uint32_t jitter;
+
+  /**
+   * Highest time from a `request_*_frame` event to the frame sent in
+   * response, and the histogram of that time. The buckets are the same as
+   * for ToxAV_Request_Stats::lateness.
+   */
+  uint32_t send_latency_max;
+  uint32_t send_latency[TOXAV_LATENESS_BUCKETS];
+};
+
+/**
+ * All counters kept for a call. Decoding happens inside the A/V library and is
+ * not covered.
+ */
+struct ToxAV_Call_Stats {
+  struct ToxAV_Video_Send_Stats video_send;
+  struct ToxAV_Video_Receive_Stats video_receive;
+  struct ToxAV_Request_Stats requests;
+  struct ToxAV_Stream_Stats audio;
+  struct ToxAV_Stream_Stats video;
+};
+
+typedef enum TOXAV_ERR_CALL_STATS {
+  TOXAV_ERR_CALL_STATS_OK,
+  /**
+   * This client is currently not in a call with the friend.
+   */
+  TOXAV_ERR_CALL_STATS_FRIEND_NOT_IN_CALL
+} TOXAV_ERR_CALL_STATS;
+
+/**
+ * Fill the passed struct with the counters of the call with a friend. The
+ * counters are kept for every call, at the cost of a few additions per frame.
+ */
+bool toxav_get_call_stats(ToxAV const *av, uint32_t friend_number,
+                          struct ToxAV_Call_Stats *stats,
+                          TOXAV_ERR_CALL_STATS *error);
+
+
+/**
+ * Approximate native memory held by an A/V instance, in bytes. As for
+ * tox_get_memory_usage, buffers count their capacity, and the overhead of
+ * maps is an estimate.
+ */
+struct ToxAV_Memory_Usage {
+  /**
+   * Estimate of the A/V library's own state: the growth of the process heap
+   * while toxav_new ran. Codec state allocated later for each call is not
+   * included. As for Tox_Memory_Usage.core_estimate, other threads'
+   * allocations are counted too, so the value is unreliable with concurrent
+   * activity.
+   */
+  uint64_t av_estimate;
+
+  /**
+   * Per-call state: resampler, scaler, and the buffers for pending audio and
+   * for sent, scaled, encoded and received video frames.
+   */
+  uint64_t calls;
+
+  /**
+   * The frame request scheduler and the conference mixer.
+   */
+  uint64_t mixing;
+
+  /**
+   * The instance structure and its call tables.
+   */
+  uint64_t instance;
+};
+
+/**
+ * Fill the passed struct with the current memory usage of the A/V instance.
+ */
+void toxav_get_memory_usage(ToxAV const *av, struct ToxAV_Memory_Usage *usage);
@@ -5,6 +5,9 @@
 #define toxav_get_tox new_toxav_get_tox
 #define toxav_iteration_interval new_toxav_iteration_interval
 #define toxav_iteration new_toxav_iteration
+#define toxav_set_max_iteration_interval new_toxav_set_max_iteration_interval
+#define toxav_iteration_due new_toxav_iteration_due
+#define toxav_iteration_wakeups new_toxav_iteration_wakeups
 #define toxav_call new_toxav_call
 #define toxav_callback_call new_toxav_callback_call
 #define toxav_answer new_toxav_answer
@@ -14,7 +17,18 @@
 #define toxav_set_video_bit_rate new_toxav_set_video_bit_rate
 #define toxav_callback_request_video_frame new_toxav_callback_request_video_frame
 #define toxav_send_video_frame new_toxav_send_video_frame
+#define toxav_send_video_frame_packed new_toxav_send_video_frame_packed
+#define ToxAV_Video_Send_Stats new_ToxAV_Video_Send_Stats
 #define toxav_callback_request_audio_frame new_toxav_callback_request_audio_frame
 #define toxav_send_audio_frame new_toxav_send_audio_frame
+#define ToxAV_Request_Stats new_ToxAV_Request_Stats
 #define toxav_callback_receive_video_frame new_toxav_callback_receive_video_frame
+#define ToxAV_Video_Receive_Stats new_ToxAV_Video_Receive_Stats
 #define toxav_callback_receive_audio_frame new_toxav_callback_receive_audio_frame
+#define toxav_mixer_add_friend new_toxav_mixer_add_friend
+#define toxav_mixer_remove_friend new_toxav_mixer_remove_friend
+#define ToxAV_Stream_Stats new_ToxAV_Stream_Stats
+#define ToxAV_Call_Stats new_ToxAV_Call_Stats
+#define toxav_get_call_stats new_toxav_get_call_stats
+#define ToxAV_Memory_Usage new_ToxAV_Memory_Usage
+#define toxav_get_memory_usage new_toxav_get_memory_usage
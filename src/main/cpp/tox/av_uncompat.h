@@ -5,6 +5,9 @@
 #undef toxav_get_tox
 #undef toxav_iteration_interval
 #undef toxav_iteration
+#undef toxav_set_max_iteration_interval
+#undef toxav_iteration_due
+#undef toxav_iteration_wakeups
 #undef toxav_call
 #undef toxav_callback_call
 #undef toxav_answer
@@ -14,7 +17,18 @@
 #undef toxav_set_video_bit_rate
 #undef toxav_callback_request_video_frame
 #undef toxav_send_video_frame
+#undef toxav_send_video_frame_packed
+#undef ToxAV_Video_Send_Stats
 #undef toxav_callback_request_audio_frame
 #undef toxav_send_audio_frame
+#undef ToxAV_Request_Stats
 #undef toxav_callback_receive_video_frame
+#undef ToxAV_Video_Receive_Stats
 #undef toxav_callback_receive_audio_frame
+#undef toxav_mixer_add_friend
+#undef toxav_mixer_remove_friend
+#undef ToxAV_Stream_Stats
+#undef ToxAV_Call_Stats
+#undef toxav_get_call_stats
+#undef ToxAV_Memory_Usage
+#undef toxav_get_memory_usage
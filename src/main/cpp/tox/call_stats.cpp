@@ -0,0 +1,92 @@
+#include "call_stats.h"
+
+#include <algorithm>
+
+
+static uint32_t
+microseconds (stream_stats::clock::duration duration)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds> (duration).count ();
+}
+
+
+size_t
+latency_bucket (uint32_t microseconds)
+{
+  size_t bucket = 0;
+  while (bucket + 1 < latency_buckets && microseconds >= (1000u << bucket))
+    bucket++;
+  return bucket;
+}
+
+
+void
+stream_stats::on_request (clock::time_point now)
+{
+  if (pending)
+    dropped++;
+  pending = true;
+  requested_at = now;
+  requested++;
+}
+
+
+void
+stream_stats::on_skipped (uint32_t deadlines)
+{
+  dropped += deadlines;
+}
+
+
+void
+stream_stats::on_sent (clock::time_point now, size_t bytes, clock::duration encode_time)
+{
+  sent++;
+
+  uint32_t const encode_micros = microseconds (encode_time);
+  encode_time_total += encode_micros;
+  encode_time_max = std::max (encode_time_max, encode_micros);
+
+  // Audio that arrives in larger chunks than frames answers one request
+  // with several frames; only the first one measures the latency.
+  if (pending)
+    {
+      uint32_t const latency = microseconds (now - requested_at);
+      send_latency_max = std::max (send_latency_max, latency);
+      send_latency[latency_bucket (latency)]++;
+      pending = false;
+    }
+
+  if (window_start == clock::time_point ())
+    window_start = now;
+  window_bytes += bytes;
+  auto const elapsed = now - window_start;
+  if (elapsed >= std::chrono::seconds (1))
+    {
+      // bits per millisecond = kbit/s.
+      bit_rate = window_bytes * 8 / std::chrono::duration_cast<std::chrono::milliseconds> (elapsed).count ();
+      window_bytes = 0;
+      window_start = now;
+    }
+}
+
+
+void
+stream_stats::on_received (clock::time_point now)
+{
+  received++;
+
+  if (last_arrival != clock::time_point ())
+    {
+      auto const interval = now - last_arrival;
+      if (last_interval != clock::duration::zero ())
+        {
+          auto const difference = interval > last_interval ? interval - last_interval : last_interval - interval;
+          int64_t const sample_q4 = int64_t (microseconds (difference)) << 4;
+          jitter_q4 += (sample_q4 - int64_t (jitter_q4)) / 16;
+          jitter = jitter_q4 >> 4;
+        }
+      last_interval = interval;
+    }
+  last_arrival = now;
+}
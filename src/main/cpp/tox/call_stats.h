@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+
+// Number of buckets in the power-of-two latency histograms. Bucket 0 counts
+// values below a millisecond, bucket i values in [2^(i-1), 2^i) milliseconds,
+// and the last bucket everything above its lower bound.
+static size_t const latency_buckets = 8;
+
+size_t latency_bucket (uint32_t microseconds);
+
+
+// Quality counters of the audio or the video of a call, in both directions.
+// Every hook costs a handful of additions, so the counters are always kept.
+struct stream_stats
+{
+  typedef std::chrono::steady_clock clock;
+
+  uint32_t requested = 0;
+  uint32_t sent = 0;
+  uint32_t received = 0;
+  // Requests that were not answered before the next one was due, and
+  // deadlines that passed without a request.
+  uint32_t dropped = 0;
+
+  uint64_t encode_time_total = 0;
+  uint32_t encode_time_max = 0;
+
+  // Bit rate of the encoded frames over the last complete second, in kbit/s.
+  uint32_t bit_rate = 0;
+
+  // Smoothed difference between consecutive inter-arrival times of received
+  // frames, in microseconds. As in RFC 3550, each new difference moves the
+  // estimate by 1/16 of the distance.
+  uint32_t jitter = 0;
+
+  // Time from a request to the frame sent in response.
+  uint32_t send_latency_max = 0;
+  uint32_t send_latency[latency_buckets] = { };
+
+  void on_request (clock::time_point now);
+  void on_skipped (uint32_t deadlines);
+  void on_sent (clock::time_point now, size_t bytes, clock::duration encode_time);
+  void on_received (clock::time_point now);
+
+private:
+  bool pending = false;
+  clock::time_point requested_at;
+
+  uint64_t window_bytes = 0;
+  clock::time_point window_start;
+
+  clock::time_point last_arrival;
+  clock::duration last_interval = clock::duration::zero ();
+  // jitter in 1/16 microseconds, to keep the fraction of the estimate.
+  uint32_t jitter_q4 = 0;
+};
@@ -0,0 +1,311 @@
+#include "colorspace.h"
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+/*******************************************************************************
+ *
+ * :: Semi-planar formats
+ *
+ ******************************************************************************/
+
+
+// Split interleaved byte pairs into two planes.
+static void
+deinterleave (uint8_t const *src, size_t pairs, uint8_t *first, uint8_t *second)
+{
+  size_t i = 0;
+#if defined(__SSE2__)
+  __m128i const low_bytes = _mm_set1_epi16 (0x00ff);
+  for (; i + 16 <= pairs; i += 16)
+    {
+      __m128i a = _mm_loadu_si128 ((__m128i const *) (src + 2 * i));
+      __m128i b = _mm_loadu_si128 ((__m128i const *) (src + 2 * i + 16));
+      __m128i even = _mm_packus_epi16 (_mm_and_si128 (a, low_bytes), _mm_and_si128 (b, low_bytes));
+      __m128i odd = _mm_packus_epi16 (_mm_srli_epi16 (a, 8), _mm_srli_epi16 (b, 8));
+      _mm_storeu_si128 ((__m128i *) (first + i), even);
+      _mm_storeu_si128 ((__m128i *) (second + i), odd);
+    }
+#endif
+  for (; i < pairs; i++)
+    {
+      first[i] = src[2 * i];
+      second[i] = src[2 * i + 1];
+    }
+}
+
+
+void
+nv12_to_i420 (uint8_t const *src, uint16_t width, uint16_t height,
+              uint8_t *y, uint8_t *u, uint8_t *v)
+{
+  size_t const luma = size_t (width) * height;
+  std::memcpy (y, src, luma);
+  // Chroma rows are width bytes each, so the chroma plane is contiguous.
+  deinterleave (src + luma, luma / 4, u, v);
+}
+
+
+void
+nv21_to_i420 (uint8_t const *src, uint16_t width, uint16_t height,
+              uint8_t *y, uint8_t *u, uint8_t *v)
+{
+  size_t const luma = size_t (width) * height;
+  std::memcpy (y, src, luma);
+  deinterleave (src + luma, luma / 4, v, u);
+}
+
+
+/*******************************************************************************
+ *
+ * :: Packed RGB
+ *
+ ******************************************************************************/
+
+
+// BT.601 coefficients in 8 bit fixed point, indexed by the byte position of
+// each channel within a pixel.
+struct rgb_coefficients
+{
+  int16_t y[4];
+  int16_t u[4];
+  int16_t v[4];
+
+  rgb_coefficients (int r, int g, int b)
+    : y ()
+    , u ()
+    , v ()
+  {
+    y[r] =  66; y[g] = 129; y[b] =  25;
+    u[r] = -38; u[g] = -74; u[b] = 112;
+    v[r] = 112; v[g] = -94; v[b] = -18;
+  }
+};
+
+
+static inline uint8_t
+luma (uint8_t const *pixel, int16_t const *c)
+{
+  return ((c[0] * pixel[0] + c[1] * pixel[1] + c[2] * pixel[2] + 128) >> 8) + 16;
+}
+
+// Chroma from the channel sums of a 2x2 block, hence the extra 2 bits of
+// shift.
+static inline uint8_t
+chroma (int32_t const *sums, int16_t const *c)
+{
+  return ((c[0] * sums[0] + c[1] * sums[1] + c[2] * sums[2] + 512) >> 10) + 128;
+}
+
+
+#if defined(__SSE2__)
+static inline __m128i
+broadcast_pixel (int16_t const *c)
+{
+  return _mm_setr_epi16 (c[0], c[1], c[2], c[3], c[0], c[1], c[2], c[3]);
+}
+
+// Given two vectors of multiply-add results, each holding two int32 halves
+// for each of two pixels, return the four per-pixel sums.
+static inline __m128i
+sum_halves (__m128i lo, __m128i hi)
+{
+  __m128 a = _mm_castsi128_ps (lo);
+  __m128 b = _mm_castsi128_ps (hi);
+  __m128i first = _mm_castps_si128 (_mm_shuffle_ps (a, b, _MM_SHUFFLE (2, 0, 2, 0)));
+  __m128i second = _mm_castps_si128 (_mm_shuffle_ps (a, b, _MM_SHUFFLE (3, 1, 3, 1)));
+  return _mm_add_epi32 (first, second);
+}
+
+// Weighted channel sums of 4 pixels.
+static inline __m128i
+weigh_pixels (__m128i pixels, __m128i coefficients)
+{
+  __m128i const zero = _mm_setzero_si128 ();
+  __m128i lo = _mm_madd_epi16 (_mm_unpacklo_epi8 (pixels, zero), coefficients);
+  __m128i hi = _mm_madd_epi16 (_mm_unpackhi_epi8 (pixels, zero), coefficients);
+  return sum_halves (lo, hi);
+}
+
+// Channel sums of the two 2x2 blocks in 4 pixels of two rows, as 16 bit
+// lanes: [R G B A] of the first block, then of the second.
+static inline __m128i
+block_sums (__m128i top, __m128i bottom)
+{
+  __m128i const zero = _mm_setzero_si128 ();
+  __m128i lo = _mm_add_epi16 (_mm_unpacklo_epi8 (top, zero), _mm_unpacklo_epi8 (bottom, zero));
+  __m128i hi = _mm_add_epi16 (_mm_unpackhi_epi8 (top, zero), _mm_unpackhi_epi8 (bottom, zero));
+  lo = _mm_add_epi16 (lo, _mm_srli_si128 (lo, 8));
+  hi = _mm_add_epi16 (hi, _mm_srli_si128 (hi, 8));
+  return _mm_unpacklo_epi64 (lo, hi);
+}
+#endif
+
+
+static void
+rgb_luma_row (uint8_t const *src, uint16_t width, rgb_coefficients const &c, uint8_t *y)
+{
+  size_t x = 0;
+#if defined(__SSE2__)
+  __m128i const coefficients = broadcast_pixel (c.y);
+  __m128i const round = _mm_set1_epi32 (128);
+  __m128i const offset = _mm_set1_epi32 (16);
+  for (; x + 8 <= width; x += 8)
+    {
+      __m128i p0 = _mm_loadu_si128 ((__m128i const *) (src + 4 * x));
+      __m128i p1 = _mm_loadu_si128 ((__m128i const *) (src + 4 * x + 16));
+      __m128i y0 = _mm_add_epi32 (_mm_srai_epi32 (_mm_add_epi32 (weigh_pixels (p0, coefficients), round), 8), offset);
+      __m128i y1 = _mm_add_epi32 (_mm_srai_epi32 (_mm_add_epi32 (weigh_pixels (p1, coefficients), round), 8), offset);
+      __m128i packed = _mm_packs_epi32 (y0, y1);
+      _mm_storel_epi64 ((__m128i *) (y + x), _mm_packus_epi16 (packed, packed));
+    }
+#endif
+  for (; x < width; x++)
+    y[x] = luma (src + 4 * x, c.y);
+}
+
+
+static void
+rgb_chroma_row (uint8_t const *top, uint8_t const *bottom, uint16_t width, rgb_coefficients const &c,
+                uint8_t *u, uint8_t *v)
+{
+  size_t x = 0;
+#if defined(__SSE2__)
+  __m128i const u_coefficients = broadcast_pixel (c.u);
+  __m128i const v_coefficients = broadcast_pixel (c.v);
+  __m128i const round = _mm_set1_epi32 (512);
+  __m128i const offset = _mm_set1_epi32 (128);
+  for (; x + 8 <= width; x += 8)
+    {
+      __m128i b0 = block_sums (_mm_loadu_si128 ((__m128i const *) (top + 4 * x)),
+                               _mm_loadu_si128 ((__m128i const *) (bottom + 4 * x)));
+      __m128i b1 = block_sums (_mm_loadu_si128 ((__m128i const *) (top + 4 * x + 16)),
+                               _mm_loadu_si128 ((__m128i const *) (bottom + 4 * x + 16)));
+      __m128i us = sum_halves (_mm_madd_epi16 (b0, u_coefficients), _mm_madd_epi16 (b1, u_coefficients));
+      __m128i vs = sum_halves (_mm_madd_epi16 (b0, v_coefficients), _mm_madd_epi16 (b1, v_coefficients));
+      us = _mm_add_epi32 (_mm_srai_epi32 (_mm_add_epi32 (us, round), 10), offset);
+      vs = _mm_add_epi32 (_mm_srai_epi32 (_mm_add_epi32 (vs, round), 10), offset);
+
+      // Bytes 0-3 are U, 4-7 are V.
+      __m128i packed = _mm_packs_epi32 (us, vs);
+      packed = _mm_packus_epi16 (packed, packed);
+      int32_t u4 = _mm_cvtsi128_si32 (packed);
+      int32_t v4 = _mm_cvtsi128_si32 (_mm_srli_si128 (packed, 4));
+      std::memcpy (u + x / 2, &u4, 4);
+      std::memcpy (v + x / 2, &v4, 4);
+    }
+#endif
+  for (; x < width; x += 2)
+    {
+      int32_t sums[3];
+      for (int k = 0; k < 3; k++)
+        sums[k] = top[4 * x + k] + top[4 * x + 4 + k] + bottom[4 * x + k] + bottom[4 * x + 4 + k];
+      u[x / 2] = chroma (sums, c.u);
+      v[x / 2] = chroma (sums, c.v);
+    }
+}
+
+
+static void
+rgb_to_i420 (uint8_t const *src, uint16_t width, uint16_t height, rgb_coefficients const &c,
+             uint8_t *y, uint8_t *u, uint8_t *v)
+{
+  size_t const stride = size_t (width) * 4;
+  for (size_t row = 0; row < height; row += 2)
+    {
+      uint8_t const *top = src + row * stride;
+      uint8_t const *bottom = top + stride;
+      rgb_luma_row (top, width, c, y + row * width);
+      rgb_luma_row (bottom, width, c, y + (row + 1) * width);
+      rgb_chroma_row (top, bottom, width, c, u + row / 2 * (width / 2), v + row / 2 * (width / 2));
+    }
+}
+
+
+void
+rgba_to_i420 (uint8_t const *src, uint16_t width, uint16_t height,
+              uint8_t *y, uint8_t *u, uint8_t *v)
+{
+  static rgb_coefficients const rgba (0, 1, 2);
+  rgb_to_i420 (src, width, height, rgba, y, u, v);
+}
+
+
+void
+bgra_to_i420 (uint8_t const *src, uint16_t width, uint16_t height,
+              uint8_t *y, uint8_t *u, uint8_t *v)
+{
+  static rgb_coefficients const bgra (2, 1, 0);
+  rgb_to_i420 (src, width, height, bgra, y, u, v);
+}
+
+
+/*******************************************************************************
+ *
+ * :: Planar formats
+ *
+ ******************************************************************************/
+
+
+// Average each 2x2 block of a full resolution plane.
+static void
+subsample_row (uint8_t const *top, uint8_t const *bottom, uint16_t width, uint8_t *dst)
+{
+  size_t x = 0;
+#if defined(__SSE2__)
+  __m128i const zero = _mm_setzero_si128 ();
+  __m128i const ones = _mm_set1_epi16 (1);
+  __m128i const round = _mm_set1_epi32 (2);
+  for (; x + 16 <= width; x += 16)
+    {
+      __m128i t = _mm_loadu_si128 ((__m128i const *) (top + x));
+      __m128i b = _mm_loadu_si128 ((__m128i const *) (bottom + x));
+      __m128i lo = _mm_add_epi16 (_mm_unpacklo_epi8 (t, zero), _mm_unpacklo_epi8 (b, zero));
+      __m128i hi = _mm_add_epi16 (_mm_unpackhi_epi8 (t, zero), _mm_unpackhi_epi8 (b, zero));
+      lo = _mm_srai_epi32 (_mm_add_epi32 (_mm_madd_epi16 (lo, ones), round), 2);
+      hi = _mm_srai_epi32 (_mm_add_epi32 (_mm_madd_epi16 (hi, ones), round), 2);
+      __m128i packed = _mm_packs_epi32 (lo, hi);
+      _mm_storel_epi64 ((__m128i *) (dst + x / 2), _mm_packus_epi16 (packed, packed));
+    }
+#endif
+  for (; x < width; x += 2)
+    dst[x / 2] = (top[x] + top[x + 1] + bottom[x] + bottom[x + 1] + 2) >> 2;
+}
+
+
+void
+halve_plane (uint8_t const *src, uint16_t width, uint16_t height, uint8_t *dst)
+{
+  // An odd last row or column is dropped.
+  uint16_t const even_width = width & ~1;
+  for (size_t row = 0; row + 1 < height; row += 2)
+    subsample_row (src + row * width, src + (row + 1) * width, even_width, dst + row / 2 * (width / 2));
+}
+
+
+void
+i444_to_i420 (uint8_t const *src_y, uint8_t const *src_u, uint8_t const *src_v,
+              uint16_t width, uint16_t height,
+              uint8_t *y, uint8_t *u, uint8_t *v)
+{
+  std::memcpy (y, src_y, size_t (width) * height);
+  halve_plane (src_u, width, height, u);
+  halve_plane (src_v, width, height, v);
+}
+
+
+void
+copy_plane (uint8_t const *src, int stride, uint16_t width, uint16_t height, uint8_t *dst)
+{
+  if (stride == width)
+    {
+      std::memcpy (dst, src, size_t (width) * height);
+      return;
+    }
+  for (size_t row = 0; row < height; row++)
+    std::memcpy (dst + row * width, src + ptrdiff_t (row) * stride, width);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+
+// Conversions from common capture formats to planar I420, the encoder's input
+// format. All kernels take tightly packed input and require an even width
+// and height. The destination chroma planes are (width / 2) * (height / 2).
+// Where SSE2 is available, the inner loops process 8 to 32 pixels at a time;
+// the remaining pixels of each row use the scalar code.
+
+// Semi-planar 4:2:0 with interleaved chroma: U first (NV12) or V first (NV21).
+void nv12_to_i420 (uint8_t const *src, uint16_t width, uint16_t height,
+                   uint8_t *y, uint8_t *u, uint8_t *v);
+void nv21_to_i420 (uint8_t const *src, uint16_t width, uint16_t height,
+                   uint8_t *y, uint8_t *u, uint8_t *v);
+
+// 32 bit packed RGB, using BT.601 studio-swing coefficients. The alpha
+// channel is ignored.
+void rgba_to_i420 (uint8_t const *src, uint16_t width, uint16_t height,
+                   uint8_t *y, uint8_t *u, uint8_t *v);
+void bgra_to_i420 (uint8_t const *src, uint16_t width, uint16_t height,
+                   uint8_t *y, uint8_t *u, uint8_t *v);
+
+// Planar 4:4:4, as passed to toxav_send_video_frame. Chroma is averaged over
+// each 2x2 block.
+void i444_to_i420 (uint8_t const *src_y, uint8_t const *src_u, uint8_t const *src_v,
+                   uint16_t width, uint16_t height,
+                   uint8_t *y, uint8_t *u, uint8_t *v);
+
+// Average each 2x2 block of a plane into a (width / 2) * (height / 2) plane.
+// An odd last row or column is dropped.
+void halve_plane (uint8_t const *src, uint16_t width, uint16_t height, uint8_t *dst);
+
+// Copy a plane with rows stride bytes apart into a tightly packed plane.
+void copy_plane (uint8_t const *src, int stride, uint16_t width, uint16_t height, uint8_t *dst);
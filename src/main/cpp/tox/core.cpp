@@ -10,6 +10,9 @@
 #include <map>
 #include <vector>
 
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 
 uint32_t
 tox_version_major ()
@@ -80,10 +83,25 @@ register_custom_packet_handlers (new_Tox *tox)
     tox->register_custom_packet_handlers (friend_number);
 }
 
+static void
+load_savedata (Tox *tox, uint8_t const *data, size_t length, TOX_ERR_NEW *error)
+{
+  switch (tox_load (tox, data, length))
+    {
+    case -1:
+      if (error) *error = TOX_ERR_NEW_LOAD_BAD_FORMAT;
+      break;
+    case +1:
+      if (error) *error = TOX_ERR_NEW_LOAD_ENCRYPTED;
+      break;
+    }
+}
+
 new_Tox *
 new_tox_new (struct new_Tox_Options const *options, uint8_t const *data, size_t length, TOX_ERR_NEW *error)
 {
   Tox *tox;
+  size_t const heap_before = heap_in_use ();
 
   if (options != nullptr)
     {
@@ -164,6 +182,8 @@ new_tox_new (struct new_Tox_Options const *options, uint8_t const *data, size_t
 
   new_Tox *new_tox = new new_Tox (tox);
   register_custom_packet_handlers (new_tox);
+  // Other threads allocate and free meanwhile, so this is only an estimate.
+  new_tox->core_footprint = std::max (heap_in_use (), heap_before) - heap_before;
 
   // Set error to OK here.
   if (error) *error = TOX_ERR_NEW_OK;
@@ -176,26 +196,72 @@ new_tox_new (struct new_Tox_Options const *options, uint8_t const *data, size_t
         {
           if (error) *error = TOX_ERR_NEW_NULL;
         }
+      else if (savedata_is_compressed (data, length))
+        {
+          std::vector<uint8_t> plain;
+          if (savedata_decompress (data, length, plain))
+            load_savedata (tox, plain.data (), plain.size (), error);
+          else if (error)
+            *error = TOX_ERR_NEW_LOAD_BAD_FORMAT;
+        }
       else
         {
-          switch (tox_load (tox, data, length))
-            {
-            case -1:
-              if (error) *error = TOX_ERR_NEW_LOAD_BAD_FORMAT;
-              break;
-            case +1:
-              if (error) *error = TOX_ERR_NEW_LOAD_ENCRYPTED;
-              break;
-            }
+          load_savedata (tox, data, length, error);
         }
     }
 
   return new_tox;
 }
 
+new_Tox *
+new_tox_new_from_file (struct new_Tox_Options const *options, char const *path, TOX_ERR_NEW *error)
+{
+  if (path == nullptr)
+    {
+      if (error) *error = TOX_ERR_NEW_NULL;
+      return nullptr;
+    }
+
+  int fd = open (path, O_RDONLY | O_CLOEXEC);
+  if (fd == -1)
+    {
+      if (error) *error = TOX_ERR_NEW_LOAD_IO;
+      return nullptr;
+    }
+  struct stat st;
+  if (fstat (fd, &st) != 0 || !S_ISREG (st.st_mode))
+    {
+      close (fd);
+      if (error) *error = TOX_ERR_NEW_LOAD_IO;
+      return nullptr;
+    }
+  if (st.st_size == 0)
+    {
+      close (fd);
+      return new_tox_new (options, nullptr, 0, error);
+    }
+
+  // Map the file instead of reading it, so that the save data is never
+  // copied before tox_load parses it.
+  void *data = mmap (nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (data == MAP_FAILED)
+    {
+      if (error) *error = TOX_ERR_NEW_LOAD_IO;
+      return nullptr;
+    }
+  madvise (data, st.st_size, MADV_SEQUENTIAL);
+
+  new_Tox *tox = new_tox_new (options, static_cast<uint8_t const *> (data), st.st_size, error);
+  munmap (data, st.st_size);
+  return tox;
+}
+
 void
 new_tox_kill (new_Tox *tox)
 {
+  if (tox->autosave.enabled ())
+    tox->save_snapshot (autosave_writer::clock::now ());
   tox_kill (tox->tox);
   delete tox;
 }
@@ -212,6 +278,74 @@ new_tox_save (new_Tox const *tox, uint8_t *data)
   tox_save (tox->tox, data);
 }
 
+size_t
+new_tox_save_formatted_size (new_Tox const *tox, TOX_SAVE_FORMAT format)
+{
+  size_t const size = tox_size (tox->tox);
+  if (format == TOX_SAVE_FORMAT_LZ4)
+    return savedata_compressed_bound (size);
+  return size;
+}
+
+size_t
+new_tox_save_formatted (new_Tox const *tox, TOX_SAVE_FORMAT format, uint8_t *data)
+{
+  size_t const size = tox_size (tox->tox);
+  if (format == TOX_SAVE_FORMAT_LZ4)
+    {
+      std::vector<uint8_t> plain (size);
+      tox_save (tox->tox, plain.data ());
+      return savedata_compress (plain.data (), size, data);
+    }
+  tox_save (tox->tox, data);
+  return size;
+}
+
+bool
+new_tox_set_autosave (new_Tox *tox, char const *path, uint32_t min_interval, TOX_ERR_SET_AUTOSAVE *error)
+{
+  if (!tox->autosave.configure (path, min_interval))
+    {
+      if (error) *error = TOX_ERR_SET_AUTOSAVE_IO;
+      return false;
+    }
+  if (error) *error = TOX_ERR_SET_AUTOSAVE_OK;
+  return true;
+}
+
+void
+new_tox_set_autosave_format (new_Tox *tox, TOX_SAVE_FORMAT format)
+{
+  tox->autosave_format = format;
+}
+
+void
+new_tox_get_autosave_stats (new_Tox const *tox, struct new_Tox_Autosave_Stats *stats)
+{
+  autosave_writer::stats counters = tox->autosave.get_stats ();
+  stats->saves = counters.saves;
+  stats->skipped = counters.skipped;
+  stats->failures = counters.failures;
+  stats->last_latency = counters.last_latency;
+  stats->max_latency = counters.max_latency;
+}
+
+void
+new_tox_get_memory_usage (new_Tox const *tox, struct new_Tox_Memory_Usage *usage)
+{
+  usage->core_estimate = tox->core_footprint;
+
+  usage->transfers = 0;
+  for (auto const &pair : tox->transfers)
+    {
+      usage->transfers += map_node_size (tox->transfers) + heap_size (pair.second.requests);
+    }
+
+  usage->buffers = heap_size (tox->file_buffer) + heap_size (tox->save_buffer)
+                 + tox->autosave.heap_size ();
+  usage->instance = sizeof (new_Tox);
+}
+
 bool
 bootstrap_like (int func (Tox *tox, char const *address, uint16_t port, uint8_t const *public_key),
                 new_Tox *tox, char const *address, uint16_t port, uint8_t const *public_key, TOX_ERR_BOOTSTRAP *error)
@@ -281,15 +415,174 @@ new_tox_get_dht_id (new_Tox const *tox, uint8_t *dht_id)
   new_tox_self_get_public_key (tox, dht_id);
 }
 
+// An instance is active if it has file data to move: a running outgoing
+// transfer, or an incoming one that has started but not yet finished.
+static bool
+has_active_transfers (new_Tox const *tox)
+{
+  for (auto const &pair : tox->transfers)
+    {
+      file_transfer const &transfer = pair.second;
+      if (transfer.position == transfer.file_size)
+        continue;
+      if (file_transfer::send_receive (pair.first.second))
+        {
+          if (transfer.position != 0)
+            return true;
+        }
+      else if (transfer.state == file_transfer::RUNNING)
+        return true;
+    }
+  return false;
+}
+
 uint32_t
 new_tox_iteration_interval (new_Tox const *tox)
 {
-  return tox_do_interval (tox->tox);
+  return tox->iteration.interval (tox_do_interval (tox->tox), has_active_transfers (tox));
+}
+
+bool
+new_tox_set_max_iteration_interval (new_Tox *tox, uint32_t max_interval)
+{
+  return tox->iteration.set_max_interval (max_interval);
+}
+
+bool
+new_tox_iteration_due (new_Tox const *tox)
+{
+  return tox->iteration.due (new_tox_iteration_interval (tox));
+}
+
+uint32_t
+new_tox_iteration_wakeups (new_Tox const *tox)
+{
+  return tox->iteration.last_wakeups_per_second ();
+}
+
+void
+new_tox_set_event_budget (new_Tox *tox, size_t budget, TOX_EVENT_OVERFLOW overflow)
+{
+  tox->budget.limit = budget;
+  tox->budget.overflow = overflow;
+}
+
+void
+new_tox_set_event_backlog (new_Tox *tox, size_t backlog)
+{
+  tox->budget.backlog = backlog;
+}
+
+void
+new_tox_get_event_budget_stats (new_Tox const *tox, struct new_Tox_Event_Budget_Stats *stats)
+{
+  stats->high_watermark = tox->budget.high_watermark;
+  stats->overflows = tox->budget.overflows;
+  stats->paused = tox->budget.paused;
+  stats->dropped = tox->budget.dropped;
+}
+
+// The client has consumed enough of its events that the backlog is below the
+// budget, so transfers paused for the event budget may send again.
+static void
+resume_throttled_transfers (new_Tox *tox)
+{
+  if (tox->budget.limit != 0 && tox->budget.backlog >= tox->budget.limit)
+    return;
+
+  for (auto &pair : tox->transfers)
+    {
+      file_transfer &transfer = pair.second;
+      if (!transfer.throttled)
+        continue;
+      transfer.throttled = false;
+      tox_file_send_control (tox->tox, pair.first.first,
+                             file_transfer::send_receive (pair.first.second),
+                             file_transfer::old_file_number (pair.first.second),
+                             TOX_FILECONTROL_ACCEPT, nullptr, 0);
+    }
+}
+
+// Issue file_request_chunk events until the transfer's request window is
+// full or the whole file has been requested.
+static void
+request_file_chunks (new_Tox *tox, uint32_t friend_number, uint32_t file_number, file_transfer &transfer)
+{
+  if (transfer.state != file_transfer::RUNNING)
+    return;
+
+  size_t const chunk_size = tox_file_data_size (tox->tox, friend_number);
+  auto cb = tox->callbacks.file_request_chunk;
+  while (transfer.requests.size () < transfer.window && transfer.requested < transfer.file_size)
+    {
+      size_t length = std::min ((uint64_t) chunk_size, transfer.file_size - transfer.requested);
+
+      cb.func (tox, friend_number, file_number, transfer.requested, length, cb.user_data);
+      transfer.requests.push_back ({ transfer.requested, length });
+      transfer.requested += length;
+    }
+  transfer.max_requested = std::max (transfer.max_requested, transfer.requested);
+}
+
+// Send data from a file source until toxcore's send queue is full or the
+// whole file has been sent. Returns false if the source could not be read
+// and the transfer was cancelled.
+static bool
+send_file_chunks (new_Tox *tox, uint32_t friend_number, uint32_t file_number, file_transfer &transfer)
+{
+  if (transfer.state != file_transfer::RUNNING)
+    return true;
+
+  size_t const chunk_size = tox_file_data_size (tox->tox, friend_number);
+  tox->file_buffer.resize (chunk_size);
+  while (transfer.position < transfer.file_size)
+    {
+      size_t length = std::min ((uint64_t) chunk_size, transfer.file_size - transfer.position);
+      ssize_t read = transfer.read (tox->file_buffer.data (), length);
+      if (read != (ssize_t) length)
+        {
+          // The file was truncated or became unreadable.
+          tox_file_send_control (tox->tox, friend_number,
+                                 file_transfer::send_receive (file_number),
+                                 file_transfer::old_file_number (file_number),
+                                 TOX_FILECONTROL_KILL, nullptr, 0);
+          tox->remove_transfer (friend_number, file_number);
+
+          auto cb = tox->callbacks.file_control;
+          cb.func (tox, friend_number, file_number, TOX_FILE_CONTROL_CANCEL, cb.user_data);
+          return false;
+        }
+
+      if (tox_file_send_data (tox->tox, friend_number, file_transfer::old_file_number (file_number),
+                              tox->file_buffer.data (), length) == -1)
+        // Send queue is full, continue in the next iteration.
+        break;
+
+      transfer.position += length;
+      transfer.progress = true;
+    }
+
+  if (transfer.position == transfer.file_size)
+    {
+      if (tox_file_send_control (tox->tox, friend_number,
+                                 file_transfer::send_receive (file_number),
+                                 file_transfer::old_file_number (file_number),
+                                 TOX_FILECONTROL_FINISHED, nullptr, 0) != 0)
+        {
+          assert (false);
+        }
+    }
+
+  return true;
 }
 
 void
 new_tox_iteration (new_Tox *tox)
 {
+  tox->had_events = false;
+  tox->budget.used = 0;
+  tox->budget.charge (tox->budget.backlog);
+  resume_throttled_transfers (tox);
   tox_do (tox->tox);
   if (tox_isconnected (tox->tox) != tox->connected)
     {
@@ -297,30 +590,38 @@ new_tox_iteration (new_Tox *tox)
       auto cb = tox->callbacks.connection_status;
       cb.func (tox, tox->connected ? TOX_CONNECTION_UDP4 : TOX_CONNECTION_NONE, cb.user_data);
     }
-  // For all active file transfers that we didn't invoke a file_request_chunk
-  // event for, do so now.
-  for (auto &pair : tox->transfers)
+  // Top up the request window of all active file transfers. Transfers whose
+  // window is still full will be refilled from new_tox_file_send_chunk as
+  // soon as the client answers a request. Transfers from a file source are
+  // fed directly.
+  for (auto it = tox->transfers.begin (); it != tox->transfers.end (); )
     {
-      file_transfer &transfer = pair.second;
+      // Sending from a file source may remove the transfer.
+      auto current = it++;
+      file_transfer &transfer = current->second;
 
       if (transfer.position == transfer.file_size)
         // We're done, just waiting for the other side to acknowledge.
         continue;
 
-      if (transfer.state == file_transfer::RUNNING && !transfer.event_pending)
-        {
-          uint32_t friend_number = pair.first.first;
-          uint32_t file_number = pair.first.second;
+      if (transfer.fd != -1 && !file_transfer::send_receive (current->first.second))
+        send_file_chunks (tox, current->first.first, current->first.second, transfer);
+      else
+        request_file_chunks (tox, current->first.first, current->first.second, transfer);
+    }
+  // Transfers with a file sink or source report their progress once per
+  // iteration rather than once per chunk.
+  for (auto &pair : tox->transfers)
+    if (pair.second.progress)
+      tox->report_progress (pair.first.first, pair.first.second, pair.second);
 
-          transfer.size_requested = std::min ((uint64_t) tox_file_data_size (tox->tox, friend_number),
-                                              transfer.file_size - transfer.position);
+  // Snapshots are cheap compared to the disk write, which happens on the
+  // autosave thread.
+  auto now = autosave_writer::clock::now ();
+  if (tox->autosave.due (now))
+    tox->save_snapshot (now);
 
-          auto cb = tox->callbacks.file_request_chunk;
-          cb.func (tox, friend_number, file_number, transfer.position,
-                   transfer.size_requested, cb.user_data);
-          transfer.event_pending = true;
-        }
-    }
+  tox->iteration.iterated (tox_do_interval (tox->tox), !tox->had_events && !has_active_transfers (tox));
 }
 
 void
@@ -818,6 +1119,15 @@ new_tox_file_control (new_Tox *tox, uint32_t friend_number, uint32_t file_number
           if (error) *error = TOX_ERR_FILE_CONTROL_ALREADY_PAUSED;
           return false;
         }
+      transfer->state = file_transfer::PAUSED;
+      transfer->cause = file_transfer::SELF;
+      if (transfer->throttled)
+        {
+          // Already paused on the wire; just keep it paused after this
+          // iteration.
+          transfer->throttled = false;
+          break;
+        }
       if (tox_file_send_control (tox->tox, friend_number,
                                  file_transfer::send_receive (file_number),
                                  file_transfer::old_file_number (file_number),
@@ -832,6 +1142,7 @@ new_tox_file_control (new_Tox *tox, uint32_t friend_number, uint32_t file_number
               file_transfer::old_file_number (file_number),
               string_of_control_type (TOX_FILECONTROL_PAUSE), nullptr, 0);
 #endif
+      transfer->drop_requests ();
       break;
 
     case TOX_FILE_CONTROL_RESUME:
@@ -845,6 +1156,8 @@ new_tox_file_control (new_Tox *tox, uint32_t friend_number, uint32_t file_number
           if (error) *error = TOX_ERR_FILE_CONTROL_DENIED;
           return false;
         }
+      transfer->state = file_transfer::RUNNING;
+      transfer->throttled = false;
       if (tox_file_send_control (tox->tox, friend_number,
                                  file_transfer::send_receive (file_number),
                                  file_transfer::old_file_number (file_number),
@@ -859,10 +1172,12 @@ new_tox_file_control (new_Tox *tox, uint32_t friend_number, uint32_t file_number
           assert (false);
 #endif
         }
+      transfer->drop_requests ();
       break;
 
     case TOX_FILE_CONTROL_CANCEL:
       // No failure modes here.
+      transfer->close_file ();
       break;
     }
 
@@ -925,7 +1240,7 @@ new_tox_file_send (new_Tox *tox, uint32_t friend_number, TOX_FILE_KIND kind, uin
 }
 
 bool
-new_tox_file_send_chunk (new_Tox *tox, uint32_t friend_number, uint32_t file_number, uint8_t const *data, size_t length, TOX_ERR_FILE_SEND_CHUNK *error)
+new_tox_file_send_chunk (new_Tox *tox, uint32_t friend_number, uint32_t file_number, uint64_t position, uint8_t const *data, size_t length, TOX_ERR_FILE_SEND_CHUNK *error)
 {
   if (length == 0)
     {
@@ -959,32 +1274,60 @@ new_tox_file_send_chunk (new_Tox *tox, uint32_t friend_number, uint32_t file_num
       return false;
     }
 
+  if (position >= transfer->max_requested)
+    {
+      if (error) *error = TOX_ERR_FILE_SEND_CHUNK_WRONG_POSITION;
+      return false;
+    }
+  if (position != transfer->position || transfer->state != file_transfer::RUNNING)
+    {
+      // This answers a request dropped by a pause, a resume or a short send.
+      // The data at the current position is requested again, so the answer
+      // is discarded rather than written at the wrong place.
+      if (error) *error = TOX_ERR_FILE_SEND_CHUNK_OK;
+      return true;
+    }
+
+  // The answer may come from before a pause. Its data is just as valid, but
+  // then it also answers the repeated request for the same position.
+  if (!transfer->requests.empty () && transfer->requests.front ().position == position)
+    transfer->requests.pop_front ();
+
   if (tox_file_send_data (tox->tox, friend_number, file_transfer::old_file_number (file_number),
                           data, length) == -1)
     {
-#if 0
-      printf ("tox_file_send_data (%d, %d, %d, %p, %zd) = -1\n",
-              id (tox->tox),
-              friend_number,
-              file_transfer::old_file_number (file_number),
-              data,
-              length);
-#endif
-      // Something went wrong, but what?
-      assert (false);
+      // The send queue is full. Shrink the window and request this chunk
+      // again later.
+      transfer->window = std::max (transfer->window / 2, (size_t) 1);
+      length = 0;
     }
+  else if (transfer->window < file_transfer::max_window)
+    transfer->window++;
 
   transfer->position += length;
-  transfer->event_pending = false;
+
+  uint64_t const next = transfer->requests.empty ()
+    ? transfer->requested
+    : transfer->requests.front ().position;
+  if (next != transfer->position)
+    // After a short or failed send, the outstanding requests no longer
+    // continue from the current position.
+    transfer->drop_requests ();
 
   if (transfer->position == transfer->file_size)
-    if (tox_file_send_control (tox->tox, friend_number,
-                               file_transfer::send_receive (file_number),
-                               file_transfer::old_file_number (file_number),
-                               TOX_FILECONTROL_FINISHED, nullptr, 0) != 0)
-      {
-        assert (false);
-      }
+    {
+      if (tox_file_send_control (tox->tox, friend_number,
+                                 file_transfer::send_receive (file_number),
+                                 file_transfer::old_file_number (file_number),
+                                 TOX_FILECONTROL_FINISHED, nullptr, 0) != 0)
+        {
+          assert (false);
+        }
+    }
+  else if (length != 0)
+    // Space freed up in the window, so request more right away instead of
+    // waiting for the next iteration.
+    request_file_chunks (tox, friend_number, file_number, *transfer);
 
   if (error) *error = TOX_ERR_FILE_SEND_CHUNK_OK;
   return true;
@@ -996,6 +1339,56 @@ new_tox_callback_file_request_chunk (new_Tox *tox, tox_file_request_chunk_cb *fu
   tox->callbacks.file_request_chunk = { function, user_data };
 }
 
+uint32_t
+new_tox_file_send_from_path (new_Tox *tox, uint32_t friend_number, TOX_FILE_KIND kind, char const *path, uint8_t const *filename, size_t filename_length, TOX_ERR_FILE_SEND_FROM_PATH *error)
+{
+  if (path == nullptr)
+    {
+      if (error) *error = TOX_ERR_FILE_SEND_FROM_PATH_NULL;
+      return 0;
+    }
+
+  int fd = open (path, O_RDONLY | O_CLOEXEC);
+  if (fd == -1)
+    {
+      if (error) *error = TOX_ERR_FILE_SEND_FROM_PATH_IO;
+      return 0;
+    }
+  struct stat st;
+  if (fstat (fd, &st) != 0 || !S_ISREG (st.st_mode))
+    {
+      close (fd);
+      if (error) *error = TOX_ERR_FILE_SEND_FROM_PATH_IO;
+      return 0;
+    }
+  // We read the file front to back, so let the kernel read ahead.
+  posix_fadvise (fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+  TOX_ERR_FILE_SEND send_error;
+  uint32_t file_number = new_tox_file_send (tox, friend_number, kind, st.st_size, filename, filename_length, &send_error);
+  if (send_error != TOX_ERR_FILE_SEND_OK)
+    {
+      close (fd);
+      if (error)
+        switch (send_error)
+          {
+          case TOX_ERR_FILE_SEND_OK                  : assert (false); break;
+          case TOX_ERR_FILE_SEND_NULL                : *error = TOX_ERR_FILE_SEND_FROM_PATH_NULL; break;
+          case TOX_ERR_FILE_SEND_FRIEND_NOT_FOUND    : *error = TOX_ERR_FILE_SEND_FROM_PATH_FRIEND_NOT_FOUND; break;
+          case TOX_ERR_FILE_SEND_FRIEND_NOT_CONNECTED: *error = TOX_ERR_FILE_SEND_FROM_PATH_FRIEND_NOT_CONNECTED; break;
+          case TOX_ERR_FILE_SEND_NAME_EMPTY          : *error = TOX_ERR_FILE_SEND_FROM_PATH_NAME_EMPTY; break;
+          case TOX_ERR_FILE_SEND_NAME_TOO_LONG       : *error = TOX_ERR_FILE_SEND_FROM_PATH_NAME_TOO_LONG; break;
+          case TOX_ERR_FILE_SEND_TOO_MANY            : *error = TOX_ERR_FILE_SEND_FROM_PATH_TOO_MANY; break;
+          }
+      return 0;
+    }
+
+  tox->get_transfer (friend_number, file_number)->fd = fd;
+
+  if (error) *error = TOX_ERR_FILE_SEND_FROM_PATH_OK;
+  return file_number;
+}
+
 void
 new_tox_callback_file_receive (new_Tox *tox, tox_file_receive_cb *function, void *user_data)
 {
@@ -1008,6 +1401,68 @@ new_tox_callback_file_receive_chunk (new_Tox *tox, tox_file_receive_chunk_cb *fu
   tox->callbacks.file_receive_chunk = { function, user_data };
 }
 
+bool
+new_tox_file_set_sink (new_Tox *tox, uint32_t friend_number, uint32_t file_number, char const *path, TOX_ERR_FILE_SET_SINK *error)
+{
+  if (path == nullptr)
+    {
+      if (error) *error = TOX_ERR_FILE_SET_SINK_NULL;
+      return false;
+    }
+  if (!new_tox_friend_exists (tox, friend_number))
+    {
+      if (error) *error = TOX_ERR_FILE_SET_SINK_FRIEND_NOT_FOUND;
+      return false;
+    }
+  file_transfer *transfer = tox->get_transfer (friend_number, file_number);
+  if (transfer == nullptr || !file_transfer::send_receive (file_number))
+    {
+      if (error) *error = TOX_ERR_FILE_SET_SINK_NOT_FOUND;
+      return false;
+    }
+
+  int fd = open (path, O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+  if (fd == -1)
+    {
+      if (error) *error = TOX_ERR_FILE_SET_SINK_IO;
+      return false;
+    }
+  // An existing file may be longer than this one, and its tail would
+  // otherwise survive the transfer. Once data has been received, the file
+  // may already hold it, so it is left alone.
+  if (transfer->position == 0 && ftruncate (fd, transfer->file_size) != 0)
+    {
+      close (fd);
+      if (error) *error = TOX_ERR_FILE_SET_SINK_IO;
+      return false;
+    }
+  if (transfer->file_size != 0)
+    {
+      // Allocate the whole file now, so that we fail early if the disk is
+      // full and the chunks don't fragment the file. Not all file systems
+      // support this, in which case the file simply grows as data arrives.
+      int result = posix_fallocate (fd, 0, transfer->file_size);
+      if (result != 0 && result != EINVAL && result != EOPNOTSUPP)
+        {
+          close (fd);
+          if (error) *error = TOX_ERR_FILE_SET_SINK_IO;
+          return false;
+        }
+    }
+
+  transfer->close_file ();
+  transfer->fd = fd;
+
+  if (error) *error = TOX_ERR_FILE_SET_SINK_OK;
+  return true;
+}
+
+void
+new_tox_callback_file_progress (new_Tox *tox, tox_file_progress_cb *function, void *user_data)
+{
+  tox->callbacks.file_progress = { function, user_data };
+}
+
 static bool
 new_tox_send_custom_packet (int send (Tox const *tox, int32_t friendnumber, uint8_t const *data, uint32_t length),
                             new_Tox *tox, uint32_t friend_number, uint8_t const *data, size_t length, TOX_ERR_SEND_CUSTOM_PACKET *error)
@@ -233,6 +233,12 @@ bool tox_version_is_compatible(uint32_t major, uint32_t minor, uint32_t patch);
  */
 #define TOX_HASH_LENGTH			/*crypto_hash_sha256_BYTES*/ 32
 
+/**
+ * The interval in milliseconds while file transfers or calls are running, and
+ * the smallest cap accepted by tox_set_max_iteration_interval.
+ */
+#define TOX_MIN_ITERATION_INTERVAL	5
+
 /*******************************************************************************
  *
  * :: Global enumerations
@@ -422,9 +428,13 @@ typedef enum TOX_ERR_NEW {
    * saved by an older version of Tox, or when the data has been corrupted.
    * When loading from badly formatted data, some data may have been loaded,
    * and the rest is discarded. Passing an invalid length parameter also
-   * causes this error.
+   * causes this error, as does compressed data that fails its checksum.
    */
-  TOX_ERR_NEW_LOAD_BAD_FORMAT
+  TOX_ERR_NEW_LOAD_BAD_FORMAT,
+  /**
+   * The file passed to tox_new_from_file could not be opened or read.
+   */
+  TOX_ERR_NEW_LOAD_IO
 } TOX_ERR_NEW;
 
 
@@ -435,14 +445,16 @@ typedef enum TOX_ERR_NEW {
  * loop with a new instance will operate correctly.
  *
  * If the data parameter is not NULL, this function will load the Tox instance
- * from a byte array previously filled by tox_save.
+ * from a byte array previously filled by tox_save or tox_save_formatted. The
+ * format is detected from the data.
  *
  * If loading failed or succeeded only partially, the new or partially loaded
  * instance is returned and an error code is set.
  *
  * @param options An options object as described above. If this parameter is
  *   NULL, the default options are used.
- * @param data A byte array containing data previously stored by tox_save.
+ * @param data A byte array containing data previously stored by tox_save or
+ *   tox_save_formatted.
  * @param length The length of the byte array data. If this parameter is 0, the
  *   data parameter is ignored.
  *
@@ -450,6 +462,23 @@ typedef enum TOX_ERR_NEW {
  */
 Tox *tox_new(struct Tox_Options const *options, uint8_t const *data, size_t length, TOX_ERR_NEW *error);
 
+/**
+ * Creates a new Tox instance and loads it from a file previously written with
+ * the data from tox_save.
+ *
+ * This is equivalent to reading the file and passing its contents to tox_new,
+ * but the file is memory-mapped and loaded directly from the mapping, so the
+ * client does not need to hold a copy of the data. An empty file creates a
+ * fresh instance.
+ *
+ * @param options An options object as described above. If this parameter is
+ *   NULL, the default options are used.
+ * @param path A NUL-terminated path to the save file.
+ *
+ * @return A new Tox instance pointer on success or NULL on failure.
+ */
+Tox *tox_new_from_file(struct Tox_Options const *options, char const *path, TOX_ERR_NEW *error);
+
 
 /**
  * Releases all resources associated with the Tox instance and disconnects from
@@ -479,6 +508,154 @@ size_t tox_save_size(Tox const *tox);
 void tox_save(Tox const *tox, uint8_t *data);
 
 
+typedef enum TOX_SAVE_FORMAT {
+  /**
+   * The data as tox_save writes it.
+   */
+  TOX_SAVE_FORMAT_PLAIN,
+  /**
+   * The tox_save data compressed with LZ4, in a container with a header, a
+   * format version and a CRC-32 of the uncompressed data. Large friend lists
+   * compress well, since most of the save data is fixed-size records padded
+   * with zeros. tox_new and tox_new_from_file recognise this format.
+   */
+  TOX_SAVE_FORMAT_LZ4
+} TOX_SAVE_FORMAT;
+
+/**
+ * Calculates an upper bound on the number of bytes tox_save_formatted writes
+ * in the given format. For TOX_SAVE_FORMAT_PLAIN, this is tox_save_size.
+ */
+size_t tox_save_formatted_size(Tox const *tox, TOX_SAVE_FORMAT format);
+
+/**
+ * Store all information associated with the tox instance to a byte array, in
+ * the given format.
+ *
+ * @param data A memory region of at least tox_save_formatted_size bytes.
+ *
+ * @return The number of bytes written.
+ */
+size_t tox_save_formatted(Tox const *tox, TOX_SAVE_FORMAT format, uint8_t *data);
+
+
+typedef enum TOX_ERR_SET_AUTOSAVE {
+  TOX_ERR_SET_AUTOSAVE_OK,
+  /**
+   * A file could not be created in the directory of the given path.
+   */
+  TOX_ERR_SET_AUTOSAVE_IO
+} TOX_ERR_SET_AUTOSAVE;
+
+/**
+ * Periodically save the instance to a file in the background.
+ *
+ * At most every min_interval milliseconds, tox_iteration takes a snapshot of
+ * the data tox_save would produce. If it differs from the last saved
+ * snapshot, it is written on a background thread to a temporary file with a
+ * unique name next to path, which is synced to disk and renamed over path. The
+ * file at path thus always contains a complete save, and no other file is
+ * overwritten. A last snapshot is written in tox_kill.
+ *
+ * @param path A NUL-terminated path to the save file, or NULL to disable
+ *   autosaving.
+ * @param min_interval Minimum time between two snapshots in milliseconds.
+ *
+ * @return true on success.
+ */
+bool tox_set_autosave(Tox *tox, char const *path, uint32_t min_interval, TOX_ERR_SET_AUTOSAVE *error);
+
+
+/**
+ * Counters for the autosave facility. Latencies are in microseconds and cover
+ * writing, syncing and renaming the file.
+ */
+struct Tox_Autosave_Stats {
+  /**
+   * Number of snapshots written to disk.
+   */
+  uint32_t saves;
+
+  /**
+   * Number of snapshots that were identical to the last saved one and
+   * therefore not written.
+   */
+  uint32_t skipped;
+
+  /**
+   * Number of writes that failed.
+   */
+  uint32_t failures;
+
+  /**
+   * Latency of the last successful write, including compression.
+   */
+  uint32_t last_latency;
+
+  /**
+   * Highest latency of any successful write.
+   */
+  uint32_t max_latency;
+};
+
+/**
+ * Fill the passed struct with the current autosave counters.
+ */
+void tox_get_autosave_stats(Tox const *tox, struct Tox_Autosave_Stats *stats);
+
+/**
+ * Set the format of the snapshots written by autosave. The default is
+ * TOX_SAVE_FORMAT_PLAIN. Snapshots are compressed on the autosave thread,
+ * after unchanged ones have been skipped, and the smaller file is faster to
+ * write and sync.
+ */
+void tox_set_autosave_format(Tox *tox, TOX_SAVE_FORMAT format);
+
+
+/**
+ * Approximate native memory held by an instance, in bytes. Buffers count
+ * their capacity, so memory retained after a burst of activity shows up here
+ * even once the instance is idle again. The standard library does not say how
+ * much its maps and deques allocate, so their share is estimated from the
+ * layouts of libstdc++ and libc++; with other libraries only their elements
+ * are counted.
+ */
+struct Tox_Memory_Usage {
+  /**
+   * Estimate of the core library's own state, which cannot be measured
+   * directly: the growth of the process heap while tox_new ran. That
+   * includes the friends loaded from save data, but nothing allocated later,
+   * e.g. for friends added since. Allocations and frees by other threads
+   * during tox_new are counted too, so with concurrent activity, including
+   * creating several instances at once, the value is unreliable and can be
+   * anything from 0 to a multiple of the real size. 0 where the C library
+   * does not report its heap usage.
+   */
+  uint64_t core_estimate;
+
+  /**
+   * Bookkeeping for file transfers in progress.
+   */
+  uint64_t transfers;
+
+  /**
+   * Buffers kept for reuse: file chunks read from sources and autosave
+   * snapshots.
+   */
+  uint64_t buffers;
+
+  /**
+   * The instance structure itself.
+   */
+  uint64_t instance;
+};
+
+/**
+ * Fill the passed struct with the current memory usage of the instance.
+ */
+void tox_get_memory_usage(Tox const *tox, struct Tox_Memory_Usage *usage);
+
+
 /*******************************************************************************
  *
  * :: Connection lifecycle and event loop
@@ -603,6 +780,110 @@ uint32_t tox_iteration_interval(Tox const *tox);
  */
 void tox_iteration(Tox *tox);
 
+/**
+ * Set the upper bound in milliseconds for tox_iteration_interval().
+ *
+ * While file transfers are running, the iteration interval is shortened so
+ * that data moves at more than one chunk per tick. When the instance is idle,
+ * the interval is doubled on every iteration, starting at the interval the
+ * network layer asks for, until it reaches this cap. Any event or transfer
+ * activity resets it. The default cap is 1000 milliseconds.
+ *
+ * @return false, leaving the cap unchanged, if max_interval is below
+ *   TOX_MIN_ITERATION_INTERVAL.
+ */
+bool tox_set_max_iteration_interval(Tox *tox, uint32_t max_interval);
+
+/**
+ * Return whether tox_iteration_interval() milliseconds have passed since the
+ * end of the last tox_iteration. Clients that hand out events in slices call
+ * tox_iteration whenever this is true, so the network is serviced throughout
+ * a long drain.
+ */
+bool tox_iteration_due(Tox const *tox);
+
+/**
+ * Return the number of times tox_iteration was called during the last complete
+ * one-second window. This is 0 if tox_iteration has not been called for more
+ * than a second.
+ */
+uint32_t tox_iteration_wakeups(Tox const *tox);
+
+
+typedef enum TOX_EVENT_OVERFLOW {
+  /**
+   * Pause incoming file transfers whose chunks are passed to the client. The
+   * sender is asked to pause as soon as one of its chunks exceeds the budget,
+   * and to resume at the start of the next iteration.
+   */
+  TOX_EVENT_OVERFLOW_PAUSE_TRANSFERS,
+  /**
+   * Drop lossy custom packets while the budget is exceeded. The number of
+   * dropped packets is reported in Tox_Event_Budget_Stats.
+   */
+  TOX_EVENT_OVERFLOW_DROP_LOSSY
+} TOX_EVENT_OVERFLOW;
+
+/**
+ * Limit the payload passed to the event callbacks during one tox_iteration:
+ * messages, names, file names, file chunks and custom packets.
+ *
+ * A client that buffers events until the iteration returns can bound that
+ * buffer this way. The limit is soft: no lossless event is ever dropped, so
+ * chunks that are already in flight when a transfer is paused still arrive.
+ * A client that hands out its buffer in slices reports the part it still
+ * holds with tox_set_event_backlog, so that the budget bounds the buffer and
+ * not only what one iteration adds to it.
+ *
+ * @param budget Payload bytes per iteration, or 0 for no limit (the default).
+ * @param overflow What to do once the budget is exceeded.
+ */
+void tox_set_event_budget(Tox *tox, size_t budget, TOX_EVENT_OVERFLOW overflow);
+
+/**
+ * Set the number of bytes of events from earlier iterations that the client
+ * has not handed out yet. The next tox_iteration charges them to the event
+ * budget before any new event. Transfers paused for the budget are only
+ * resumed once the backlog is below the budget, and while it exceeds the
+ * budget, lossy packets are dropped from the start of the iteration.
+ *
+ * The backlog applies to every following iteration until it is set again. It
+ * is 0 by default, for clients that consume all events of each iteration.
+ */
+void tox_set_event_backlog(Tox *tox, size_t backlog);
+
+/**
+ * Counters for the event budget. They are kept while no budget is set, so the
+ * high watermark can be used to choose one.
+ */
+struct Tox_Event_Budget_Stats {
+  /**
+   * Most payload bytes passed to the callbacks in a single iteration,
+   * including the backlog set with tox_set_event_backlog.
+   */
+  uint64_t high_watermark;
+
+  /**
+   * Number of iterations that exceeded the budget.
+   */
+  uint64_t overflows;
+
+  /**
+   * Number of times an incoming file transfer was paused.
+   */
+  uint64_t paused;
+
+  /**
+   * Number of lossy packets dropped.
+   */
+  uint64_t dropped;
+};
+
+/**
+ * Fill the passed struct with the current event budget counters.
+ */
+void tox_get_event_budget_stats(Tox const *tox, struct Tox_Event_Budget_Stats *stats);
+
 
 /*******************************************************************************
  *
@@ -1575,7 +1856,12 @@ typedef enum TOX_ERR_FILE_SEND_CHUNK {
    * adjusted according to maximum transmission unit and the expected end of
    * the file. Trying to send more will result in no data being sent.
    */
-  TOX_ERR_FILE_SEND_CHUNK_TOO_LARGE
+  TOX_ERR_FILE_SEND_CHUNK_TOO_LARGE,
+  /**
+   * The position does not belong to any chunk requested through the
+   * `file_request_chunk` callback.
+   */
+  TOX_ERR_FILE_SEND_CHUNK_WRONG_POSITION
 } TOX_ERR_FILE_SEND_CHUNK;
 
 /**
@@ -1589,9 +1875,14 @@ typedef enum TOX_ERR_FILE_SEND_CHUNK {
  * zero-length chunk to terminate. For streams, it is necessary for the last
  * chunk sent to be zero-length.
  *
+ * The position must be the one passed to the `file_request_chunk` callback.
+ * Answers to requests voided by a pause or resume are discarded, so the data
+ * is never written at the wrong position, even if the client answers them.
+ *
+ * @param position The file or stream position of the request being answered.
  * @return true on success.
  */
-bool tox_file_send_chunk(Tox *tox, uint32_t friend_number, uint32_t file_number, uint8_t const *data, size_t length, TOX_ERR_FILE_SEND_CHUNK *error);
+bool tox_file_send_chunk(Tox *tox, uint32_t friend_number, uint32_t file_number, uint64_t position, uint8_t const *data, size_t length, TOX_ERR_FILE_SEND_CHUNK *error);
 
 
 /**
@@ -1616,6 +1907,11 @@ bool tox_file_send_chunk(Tox *tox, uint32_t friend_number, uint32_t file_number,
  * data to the other side. However, this will generally be less efficient than
  * waiting for a full chunk size of data to be ready.
  *
+ * Pausing or resuming the transfer, from either side, voids the requests that
+ * are still unanswered. The client may drop or answer them; answers are
+ * discarded, and the data is requested again from the current position when
+ * the transfer runs again.
+ *
  * @param friend_number The friend number of the receiving friend for this file.
  * @param file_number The file transfer identifier returned by tox_file_send.
  * @param position The file or stream position from which to continue reading.
@@ -1629,6 +1925,61 @@ typedef void tox_file_request_chunk_cb(Tox *tox, uint32_t friend_number, uint32_
 void tox_callback_file_request_chunk(Tox *tox, tox_file_request_chunk_cb *function, void *user_data);
 
 
+typedef enum TOX_ERR_FILE_SEND_FROM_PATH {
+  TOX_ERR_FILE_SEND_FROM_PATH_OK,
+  TOX_ERR_FILE_SEND_FROM_PATH_NULL,
+  /**
+   * The friend_number passed did not designate a valid friend.
+   */
+  TOX_ERR_FILE_SEND_FROM_PATH_FRIEND_NOT_FOUND,
+  /**
+   * This client is currently not connected to the friend.
+   */
+  TOX_ERR_FILE_SEND_FROM_PATH_FRIEND_NOT_CONNECTED,
+  /**
+   * Filename length was 0.
+   */
+  TOX_ERR_FILE_SEND_FROM_PATH_NAME_EMPTY,
+  /**
+   * Filename length exceeded 255 bytes.
+   */
+  TOX_ERR_FILE_SEND_FROM_PATH_NAME_TOO_LONG,
+  /**
+   * Too many ongoing transfers.
+   */
+  TOX_ERR_FILE_SEND_FROM_PATH_TOO_MANY,
+  /**
+   * The file could not be opened for reading, or was not a regular file.
+   */
+  TOX_ERR_FILE_SEND_FROM_PATH_IO
+} TOX_ERR_FILE_SEND_FROM_PATH;
+
+/**
+ * Send the contents of a local file.
+ *
+ * This works like tox_file_send with the size of the file at the given path,
+ * except that the library reads the file and sends its data during
+ * tox_iteration. The `file_request_chunk` callback is not invoked for this
+ * transfer. Instead, the `file_progress` callback reports the number of bytes
+ * sent so far, at most once per iteration. When the friend has received the
+ * whole file, a final `file_progress` event with position equal to the file
+ * size is sent and the file number can be reused.
+ *
+ * If the file can no longer be read, the transfer is cancelled and the client
+ * receives a TOX_FILE_CONTROL_CANCEL through the `file_control` callback.
+ *
+ * @param friend_number The friend number of the friend the file send request
+ *   should be sent to.
+ * @param kind The meaning of the file to be sent.
+ * @param path A NUL-terminated path to the file to send.
+ * @param filename Name of the file as it is sent to the friend.
+ * @param filename_length Size in bytes of the filename.
+ *
+ * @return A file number used as an identifier in subsequent callbacks.
+ */
+uint32_t tox_file_send_from_path(Tox *tox, uint32_t friend_number, TOX_FILE_KIND kind, char const *path, uint8_t const *filename, size_t filename_length, TOX_ERR_FILE_SEND_FROM_PATH *error);
+
+
 /*******************************************************************************
  *
  * :: File transmission: receiving
@@ -1689,6 +2040,72 @@ typedef void tox_file_receive_chunk_cb(Tox *tox, uint32_t friend_number, uint32_
 void tox_callback_file_receive_chunk(Tox *tox, tox_file_receive_chunk_cb *function, void *user_data);
 
 
+typedef enum TOX_ERR_FILE_SET_SINK {
+  TOX_ERR_FILE_SET_SINK_OK,
+  TOX_ERR_FILE_SET_SINK_NULL,
+  /**
+   * The friend_number passed did not designate a valid friend.
+   */
+  TOX_ERR_FILE_SET_SINK_FRIEND_NOT_FOUND,
+  /**
+   * No incoming file transfer with the given file number was found for the
+   * given friend.
+   */
+  TOX_ERR_FILE_SET_SINK_NOT_FOUND,
+  /**
+   * The file could not be opened for writing, or space for it could not be
+   * allocated.
+   */
+  TOX_ERR_FILE_SET_SINK_IO
+} TOX_ERR_FILE_SET_SINK;
+
+/**
+ * Write the data of an incoming file transfer directly to a file.
+ *
+ * The file at the given path is created if it does not exist, and space for
+ * file_size bytes is allocated up front. If no data has been received yet, an
+ * existing file is truncated to file_size bytes; later, it is left as it is,
+ * since it may hold the data received so far. Each received chunk is then
+ * written at its position in the file, and the `file_receive_chunk` callback
+ * is no longer invoked for this transfer. Instead, the `file_progress`
+ * callback reports the number of bytes received so far, at most once per
+ * iteration.
+ *
+ * The sink is closed when the transfer completes or is cancelled. If writing
+ * to the file fails, the sink is closed and the remaining chunks are passed to
+ * `file_receive_chunk` again.
+ *
+ * @param friend_number The friend number of the friend who is sending the file.
+ * @param file_number The friend-specific file number of the incoming transfer.
+ * @param path A NUL-terminated path to the destination file.
+ *
+ * @return true on success.
+ */
+bool tox_file_set_sink(Tox *tox, uint32_t friend_number, uint32_t file_number, char const *path, TOX_ERR_FILE_SET_SINK *error);
+
+
+/**
+ * The function type for the `file_progress` callback.
+ *
+ * This function is called for file transfers whose data is handled by the
+ * library itself (see tox_file_set_sink) instead of the client.
+ *
+ * If position is equal to the file size, the transfer has completed and the
+ * file has been closed.
+ *
+ * @param friend_number The friend number of the friend the file is being
+ *   transferred with.
+ * @param file_number The friend-specific file number of the transfer.
+ * @param position The number of bytes transferred so far.
+ */
+typedef void tox_file_progress_cb(Tox *tox, uint32_t friend_number, uint32_t file_number, uint64_t position, void *user_data);
+
+/**
+ * Set the callback for the `file_progress` event. Pass NULL to unset.
+ */
+void tox_callback_file_progress(Tox *tox, tox_file_progress_cb *function, void *user_data);
+
+
 /*******************************************************************************
  *
  * :: Group chat management
@@ -1,13 +1,22 @@
 #define Tox new_Tox
 #define Tox_Options new_Tox_Options
+#define Tox_Autosave_Stats new_Tox_Autosave_Stats
 #define TOX_PROXY_TYPE new_TOX_PROXY_TYPE
 #define tox_options_default new_tox_options_default
 #define tox_options_new new_tox_options_new
 #define tox_options_free new_tox_options_free
 #define tox_new new_tox_new
+#define tox_new_from_file new_tox_new_from_file
 #define tox_kill new_tox_kill
 #define tox_save_size new_tox_save_size
 #define tox_save new_tox_save
+#define tox_save_formatted_size new_tox_save_formatted_size
+#define tox_save_formatted new_tox_save_formatted
+#define tox_set_autosave new_tox_set_autosave
+#define tox_get_autosave_stats new_tox_get_autosave_stats
+#define tox_set_autosave_format new_tox_set_autosave_format
+#define Tox_Memory_Usage new_Tox_Memory_Usage
+#define tox_get_memory_usage new_tox_get_memory_usage
 #define tox_load new_tox_load
 #define tox_bootstrap new_tox_bootstrap
 #define tox_add_tcp_relay new_tox_add_tcp_relay
@@ -15,6 +24,13 @@
 #define tox_callback_connection_status new_tox_callback_connection_status
 #define tox_iteration_interval new_tox_iteration_interval
 #define tox_iteration new_tox_iteration
+#define tox_set_max_iteration_interval new_tox_set_max_iteration_interval
+#define tox_iteration_due new_tox_iteration_due
+#define tox_iteration_wakeups new_tox_iteration_wakeups
+#define tox_set_event_budget new_tox_set_event_budget
+#define tox_set_event_backlog new_tox_set_event_backlog
+#define Tox_Event_Budget_Stats new_Tox_Event_Budget_Stats
+#define tox_get_event_budget_stats new_tox_get_event_budget_stats
 #define tox_self_get_address new_tox_self_get_address
 #define tox_self_set_nospam new_tox_self_set_nospam
 #define tox_self_get_nospam new_tox_self_get_nospam
@@ -61,8 +77,11 @@
 #define tox_file_send new_tox_file_send
 #define tox_file_send_chunk new_tox_file_send_chunk
 #define tox_callback_file_request_chunk new_tox_callback_file_request_chunk
+#define tox_file_send_from_path new_tox_file_send_from_path
 #define tox_callback_file_receive new_tox_callback_file_receive
 #define tox_callback_file_receive_chunk new_tox_callback_file_receive_chunk
+#define tox_file_set_sink new_tox_file_set_sink
+#define tox_callback_file_progress new_tox_callback_file_progress
 #define tox_send_lossy_packet new_tox_send_lossy_packet
 #define tox_callback_friend_lossy_packet new_tox_callback_friend_lossy_packet
 #define tox_send_lossless_packet new_tox_send_lossless_packet
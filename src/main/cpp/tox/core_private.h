@@ -4,52 +4,24 @@
 #include <tox/tox.h>
 
 #include <cassert>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <algorithm>
-#include <fstream>
+#include <chrono>
+#include <deque>
 #include <map>
 #include <vector>
 
+#include "autosave.h"
 #include "logging.h"
+#include "memory.h"
+#include "savedata.h"
 
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 
-#define DEBUG_CALLBACKS 0
-
-
-#if DEBUG_CALLBACKS
-struct log_stream
-{
-  log_stream ()
-  {
-    out.open ("tox.log", std::ofstream::out | std::ofstream::app);
-  }
-
-  ~log_stream ()
-  {
-    out << "\n";
-  }
-
-  std::ofstream out;
-};
-
-#undef LOG
-#define LOG(severity) log_stream ().out
-
-
-static int
-id (void *p)
-{
-  static int counter = 0;
-  static std::map<void *, int> ids;
-  auto found = ids.find (p);
-  if (found != ids.end ())
-    return found->second;
-  ids[p] = ++counter;
-  return counter;
-}
-
-
 static char const *
 string_of_control_type (uint8_t type)
 {
@@ -63,7 +35,6 @@ string_of_control_type (uint8_t type)
     default: return "<unknown control>";
     }
 }
-#endif
 
 
 template<typename FuncT>
@@ -81,7 +52,7 @@ struct file_transfer
     INITIAL,
     SELF,
     FRIEND
-  } cause;
+  } cause = INITIAL;
 
   enum transfer_state
   {
@@ -93,8 +64,36 @@ struct file_transfer
   uint64_t position = 0;
   uint64_t file_size = 0;
 
-  bool event_pending = false;
-  size_t size_requested = 0;
+  // Sending side: the client may have several chunk requests outstanding at
+  // once. Requests are answered in order, so we keep them in a queue and the
+  // end position of the last request in `requested`.
+  struct chunk_request
+  {
+    uint64_t position;
+    size_t length;
+  };
+  std::deque<chunk_request> requests;
+  uint64_t requested = 0;
+  // End of the furthest chunk ever requested. Answers are tagged with their
+  // position, so answers to dropped requests are recognised and discarded;
+  // positions at or beyond this were never requested at all.
+  uint64_t max_requested = 0;
+  // Number of chunk requests we allow to be outstanding. Grows by one with
+  // every chunk toxcore accepts and halves when its send queue is full.
+  size_t window = initial_window;
+
+  static size_t const initial_window = 4;
+  static size_t const max_window = 64;
+
+  // File descriptor of the sink set with tox_file_set_sink (receiving side)
+  // or of the source opened by tox_file_send_from_path (sending side), or -1
+  // if the client handles the data itself.
+  int fd = -1;
+  // Whether data was moved since the last file_progress event.
+  bool progress = false;
+  // Receiving side: paused because the event budget was exceeded. Resumed at
+  // the start of the next iteration.
+  bool throttled = false;
 
   file_transfer () { }
 
@@ -117,6 +116,173 @@ struct file_transfer
   {
     return file_number & 0x100;
   }
+
+  // Forget the outstanding chunk requests and request the data again from
+  // the current position once running. Clients may or may not answer the
+  // dropped requests; either way, the answers don't match the position and
+  // are discarded by tox_file_send_chunk.
+  void drop_requests ()
+  {
+    requests.clear ();
+    requested = position;
+  }
+
+  // Read the next chunk from the source. Returns the number of bytes read,
+  // which is less than length only at the end of the file, or -1 on error.
+  ssize_t read (uint8_t *data, size_t length) const
+  {
+    ssize_t result;
+    do
+      result = pread (fd, data, length, position);
+    while (result == -1 && errno == EINTR);
+    return result;
+  }
+
+  // Write a received chunk to the sink at the current position.
+  bool write (uint8_t const *data, size_t length) const
+  {
+    uint64_t offset = position;
+    while (length != 0)
+      {
+        ssize_t written = pwrite (fd, data, length, offset);
+        if (written == -1)
+          {
+            if (errno == EINTR)
+              continue;
+            return false;
+          }
+        data += written;
+        length -= written;
+        offset += written;
+      }
+    return true;
+  }
+
+  void close_file ()
+  {
+    if (fd != -1)
+      close (fd);
+    fd = -1;
+  }
+};
+
+
+// Bounds the payload passed to the client's event callbacks within one
+// iteration. Clients typically buffer all events of an iteration, so without
+// a bound a fast file transfer grows that buffer without limit.
+struct event_budget
+{
+  // 0 means no limit.
+  size_t limit = 0;
+  TOX_EVENT_OVERFLOW overflow = TOX_EVENT_OVERFLOW_PAUSE_TRANSFERS;
+  // Events from earlier iterations that the client still holds, charged at
+  // the start of each iteration.
+  size_t backlog = 0;
+  size_t used = 0;
+
+  uint64_t high_watermark = 0;
+  uint64_t overflows = 0;
+  uint64_t paused = 0;
+  uint64_t dropped = 0;
+
+  bool exceeded () const
+  {
+    return limit != 0 && used > limit;
+  }
+
+  bool exceeded (TOX_EVENT_OVERFLOW policy) const
+  {
+    return overflow == policy && exceeded ();
+  }
+
+  void charge (size_t length)
+  {
+    bool was_exceeded = exceeded ();
+    used += length;
+    high_watermark = std::max (high_watermark, (uint64_t) used);
+    if (!was_exceeded && exceeded ())
+      overflows++;
+  }
+};
+
+
+// Decides how long an instance may sleep between iterations. While there is
+// work in flight (file transfers, calls), we wake up more often than the
+// underlying library asks for. When idle, the interval grows exponentially
+// from the library's value up to a configurable cap.
+struct iteration_policy
+{
+  static uint32_t const active_interval = TOX_MIN_ITERATION_INTERVAL;
+  static uint32_t const default_max_interval = 1000;
+
+  uint32_t max_interval = default_max_interval;
+  uint32_t idle_interval = 0;
+
+  // Wake-up accounting: number of iterations in the current one-second
+  // window, and the count of the last complete window.
+  uint32_t wakeups = 0;
+  uint32_t wakeups_per_second = 0;
+  std::chrono::steady_clock::time_point window_start = std::chrono::steady_clock::now ();
+  // End of the last iteration. The epoch until the first one.
+  std::chrono::steady_clock::time_point last_iteration;
+
+  // A cap below the busy interval would make every client spin.
+  bool set_max_interval (uint32_t max)
+  {
+    if (max < active_interval)
+      return false;
+    max_interval = max;
+    return true;
+  }
+
+  // The window only rolls over in iterated, so once iterations stop, the
+  // pending window is the last complete one, and after that it was empty.
+  uint32_t last_wakeups_per_second () const
+  {
+    auto elapsed = std::chrono::steady_clock::now () - window_start;
+    if (elapsed < std::chrono::seconds (1))
+      return wakeups_per_second;
+    if (elapsed < std::chrono::seconds (2))
+      return wakeups;
+    return 0;
+  }
+
+  // Whether interval milliseconds have passed since the last iteration.
+  bool due (uint32_t interval) const
+  {
+    return std::chrono::steady_clock::now () - last_iteration >= std::chrono::milliseconds (interval);
+  }
+
+  // Interval to report to the client. A busy instance has data to move and
+  // is woken up at least every active_interval milliseconds.
+  uint32_t interval (uint32_t base, bool busy) const
+  {
+    if (busy)
+      return std::min (base, (uint32_t) active_interval);
+    return std::min (std::max (base, idle_interval), max_interval);
+  }
+
+  // Called at the end of each iteration. The idle interval is stretched only
+  // while nothing at all happens on the instance.
+  void iterated (uint32_t base, bool idle)
+  {
+    if (!idle)
+      idle_interval = 0;
+    else if (idle_interval == 0)
+      idle_interval = base;
+    else if (idle_interval < max_interval)
+      idle_interval = std::min (idle_interval * 2, max_interval);
+
+    auto now = std::chrono::steady_clock::now ();
+    last_iteration = now;
+    wakeups++;
+    if (now - window_start >= std::chrono::seconds (1))
+      {
+        wakeups_per_second = wakeups;
+        wakeups = 0;
+        window_start = now;
+      }
+  }
 };
 
 
@@ -125,7 +291,19 @@ struct new_Tox
   Tox *tox;
   bool connected = false;
   bool has_av = false;
+  // Set by the callbacks below whenever toxcore delivers an event.
+  bool had_events = false;
   std::map<std::pair<uint32_t, uint32_t>, file_transfer> transfers;
+  // Scratch buffer for chunks read from file sources.
+  std::vector<uint8_t> file_buffer;
+  iteration_policy iteration;
+  event_budget budget;
+  autosave_writer autosave;
+  TOX_SAVE_FORMAT autosave_format = TOX_SAVE_FORMAT_PLAIN;
+  // Reused for autosave snapshots.
+  std::vector<uint8_t> save_buffer;
+  // Heap growth while toxcore created the instance, for tox_get_memory_usage.
+  size_t core_footprint = 0;
 
   struct
   {
@@ -143,49 +321,53 @@ struct new_Tox
     callback<tox_file_request_chunk_cb> file_request_chunk;
     callback<tox_file_receive_cb> file_receive;
     callback<tox_file_receive_chunk_cb> file_receive_chunk;
+    callback<tox_file_progress_cb> file_progress;
     callback<tox_friend_lossy_packet_cb> friend_lossy_packet;
     callback<tox_friend_lossless_packet_cb> friend_lossless_packet;
   } callbacks;
 
   struct CB
   {
-    static void friend_request (Tox *tox, const uint8_t *public_key, const uint8_t *data, uint16_t length, void *userdata)
+    static new_Tox *from_userdata (void *userdata)
     {
-#if DEBUG_CALLBACKS
-      LOG (INFO) << lwt::format ("CB friend_request (#%d, %p, %p, %d)", id (tox), public_key, data, length);
-#endif
       auto self = static_cast<new_Tox *> (userdata);
+      self->had_events = true;
+      return self;
+    }
+
+    static void friend_request (Tox *tox, const uint8_t *public_key, const uint8_t *data, uint16_t length, void *userdata)
+    {
+      LOG (TRACE, "CB friend_request ({}, {}, {}, {})", tox, log_hex (public_key, TOX_PUBLIC_KEY_SIZE), data, length);
+      auto self = from_userdata (userdata);
       auto cb = self->callbacks.friend_request;
+      self->budget.charge (length);
       cb.func (self, public_key, data, length, cb.user_data);
     }
 
     static void friend_message (Tox *tox, int32_t friendnumber, const uint8_t * message, uint16_t length, void *userdata)
     {
-#if DEBUG_CALLBACKS
-      LOG (INFO) << lwt::format ("CB friend_message (#%d, %d, %p, %d)", id (tox), friendnumber, message, length);
-#endif
-      auto self = static_cast<new_Tox *> (userdata);
+      LOG (TRACE, "CB friend_message ({}, {}, {}, {})", tox, friendnumber, message, length);
+      auto self = from_userdata (userdata);
       auto cb = self->callbacks.friend_message;
+      self->budget.charge (length);
       cb.func (self, friendnumber, message, length, cb.user_data);
     }
 
     static void friend_action (Tox *tox, int32_t friendnumber, const uint8_t * action, uint16_t length, void *userdata)
     {
-#if DEBUG_CALLBACKS
-      LOG (INFO) << lwt::format ("CB friend_action (#%d, %d, %p, %d)", id (tox), friendnumber, action, length);
-#endif
-      auto self = static_cast<new_Tox *> (userdata);
+      LOG (TRACE, "CB friend_action ({}, {}, {}, {})", tox, friendnumber, action, length);
+      auto self = from_userdata (userdata);
       auto cb = self->callbacks.friend_action;
+      self->budget.charge (length);
       cb.func (self, friendnumber, action, length, cb.user_data);
     }
 
     static void name_change (Tox *tox, int32_t friendnumber, const uint8_t *newname, uint16_t length, void *userdata)
     {
-#if DEBUG_CALLBACKS
-      LOG (INFO) << lwt::format ("CB name_change (#%d, %d, %p, %d)", id (tox), friendnumber, newname, length);
-#endif
-      auto self = static_cast<new_Tox *> (userdata);
+      LOG (TRACE, "CB name_change ({}, {}, {}, {})", tox, friendnumber, newname, length);
+      auto self = from_userdata (userdata);
       auto cb = self->callbacks.friend_name;
+      self->budget.charge (length);
       if (length == 1 && newname[0] == '\0')
         cb.func (self, friendnumber, nullptr, 0, cb.user_data);
       else
@@ -194,11 +376,10 @@ struct new_Tox
 
     static void status_message (Tox *tox, int32_t friendnumber, const uint8_t *newstatus, uint16_t length, void *userdata)
     {
-#if DEBUG_CALLBACKS
-      LOG (INFO) << lwt::format ("CB status_message (#%d, %d, %p, %d)", id (tox), friendnumber, newstatus, length);
-#endif
-      auto self = static_cast<new_Tox *> (userdata);
+      LOG (TRACE, "CB status_message ({}, {}, {}, {})", tox, friendnumber, newstatus, length);
+      auto self = from_userdata (userdata);
       auto cb = self->callbacks.friend_status_message;
+      self->budget.charge (length);
       if (length == 1 && newstatus[0] == '\0')
         cb.func (self, friendnumber, nullptr, 0, cb.user_data);
       else
@@ -207,53 +388,44 @@ struct new_Tox
 
     static void user_status (Tox *tox, int32_t friendnumber, uint8_t TOX_USERSTATUS, void *userdata)
     {
-#if DEBUG_CALLBACKS
-      LOG (INFO) << lwt::format ("CB user_status (#%d, %d, %d)", id (tox), friendnumber, TOX_USERSTATUS);
-#endif
-      auto self = static_cast<new_Tox *> (userdata);
+      LOG (TRACE, "CB user_status ({}, {}, {})", tox, friendnumber, TOX_USERSTATUS);
+      auto self = from_userdata (userdata);
       auto cb = self->callbacks.friend_status;
       cb.func (self, friendnumber, (TOX_STATUS) TOX_USERSTATUS, cb.user_data);
     }
 
     static void typing_change (Tox *tox, int32_t friendnumber, uint8_t is_typing, void *userdata)
     {
-#if DEBUG_CALLBACKS
-      LOG (INFO) << lwt::format ("CB typing_change (#%d, %d, %d)", id (tox), friendnumber, is_typing);
-#endif
-      auto self = static_cast<new_Tox *> (userdata);
+      LOG (TRACE, "CB typing_change ({}, {}, {})", tox, friendnumber, is_typing);
+      auto self = from_userdata (userdata);
       auto cb = self->callbacks.friend_typing;
       cb.func (self, friendnumber, is_typing, cb.user_data);
     }
 
     static void read_receipt (Tox *tox, int32_t friendnumber, uint32_t receipt, void *userdata)
     {
-#if DEBUG_CALLBACKS
-      LOG (INFO) << lwt::format ("CB read_receipt (#%d, %d, %d)", id (tox), friendnumber, receipt);
-#endif
-      auto self = static_cast<new_Tox *> (userdata);
+      LOG (TRACE, "CB read_receipt ({}, {}, {})", tox, friendnumber, receipt);
+      auto self = from_userdata (userdata);
       auto cb = self->callbacks.read_receipt;
       cb.func (self, friendnumber, receipt, cb.user_data);
     }
 
     static void connection_status (Tox *tox, int32_t friendnumber, uint8_t status, void *userdata)
     {
-#if DEBUG_CALLBACKS
-      LOG (INFO) << lwt::format ("CB connection_status (#%d, %d, %d)", id (tox), friendnumber, status);
-#endif
-      auto self = static_cast<new_Tox *> (userdata);
+      LOG (TRACE, "CB connection_status ({}, {}, {})", tox, friendnumber, status);
+      auto self = from_userdata (userdata);
       auto cb = self->callbacks.friend_connection_status;
       cb.func (self, friendnumber, status ? TOX_CONNECTION_UDP4 : TOX_CONNECTION_NONE, cb.user_data);
     }
 
     static void file_send_request (Tox *tox, int32_t friendnumber, uint8_t filenumber, uint64_t filesize, const uint8_t *filename, uint16_t filename_length, void *userdata)
     {
-#if DEBUG_CALLBACKS
-      LOG (INFO) << lwt::format ("CB file_send_request (#%d, %d, %d, %ld, %p, %d)", id (tox), friendnumber, filenumber, filesize, filename, filename_length);
-#endif
-      auto self = static_cast<new_Tox *> (userdata);
+      LOG (TRACE, "CB file_send_request ({}, {}, {}, {}, {}, {})", tox, friendnumber, filenumber, filesize, filename, filename_length);
+      auto self = from_userdata (userdata);
       auto cb = self->callbacks.file_receive;
 
       self->add_transfer (friendnumber, filenumber | 0x100, filesize);
+      self->budget.charge (filename_length);
 
       // XXX: it's always DATA. We could break protocol and send it in one of
       // the filesize bits, but then we would no longer be able to send to old
@@ -264,10 +436,8 @@ struct new_Tox
 
     static void file_control (Tox *tox, int32_t friendnumber, uint8_t receive_send, uint8_t filenumber, uint8_t control_type, const uint8_t *data, uint16_t length, void *userdata)
     {
-#if DEBUG_CALLBACKS
-      LOG (INFO) << lwt::format ("CB file_control (#%d, %d, %d, %d, %s, %p, %d)", id (tox), friendnumber, receive_send, filenumber, string_of_control_type (control_type), data, length);
-#endif
-      auto self = static_cast<new_Tox *> (userdata);
+      LOG (TRACE, "CB file_control ({}, {}, {}, {}, {}, {}, {})", tox, friendnumber, receive_send, filenumber, string_of_control_type (control_type), data, length);
+      auto self = from_userdata (userdata);
 
       uint32_t file_number = file_transfer::new_file_number (receive_send, filenumber);
       file_transfer *transfer = self->get_transfer (friendnumber, file_number);
@@ -280,7 +450,7 @@ struct new_Tox
           control = TOX_FILE_CONTROL_RESUME;
           break;
         case TOX_FILECONTROL_PAUSE:
-          assert (false);
+          // The receiver is applying backpressure.
           control = TOX_FILE_CONTROL_PAUSE;
           break;
         case TOX_FILECONTROL_KILL:
@@ -288,6 +458,15 @@ struct new_Tox
           control = TOX_FILE_CONTROL_PAUSE;
           break;
         case TOX_FILECONTROL_FINISHED:
+          if (transfer->fd != -1)
+            {
+              // The library sent the data itself, so the client only learns
+              // about completion through a final progress event.
+              transfer->close_file ();
+              self->report_progress (friendnumber, file_number, *transfer);
+              self->remove_transfer (friendnumber, file_number);
+              return;
+            }
           {
             // We're done, send a request for 0 bytes to let the client know.
             auto cb = self->callbacks.file_request_chunk;
@@ -309,10 +488,13 @@ struct new_Tox
       switch (control)
         {
         case TOX_FILE_CONTROL_PAUSE:
-          assert (false);
+          transfer->state = file_transfer::PAUSED;
+          transfer->cause = file_transfer::FRIEND;
+          transfer->drop_requests ();
           break;
         case TOX_FILE_CONTROL_RESUME:
           transfer->state = file_transfer::RUNNING;
+          transfer->drop_requests ();
           break;
         case TOX_FILE_CONTROL_CANCEL:
           assert (false);
@@ -325,16 +507,33 @@ struct new_Tox
 
     static void file_data (Tox *tox, int32_t friendnumber, uint8_t filenumber, const uint8_t *data, uint16_t length, void *userdata)
     {
-#if DEBUG_CALLBACKS
-      LOG (INFO) << lwt::format ("CB file_data (#%d, %d, %d, %p, %d)", id (tox), friendnumber, filenumber, data, length);
-#endif
-      auto self = static_cast<new_Tox *> (userdata);
+      LOG (TRACE, "CB file_data ({}, {}, {}, {}, {})", tox, friendnumber, filenumber, data, length);
+      auto self = from_userdata (userdata);
 
       file_transfer *transfer = self->get_transfer (friendnumber, filenumber | 0x100);
       assert (transfer != nullptr);
 
-      auto cb = self->callbacks.file_receive_chunk;
-      cb.func (self, friendnumber, filenumber | 0x100, transfer->position, data, length, cb.user_data);
+      if (transfer->fd != -1 && !transfer->write (data, length))
+        // Fall back to passing the data to the client.
+        transfer->close_file ();
+
+      if (transfer->fd != -1)
+        transfer->progress = true;
+      else
+        {
+          auto cb = self->callbacks.file_receive_chunk;
+          cb.func (self, friendnumber, filenumber | 0x100, transfer->position, data, length, cb.user_data);
+          self->budget.charge (length);
+
+          if (self->budget.exceeded (TOX_EVENT_OVERFLOW_PAUSE_TRANSFERS)
+              && !transfer->throttled
+              && transfer->position + length < transfer->file_size
+              && tox_file_send_control (tox, friendnumber, 1, filenumber, TOX_FILECONTROL_PAUSE, nullptr, 0) == 0)
+            {
+              transfer->throttled = true;
+              self->budget.paused++;
+            }
+        }
 
       transfer->position += length;
 
@@ -342,27 +541,38 @@ struct new_Tox
         {
           int result = tox_file_send_control (tox, friendnumber, 1, filenumber, TOX_FILECONTROL_FINISHED, nullptr, 0);
           assert (result == 0);
+
+          if (transfer->progress)
+            {
+              // Close the sink before reporting completion, so the client
+              // sees a complete file.
+              transfer->close_file ();
+              self->report_progress (friendnumber, filenumber | 0x100, *transfer);
+            }
         }
     }
 
     static int lossy_packet (Tox *tox, int32_t friendnumber, const uint8_t *data, uint32_t length, void *userdata)
     {
-#if DEBUG_CALLBACKS
-      LOG (INFO) << lwt::format ("CB lossy_packet (#%d, %d, %p, %d)", id (tox), friendnumber, data, length);
-#endif
-      auto self = static_cast<new_Tox *> (userdata);
+      LOG (TRACE, "CB lossy_packet ({}, {}, {}, {})", tox, friendnumber, data, length);
+      auto self = from_userdata (userdata);
+      if (self->budget.exceeded (TOX_EVENT_OVERFLOW_DROP_LOSSY))
+        {
+          self->budget.dropped++;
+          return 0;
+        }
       auto cb = self->callbacks.friend_lossy_packet;
+      self->budget.charge (length);
       cb.func (self, friendnumber, data, length, cb.user_data);
       return 0;
     }
 
     static int lossless_packet (Tox *tox, int32_t friendnumber, const uint8_t *data, uint32_t length, void *userdata)
     {
-#if DEBUG_CALLBACKS
-      LOG (INFO) << lwt::format ("CB lossless_packet (#%d, %d, %p, %d)", id (tox), friendnumber, data, length);
-#endif
-      auto self = static_cast<new_Tox *> (userdata);
+      LOG (TRACE, "CB lossless_packet ({}, {}, {}, {})", tox, friendnumber, data, length);
+      auto self = from_userdata (userdata);
       auto cb = self->callbacks.friend_lossless_packet;
+      self->budget.charge (length);
       cb.func (self, friendnumber, data, length, cb.user_data);
       return 0;
     }
@@ -385,6 +595,27 @@ struct new_Tox
     tox_callback_file_data         (tox, CB::file_data        , this);
   }
 
+  ~new_Tox ()
+  {
+    for (auto &pair : transfers)
+      pair.second.close_file ();
+  }
+
+  void save_snapshot (autosave_writer::clock::time_point now)
+  {
+    // The writer compresses the snapshot itself, if it isn't skipped.
+    save_buffer.resize (tox_size (tox));
+    tox_save (tox, save_buffer.data ());
+    autosave.submit (save_buffer, now, autosave_format == TOX_SAVE_FORMAT_LZ4);
+  }
+
+  void report_progress (uint32_t friend_number, uint32_t file_number, file_transfer &transfer)
+  {
+    transfer.progress = false;
+    auto cb = callbacks.file_progress;
+    cb.func (this, friend_number, file_number, transfer.position, cb.user_data);
+  }
+
   void register_custom_packet_handlers (uint32_t friend_number)
   {
     for (uint8_t byte = 200; byte <= 254; byte++)
@@ -411,6 +642,7 @@ struct new_Tox
   {
     auto found = transfers.find (std::make_pair (friend_number, file_number));
     assert (found != transfers.end ());
+    found->second.close_file ();
     transfers.erase (found);
   }
 };
@@ -1,13 +1,22 @@
 #undef Tox
 #undef Tox_Options
+#undef Tox_Autosave_Stats
 #undef TOX_PROXY_TYPE
 #undef tox_options_default
 #undef tox_options_new
 #undef tox_options_free
 #undef tox_new
+#undef tox_new_from_file
 #undef tox_kill
 #undef tox_save_size
 #undef tox_save
+#undef tox_save_formatted_size
+#undef tox_save_formatted
+#undef tox_set_autosave
+#undef tox_get_autosave_stats
+#undef tox_set_autosave_format
+#undef Tox_Memory_Usage
+#undef tox_get_memory_usage
 #undef tox_load
 #undef tox_bootstrap
 #undef tox_add_tcp_relay
@@ -15,6 +24,13 @@
 #undef tox_callback_connection_status
 #undef tox_iteration_interval
 #undef tox_iteration
+#undef tox_set_max_iteration_interval
+#undef tox_iteration_due
+#undef tox_iteration_wakeups
+#undef tox_set_event_budget
+#undef tox_set_event_backlog
+#undef Tox_Event_Budget_Stats
+#undef tox_get_event_budget_stats
 #undef tox_self_get_address
 #undef tox_self_set_nospam
 #undef tox_self_get_nospam
@@ -61,8 +77,11 @@
 #undef tox_file_send
 #undef tox_file_send_chunk
 #undef tox_callback_file_request_chunk
+#undef tox_file_send_from_path
 #undef tox_callback_file_receive
 #undef tox_callback_file_receive_chunk
+#undef tox_file_set_sink
+#undef tox_callback_file_progress
 #undef tox_send_lossy_packet
 #undef tox_callback_friend_lossy_packet
 #undef tox_send_lossless_packet
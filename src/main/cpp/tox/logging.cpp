@@ -1,34 +1,331 @@
 #include "logging.h"
 
-#include <iostream>
-#include <iomanip>
-#include <iterator>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 
-std::size_t scope_counter::scope;
+std::atomic<uint8_t> log_threshold (LOG_OFF);
 
-std::ostream &
-scope_indent (std::ostream &os, int line)
+typedef std::chrono::steady_clock log_clock;
+
+static log_clock::time_point const log_epoch = log_clock::now ();
+
+
+static char const hex_table[] =
+  "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+  "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+  "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+  "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+  "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+  "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+  "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+  "e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+void
+hex_encode (uint8_t const *data, size_t size, char *out)
+{
+  for (size_t i = 0; i < size; i++)
+    {
+      char const *pair = hex_table + 2 * data[i];
+      out[2 * i + 0] = pair[0];
+      out[2 * i + 1] = pair[1];
+    }
+}
+
+
+namespace
+{
+  // Single producer (the owning thread), single consumer (the drainer).
+  // head and tail count records ever written and read; their difference is
+  // the fill level.
+  struct log_ring
+  {
+    static size_t const capacity = 256;
+
+    std::atomic<size_t> head { 0 };
+    std::atomic<size_t> tail { 0 };
+    std::atomic<uint32_t> dropped { 0 };
+    // Set when the owning thread exits. The drainer frees the ring once it
+    // has been emptied.
+    std::atomic<bool> abandoned { false };
+    uint32_t thread;
+    log_record records[capacity];
+  };
+
+  struct thread_ring
+  {
+    log_ring *ring = nullptr;
+
+    ~thread_ring ()
+    {
+      if (ring != nullptr)
+        ring->abandoned.store (true, std::memory_order_release);
+    }
+  };
+
+  thread_local thread_ring current;
+
+
+  struct log_drainer
+  {
+    log_drainer ()
+    {
+      if (char const *path = std::getenv ("TOX4J_LOG_FILE"))
+        set_file (path);
+      if (char const *level = std::getenv ("TOX4J_LOG_LEVEL"))
+        {
+          static char const *const names[] = { "trace", "debug", "info", "warning", "error" };
+          for (uint8_t i = 0; i < LOG_OFF; i++)
+            if (std::strcmp (level, names[i]) == 0)
+              log_threshold.store (i, std::memory_order_relaxed);
+        }
+    }
+
+    ~log_drainer ()
+    {
+      {
+        std::lock_guard<std::mutex> lock (mutex);
+        stopping = true;
+      }
+      wakeup.notify_one ();
+      if (thread.joinable ())
+        thread.join ();
+      drain ();
+      if (sink != stderr)
+        std::fclose (sink);
+    }
+
+    log_ring *add_ring ()
+    {
+      std::unique_ptr<log_ring> ring (new log_ring);
+      std::lock_guard<std::mutex> lock (mutex);
+      ring->thread = ++thread_count;
+      rings.push_back (std::move (ring));
+      if (!thread.joinable () && !stopping)
+        thread = std::thread ([this] { run (); });
+      return rings.back ().get ();
+    }
+
+    bool set_file (char const *path)
+    {
+      FILE *file = stderr;
+      if (path != nullptr)
+        {
+          file = std::fopen (path, "a");
+          if (file == nullptr)
+            return false;
+        }
+
+      std::lock_guard<std::mutex> lock (mutex);
+      drain_locked ();
+      if (sink != stderr)
+        std::fclose (sink);
+      sink = file;
+      return true;
+    }
+
+    void drain ()
+    {
+      std::lock_guard<std::mutex> lock (mutex);
+      drain_locked ();
+    }
+
+  private:
+    void run ()
+    {
+      std::unique_lock<std::mutex> lock (mutex);
+      while (!stopping)
+        {
+          drain_locked ();
+          wakeup.wait_for (lock, std::chrono::milliseconds (10));
+        }
+    }
+
+    void drain_locked ()
+    {
+      line.clear ();
+      for (auto &ring : rings)
+        {
+          size_t tail = ring->tail.load (std::memory_order_relaxed);
+          size_t const head = ring->head.load (std::memory_order_acquire);
+          for (; tail != head; tail++)
+            format_record (ring->thread, ring->records[tail % log_ring::capacity]);
+          ring->tail.store (tail, std::memory_order_release);
+
+          if (uint32_t dropped = ring->dropped.exchange (0, std::memory_order_relaxed))
+            append_dropped (ring->thread, dropped);
+        }
+
+      // Abandoned rings can no longer receive records, so once they are
+      // drained above, they can go.
+      rings.erase (std::remove_if (rings.begin (), rings.end (), [] (std::unique_ptr<log_ring> const &ring) {
+                     return ring->abandoned.load (std::memory_order_acquire)
+                         && ring->tail.load (std::memory_order_relaxed) == ring->head.load (std::memory_order_acquire);
+                   }), rings.end ());
+
+      if (!line.empty ())
+        {
+          std::fwrite (line.data (), 1, line.size (), sink);
+          std::fflush (sink);
+        }
+    }
+
+    void append_header (uint64_t time, uint32_t thread, char level)
+    {
+      char header[48];
+      int length = std::snprintf (header, sizeof header, "%c %llu.%06llu [%u] ",
+                                  level,
+                                  (unsigned long long) (time / 1000000000),
+                                  (unsigned long long) (time / 1000 % 1000000),
+                                  thread);
+      line.append (header, length);
+    }
+
+    void append_dropped (uint32_t thread, uint32_t dropped)
+    {
+      append_header (std::chrono::duration_cast<std::chrono::nanoseconds> (log_clock::now () - log_epoch).count (),
+                     thread, 'W');
+      line += std::to_string (dropped);
+      line += " log records dropped\n";
+    }
+
+    void append_arg (log_record const &record, size_t index)
+    {
+      uint64_t const value = record.args[index];
+      char number[32];
+      int length = 0;
+      switch (record.types[index])
+        {
+        case log_arg_type::signed_int:
+          length = std::snprintf (number, sizeof number, "%lld", (long long) (int64_t) value);
+          break;
+        case log_arg_type::unsigned_int:
+          length = std::snprintf (number, sizeof number, "%llu", (unsigned long long) value);
+          break;
+        case log_arg_type::floating:
+          {
+            double real;
+            std::memcpy (&real, &value, sizeof real);
+            length = std::snprintf (number, sizeof number, "%g", real);
+          }
+          break;
+        case log_arg_type::pointer:
+          length = std::snprintf (number, sizeof number, "%p", (void *) (uintptr_t) value);
+          break;
+        case log_arg_type::string:
+          line.append (record.blob + (value >> 32), uint32_t (value));
+          break;
+        case log_arg_type::hex:
+          {
+            size_t const offset = line.size ();
+            line.resize (offset + 2 * uint32_t (value));
+            hex_encode (reinterpret_cast<uint8_t const *> (record.blob + (value >> 32)), uint32_t (value), &line[offset]);
+          }
+          break;
+        }
+      line.append (number, length);
+    }
+
+    void format_record (uint32_t thread, log_record const &record)
+    {
+      append_header (record.time, thread, "TDIWE"[record.level]);
+
+      size_t arg = 0;
+      for (char const *p = record.format; *p != '\0'; p++)
+        {
+          if (p[0] == '{' && p[1] == '}' && arg < record.arg_count)
+            {
+              append_arg (record, arg++);
+              p++;
+            }
+          else
+            line += *p;
+        }
+      line += '\n';
+    }
+
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::thread thread;
+    bool stopping = false;
+    uint32_t thread_count = 0;
+    std::vector<std::unique_ptr<log_ring>> rings;
+    FILE *sink = stderr;
+    // Formatted output of one drain pass.
+    std::string line;
+  };
+
+  log_drainer drainer;
+}
+
+
+void
+log_set_level (log_level level)
+{
+  log_threshold.store (level, std::memory_order_relaxed);
+}
+
+
+bool
+log_set_file (char const *path)
+{
+  return drainer.set_file (path);
+}
+
+
+void
+log_flush ()
 {
-  for (std::size_t i = 0; i < scope_counter::scope - (line >= 1000); i++)
-    os << ' ';
-  return os;
+  drainer.drain ();
+}
+
+
+log_record *
+log_begin (log_level level, char const *format)
+{
+  log_ring *ring = current.ring;
+  if (ring == nullptr)
+    ring = current.ring = drainer.add_ring ();
+
+  size_t const head = ring->head.load (std::memory_order_relaxed);
+  if (head - ring->tail.load (std::memory_order_acquire) == log_ring::capacity)
+    {
+      ring->dropped.fetch_add (1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+  log_record &record = ring->records[head % log_ring::capacity];
+  record.time = std::chrono::duration_cast<std::chrono::nanoseconds> (log_clock::now () - log_epoch).count ();
+  record.format = format;
+  record.arg_count = 0;
+  record.blob_size = 0;
+  record.level = level;
+  return &record;
 }
 
 
 void
-output_hex (std::ostream &os, uint8_t const *data, size_t length)
+log_commit ()
 {
-  os << '[';
-  for (size_t i = 0; i < length; i++)
-    os << format ("%02x", data[i]);
-  os << ']';
+  log_ring *ring = current.ring;
+  ring->head.store (ring->head.load (std::memory_order_relaxed) + 1, std::memory_order_release);
 }
 
 
-std::ostream &
-operator << (std::ostream &os, formatter const &fmt)
+uint64_t
+log_copy (log_record &record, void const *data, size_t size)
 {
-  std::copy (fmt.text_.cbegin (), fmt.text_.cend (), std::ostream_iterator<char> (os));
-  return os;
+  size_t const offset = record.blob_size;
+  size = std::min (size, sizeof record.blob - offset);
+  std::memcpy (record.blob + offset, data, size);
+  record.blob_size += size;
+  return uint64_t (offset) << 32 | size;
 }
@@ -1,77 +1,200 @@
 #pragma once
 
 #include <array>
-#include <ostream>
-#include <vector>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+
+// Asynchronous binary logging. A log statement copies its arguments into a
+// fixed-size record in a ring buffer owned by the calling thread; it never
+// formats, allocates or takes a lock. A background thread drains all rings,
+// formats the records and writes them to the log sink. When a ring is full,
+// records are dropped and counted instead of blocking the caller.
+//
+//   LOG (INFO, "friend {} sent {} bytes", friend_number, length);
+//   LOG (TRACE, "public key {}", log_hex (key, TOX_PUBLIC_KEY_SIZE));
+//
+// Each {} in the format string is replaced by the next argument, formatted
+// according to its type. The format string must be a string literal, since
+// only its address is stored. String and hex arguments are copied into the
+// record and truncated if the record runs out of space.
+//
+// Logging is off by default. The level is taken from the TOX4J_LOG_LEVEL
+// environment variable (trace, debug, info, warning or error) at load time,
+// and the sink from TOX4J_LOG_FILE (default: stderr). Both can be changed at
+// runtime with log_set_level and log_set_file.
+
+enum log_level : uint8_t
+{
+  LOG_TRACE,
+  LOG_DEBUG,
+  LOG_INFO,
+  LOG_WARNING,
+  LOG_ERROR,
+  LOG_OFF,
+};
 
+extern std::atomic<uint8_t> log_threshold;
 
-struct scope_counter
+inline bool
+log_enabled (log_level level)
 {
-  static std::size_t scope;
+  return level >= log_threshold.load (std::memory_order_relaxed);
+}
 
-  scope_counter ()
-  { scope++; }
+void log_set_level (log_level level);
+// Returns false if the file could not be opened; the previous sink is kept.
+// A null path selects stderr.
+bool log_set_file (char const *path);
+// Write out everything that was logged before this call.
+void log_flush ();
 
-  ~scope_counter ()
-  { scope--; }
 
-  scope_counter (scope_counter const &rhs) = delete;
-};
+// Hex-encode size bytes into 2 * size characters at out. No terminator is
+// written.
+void hex_encode (uint8_t const *data, size_t size, char *out);
+
 
-std::ostream &scope_indent (std::ostream &os, int line);
+struct log_hex
+{
+  uint8_t const *data;
+  size_t size;
+
+  log_hex (uint8_t const *data, size_t size)
+    : data (data)
+    , size (size)
+  { }
 
-#define SCOPE scope_counter const _scope
+  template<size_t N>
+  log_hex (std::array<uint8_t, N> const &array)
+    : log_hex (array.data (), array.size ())
+  { }
+};
 
 
-#ifdef HAVE_GLOG
-#  include <glog/logging.h>
-#  undef LOG
-#  define LOG(KIND) scope_indent (COMPACT_GOOGLE_LOG_##KIND.stream(), __LINE__)
-#else
-struct null_ostream
-  : std::ostream
+enum class log_arg_type : uint8_t
 {
+  signed_int,
+  unsigned_int,
+  floating,
+  pointer,
+  string,
+  hex,
 };
 
-#  define LOG(LEVEL) (null_ostream ())
-#  define LOG_ASSERT(cond) assert (cond)
-#endif
+// One log statement. The size is fixed so that a ring is a plain array and
+// producing a record is a handful of stores.
+struct log_record
+{
+  static size_t const max_args = 8;
+  static size_t const size = 192;
+
+  uint64_t time;                // Nanoseconds since the logger was loaded.
+  char const *format;
+  uint64_t args[max_args];      // Values, or offset << 32 | length into blob.
+  log_arg_type types[max_args];
+  uint8_t arg_count;
+  uint8_t blob_size;
+  log_level level;
+  char blob[size - 3 - max_args - max_args * sizeof (uint64_t) - sizeof (char const *) - sizeof (uint64_t)];
+};
+
+static_assert (sizeof (log_record) == log_record::size, "log records must fit exactly into their ring slot");
+
+
+// Returns the calling thread's next free record, or nullptr if its ring is
+// full. The record becomes visible to the drainer with log_commit.
+log_record *log_begin (log_level level, char const *format);
+void log_commit ();
 
-void output_hex (std::ostream &os, uint8_t const *data, size_t length);
 
+// Argument packing, one overload per formatting class.
 
-struct formatter
+template<typename T>
+typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, log_arg_type>::type
+log_pack (log_record &, T value, uint64_t &slot)
 {
-  formatter (formatter &&fmt)
-    : text_ (std::move (fmt.text_))
-  { }
+  slot = static_cast<uint64_t> (static_cast<int64_t> (value));
+  return log_arg_type::signed_int;
+}
 
-  explicit formatter (std::vector<char> &&text)
-    : text_ (text)
-  { }
+template<typename T>
+typename std::enable_if<(std::is_integral<T>::value && !std::is_signed<T>::value) || std::is_enum<T>::value, log_arg_type>::type
+log_pack (log_record &, T value, uint64_t &slot)
+{
+  slot = static_cast<uint64_t> (value);
+  return log_arg_type::unsigned_int;
+}
 
-  friend std::ostream &operator << (std::ostream &os, formatter const &fmt);
+inline log_arg_type
+log_pack (log_record &, double value, uint64_t &slot)
+{
+  std::memcpy (&slot, &value, sizeof slot);
+  return log_arg_type::floating;
+}
 
-private:
-  std::vector<char> const text_;
-};
+inline log_arg_type
+log_pack (log_record &, void const *value, uint64_t &slot)
+{
+  slot = reinterpret_cast<uintptr_t> (value);
+  return log_arg_type::pointer;
+}
 
+// Copies as many bytes as still fit into the record's blob.
+uint64_t log_copy (log_record &record, void const *data, size_t size);
 
-template<size_t N, typename ...Args>
-formatter
-format (char const (&fmt)[N], Args const &...args)
+inline log_arg_type
+log_pack (log_record &record, char const *value, uint64_t &slot)
 {
-  std::vector<char> text (snprintf (nullptr, 0, fmt, args...) + 1);
-  snprintf (text.data (), text.size (), fmt, args...);
+  if (value == nullptr)
+    value = "(null)";
+  slot = log_copy (record, value, std::strlen (value));
+  return log_arg_type::string;
+}
 
-  return formatter (std::move (text));
+inline log_arg_type
+log_pack (log_record &record, log_hex value, uint64_t &slot)
+{
+  slot = log_copy (record, value.data, value.size);
+  return log_arg_type::hex;
 }
 
 
-template<std::size_t N>
-std::ostream &
-operator << (std::ostream &os, std::array<uint8_t, N> const &array)
+inline void
+log_pack_all (log_record &)
 {
-  output_hex (os, array.data (), array.size ());
-  return os;
 }
+
+template<typename Arg, typename ...Args>
+void
+log_pack_all (log_record &record, Arg const &arg, Args const &...args)
+{
+  uint8_t const index = record.arg_count++;
+  record.types[index] = log_pack (record, arg, record.args[index]);
+  log_pack_all (record, args...);
+}
+
+
+template<size_t N, typename ...Args>
+void
+log_write (log_level level, char const (&format)[N], Args const &...args)
+{
+  static_assert (sizeof... (Args) <= log_record::max_args, "too many log arguments");
+  if (log_record *record = log_begin (level, format))
+    {
+      log_pack_all (*record, args...);
+      log_commit ();
+    }
+}
+
+
+#define LOG(LEVEL, ...)                                 \
+  do                                                    \
+    {                                                   \
+      if (log_enabled (LOG_##LEVEL))                    \
+        log_write (LOG_##LEVEL, __VA_ARGS__);           \
+    }                                                   \
+  while (0)
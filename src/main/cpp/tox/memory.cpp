@@ -0,0 +1,21 @@
+#include "memory.h"
+
+#if defined (__GLIBC__) || defined (__ANDROID__)
+#include <malloc.h>
+#endif
+
+
+size_t
+heap_in_use ()
+{
+#if defined (__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  struct mallinfo2 info = mallinfo2 ();
+  return info.uordblks + info.hblkhd;
+#elif defined (__GLIBC__) || defined (__ANDROID__)
+  // The older interface has int fields, which wrap above 2 GiB.
+  struct mallinfo info = mallinfo ();
+  return (unsigned) info.uordblks + (unsigned) info.hblkhd;
+#else
+  return 0;
+#endif
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+// Approximate heap usage of containers, for tox_get_memory_usage and
+// toxav_get_memory_usage. Containers count their capacity, since that is
+// what they retain; allocator overhead is not included. Where the standard
+// library does not expose what it allocates (tree nodes, deque blocks), the
+// sizes are estimates based on the layouts of libstdc++ and libc++.
+
+template<typename T>
+static inline size_t
+heap_size (std::vector<T> const &v)
+{
+  return v.capacity () * sizeof (T);
+}
+
+static inline size_t
+heap_size (std::string const &s)
+{
+  // Short strings are stored inside the object.
+  char const *self = reinterpret_cast<char const *> (&s);
+  if (s.data () >= self && s.data () < self + sizeof s)
+    return 0;
+  return s.capacity () + 1;
+}
+
+// A tree node holds three pointers and a colour besides the value, in
+// libstdc++, libc++ and the Microsoft library alike.
+template<typename Key, typename Value>
+static inline size_t
+map_node_size (std::map<Key, Value> const &)
+{
+  return sizeof (std::pair<Key const, Value>) + 4 * sizeof (void *);
+}
+
+// A deque allocates fixed-size blocks of elements and a map of pointers to
+// them. With libraries other than the two below, only the elements count.
+template<typename T>
+static inline size_t
+heap_size (std::deque<T> const &d)
+{
+#if defined (__GLIBCXX__)
+  // 512-byte blocks, one more than the elements need, and a map of at least
+  // eight pointers. Even an empty deque holds a map and a block.
+  size_t const per_block = sizeof (T) < 512 ? 512 / sizeof (T) : 1;
+  size_t const blocks = d.size () / per_block + 1;
+  return blocks * per_block * sizeof (T) + std::max (blocks + 2, (size_t) 8) * sizeof (void *);
+#elif defined (_LIBCPP_VERSION)
+  // 4096-byte blocks of at least 16 elements, allocated on first use, and a
+  // pointer per block in the map.
+  size_t const per_block = sizeof (T) < 256 ? 4096 / sizeof (T) : 16;
+  size_t const blocks = (d.size () + per_block - 1) / per_block;
+  return blocks * (per_block * sizeof (T) + sizeof (void *));
+#else
+  return d.size () * sizeof (T);
+#endif
+}
+
+
+// Bytes currently allocated through malloc by the whole process, or 0 if the
+// C library cannot tell.
+size_t heap_in_use ();
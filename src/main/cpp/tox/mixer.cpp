@@ -0,0 +1,224 @@
+#include "mixer.h"
+#include "memory.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+// How many frames of audio a participant's ring buffer holds. Audio arriving
+// faster than it is mixed is dropped beyond this, which bounds the latency
+// the mixer adds.
+static size_t const buffered_frames = 4;
+
+
+// Add a frame of samples to the 32 bit running total.
+static void
+accumulate (int32_t *total, int16_t const *pcm, size_t length)
+{
+  size_t i = 0;
+#if defined(__SSE2__)
+  for (; i + 8 <= length; i += 8)
+    {
+      __m128i samples = _mm_loadu_si128 ((__m128i const *) (pcm + i));
+      // Sign-extend by placing each sample in the upper half of a 32 bit lane
+      // and shifting it down.
+      __m128i lo = _mm_srai_epi32 (_mm_unpacklo_epi16 (samples, samples), 16);
+      __m128i hi = _mm_srai_epi32 (_mm_unpackhi_epi16 (samples, samples), 16);
+      __m128i *dst = (__m128i *) (total + i);
+      _mm_storeu_si128 (dst + 0, _mm_add_epi32 (_mm_loadu_si128 (dst + 0), lo));
+      _mm_storeu_si128 (dst + 1, _mm_add_epi32 (_mm_loadu_si128 (dst + 1), hi));
+    }
+#endif
+  for (; i < length; i++)
+    total[i] += pcm[i];
+}
+
+
+// out = total - own, saturated to 16 bits.
+static void
+subtract_saturated (int16_t *out, int32_t const *total, int16_t const *own, size_t length)
+{
+  size_t i = 0;
+#if defined(__SSE2__)
+  for (; i + 8 <= length; i += 8)
+    {
+      __m128i samples = _mm_loadu_si128 ((__m128i const *) (own + i));
+      __m128i lo = _mm_srai_epi32 (_mm_unpacklo_epi16 (samples, samples), 16);
+      __m128i hi = _mm_srai_epi32 (_mm_unpackhi_epi16 (samples, samples), 16);
+      __m128i const *src = (__m128i const *) (total + i);
+      lo = _mm_sub_epi32 (_mm_loadu_si128 (src + 0), lo);
+      hi = _mm_sub_epi32 (_mm_loadu_si128 (src + 1), hi);
+      _mm_storeu_si128 ((__m128i *) (out + i), _mm_packs_epi32 (lo, hi));
+    }
+#endif
+  for (; i < length; i++)
+    out[i] = std::min (std::max (total[i] - own[i], int32_t (INT16_MIN)), int32_t (INT16_MAX));
+}
+
+
+void
+audio_mixer::configure (uint32_t sampling_rate, uint8_t channels, uint32_t frame_duration)
+{
+  this->sampling_rate = sampling_rate;
+  this->channels = channels;
+  this->frame_size = sampling_rate * frame_duration / 1000;
+  this->frame_length = frame_size * channels;
+  this->frame_duration = std::chrono::milliseconds (frame_duration);
+
+  total.resize (frame_length);
+  output.resize (frame_length);
+}
+
+
+bool
+audio_mixer::add (uint32_t friend_number)
+{
+  auto inserted = participants.insert (std::make_pair (friend_number, participant ()));
+  if (!inserted.second)
+    return false;
+
+  participant &self = inserted.first->second;
+  self.ring.resize (frame_length * buffered_frames);
+  self.current.resize (frame_length);
+  return true;
+}
+
+
+bool
+audio_mixer::remove (uint32_t friend_number)
+{
+  if (participants.erase (friend_number) == 0)
+    return false;
+
+  // Start the clock afresh when the next conference begins.
+  if (participants.empty ())
+    next_frame = clock::time_point ();
+  return true;
+}
+
+
+bool
+audio_mixer::contains (uint32_t friend_number) const
+{
+  return participants.find (friend_number) != participants.end ();
+}
+
+size_t
+audio_mixer::heap_size () const
+{
+  size_t size = ::heap_size (total) + ::heap_size (output);
+  for (auto const &pair : participants)
+    {
+      participant const &p = pair.second;
+      size += map_node_size (participants) + p.resampler.heap_size ()
+            + ::heap_size (p.converted) + ::heap_size (p.ring) + ::heap_size (p.current);
+    }
+  return size;
+}
+
+
+void
+audio_mixer::push (uint32_t friend_number, int16_t const *pcm, size_t sample_count, uint8_t channels, uint32_t sampling_rate)
+{
+  auto found = participants.find (friend_number);
+  if (found == participants.end ())
+    return;
+
+  participant &self = found->second;
+  self.resampler.configure (sampling_rate, channels, this->sampling_rate, this->channels);
+  self.converted.clear ();
+  self.resampler.process (pcm, sample_count, self.converted);
+
+  size_t const capacity = self.ring.size ();
+  int16_t const *src = self.converted.data ();
+  size_t length = self.converted.size ();
+  if (length > capacity)
+    {
+      src += length - capacity;
+      length = capacity;
+    }
+
+  // Make room by dropping the oldest samples.
+  if (self.available + length > capacity)
+    {
+      size_t dropped = self.available + length - capacity;
+      self.read = (self.read + dropped) % capacity;
+      self.available -= dropped;
+    }
+
+  size_t write = (self.read + self.available) % capacity;
+  size_t first = std::min (length, capacity - write);
+  std::memcpy (&self.ring[write], src, first * sizeof *src);
+  std::memcpy (&self.ring[0], src + first, (length - first) * sizeof *src);
+  self.available += length;
+}
+
+
+size_t
+audio_mixer::frames_due (clock::time_point now)
+{
+  if (participants.empty ())
+    return 0;
+
+  // Give the buffers one frame duration to fill before the first mix.
+  if (next_frame == clock::time_point ())
+    {
+      next_frame = now + frame_duration;
+      return 0;
+    }
+
+  size_t due = 0;
+  while (now >= next_frame && due < buffered_frames)
+    {
+      next_frame += frame_duration;
+      due++;
+    }
+
+  // If we fell further behind than the buffers reach, there is nothing left
+  // to catch up with.
+  if (now >= next_frame)
+    next_frame = now + frame_duration;
+
+  return due;
+}
+
+
+void
+audio_mixer::take_frames ()
+{
+  std::fill (total.begin (), total.end (), 0);
+
+  for (auto &pair : participants)
+    {
+      participant &self = pair.second;
+      size_t const capacity = self.ring.size ();
+
+      // Take up to a frame from the ring, padding with silence on underrun.
+      size_t length = std::min (self.available, frame_length);
+      size_t first = std::min (length, capacity - self.read);
+      // When the frame fills current, first may be its size; index it
+      // through data () so that the empty copy doesn't form &current[size].
+      std::memcpy (self.current.data (), self.ring.data () + self.read, first * sizeof self.current[0]);
+      std::memcpy (self.current.data () + first, self.ring.data (), (length - first) * sizeof self.current[0]);
+      std::fill (self.current.begin () + length, self.current.end (), 0);
+
+      self.read = (self.read + length) % capacity;
+      self.available -= length;
+
+      accumulate (total.data (), self.current.data (), frame_length);
+    }
+}
+
+
+int16_t const *
+audio_mixer::mix_for (participant const &self)
+{
+  // Everyone else is everyone minus self, so each mix costs one pass
+  // regardless of the number of participants.
+  subtract_saturated (output.data (), total.data (), self.current.data (), frame_length);
+  return output.data ();
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "resampler.h"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+
+// Mixes the audio of a set of friends for a conference. Each participant's
+// received audio is converted to the mixer format and queued in a ring
+// buffer. Once per frame duration, the mixer takes one frame from every
+// participant (silence if their buffer ran dry) and gives each participant
+// the sum of all the others.
+struct audio_mixer
+{
+  typedef std::chrono::steady_clock clock;
+
+  // Mixer format. Frames are frame_size samples per channel.
+  void configure (uint32_t sampling_rate, uint8_t channels, uint32_t frame_duration);
+
+  bool add (uint32_t friend_number);
+  bool remove (uint32_t friend_number);
+  bool contains (uint32_t friend_number) const;
+
+  // Queue received audio for a participant. If their buffer is full, the
+  // oldest samples are dropped to keep the latency bounded.
+  void push (uint32_t friend_number, int16_t const *pcm, size_t sample_count, uint8_t channels, uint32_t sampling_rate);
+
+  // Produce every frame that became due since the last call, passing each
+  // participant's mix to send (friend_number, pcm, frame_size, channels,
+  // sampling_rate).
+  template<typename Send>
+  void mix (clock::time_point now, Send send);
+
+  // Heap memory held by the participants' buffers and the mix, in bytes.
+  size_t heap_size () const;
+
+private:
+  struct participant
+  {
+    audio_resampler resampler;
+    std::vector<int16_t> converted;
+    // Ring buffer of received samples, interleaved in the mixer format.
+    std::vector<int16_t> ring;
+    size_t read = 0;
+    size_t available = 0;
+    // The frame taken from the ring for the current mix.
+    std::vector<int16_t> current;
+  };
+
+  size_t frames_due (clock::time_point now);
+  void take_frames ();
+  int16_t const *mix_for (participant const &self);
+
+  uint32_t sampling_rate = 0;
+  uint8_t channels = 0;
+  size_t frame_size = 0;
+  size_t frame_length = 0;
+  clock::duration frame_duration;
+  clock::time_point next_frame;
+
+  std::map<uint32_t, participant> participants;
+  std::vector<int32_t> total;
+  std::vector<int16_t> output;
+};
+
+
+template<typename Send>
+void
+audio_mixer::mix (clock::time_point now, Send send)
+{
+  for (size_t due = frames_due (now); due != 0; due--)
+    {
+      take_frames ();
+      for (auto const &pair : participants)
+        send (pair.first, mix_for (pair.second), frame_size, channels, sampling_rate);
+    }
+}
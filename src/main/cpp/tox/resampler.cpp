@@ -0,0 +1,336 @@
+#include "resampler.h"
+#include "memory.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HAVE_AVX2 1
+#endif
+
+
+static double const pi = 3.14159265358979323846;
+
+// Zero crossings of the sinc on either side of the centre tap. More gives a
+// steeper transition band at the cost of longer filters.
+static size_t const zero_crossings = 8;
+
+// Upper bound on the filter table size. Rate pairs with a reduced
+// denominator above this use the nearest of this many phases.
+static uint32_t const max_phases = 256;
+
+// Coefficients are stored in Q14, so the centre tap of an interpolating
+// filter (1.0) still fits into an int16_t.
+static int const coefficient_bits = 14;
+
+// Filter lengths are rounded up to a whole number of AVX2 vectors.
+static size_t const tap_alignment = 16;
+
+
+typedef int32_t dot_function (int16_t const *x, int16_t const *h, size_t taps);
+
+#if defined(__SSE2__)
+static inline int32_t
+horizontal_sum (__m128i v)
+{
+  v = _mm_add_epi32 (v, _mm_shuffle_epi32 (v, _MM_SHUFFLE (1, 0, 3, 2)));
+  v = _mm_add_epi32 (v, _mm_shuffle_epi32 (v, _MM_SHUFFLE (2, 3, 0, 1)));
+  return _mm_cvtsi128_si32 (v);
+}
+
+static int32_t
+dot_sse2 (int16_t const *x, int16_t const *h, size_t taps)
+{
+  __m128i acc = _mm_setzero_si128 ();
+  for (size_t i = 0; i < taps; i += 8)
+    {
+      __m128i xs = _mm_loadu_si128 ((__m128i const *) (x + i));
+      __m128i hs = _mm_loadu_si128 ((__m128i const *) (h + i));
+      acc = _mm_add_epi32 (acc, _mm_madd_epi16 (xs, hs));
+    }
+  return horizontal_sum (acc);
+}
+#else
+static int32_t
+dot_scalar (int16_t const *x, int16_t const *h, size_t taps)
+{
+  int32_t acc = 0;
+  for (size_t i = 0; i < taps; i++)
+    acc += int32_t (x[i]) * h[i];
+  return acc;
+}
+#endif
+
+#if HAVE_AVX2
+__attribute__ ((target ("avx2"))) static int32_t
+dot_avx2 (int16_t const *x, int16_t const *h, size_t taps)
+{
+  __m256i acc = _mm256_setzero_si256 ();
+  for (size_t i = 0; i < taps; i += 16)
+    {
+      __m256i xs = _mm256_loadu_si256 ((__m256i const *) (x + i));
+      __m256i hs = _mm256_loadu_si256 ((__m256i const *) (h + i));
+      acc = _mm256_add_epi32 (acc, _mm256_madd_epi16 (xs, hs));
+    }
+  __m128i sum = _mm_add_epi32 (_mm256_castsi256_si128 (acc), _mm256_extracti128_si256 (acc, 1));
+  return horizontal_sum (sum);
+}
+#endif
+
+static dot_function *
+select_dot ()
+{
+#if HAVE_AVX2
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx2"))
+    return dot_avx2;
+#endif
+#if defined(__SSE2__)
+  return dot_sse2;
+#else
+  return dot_scalar;
+#endif
+}
+
+static dot_function *const dot = select_dot ();
+
+
+static inline int16_t
+saturate (int32_t sample)
+{
+  return std::min (std::max (sample, int32_t (INT16_MIN)), int32_t (INT16_MAX));
+}
+
+
+// The most common case: stereo capture into a mono call.
+static void
+mix_stereo_to_mono (int16_t const *pcm, size_t count, int16_t *dst)
+{
+  size_t i = 0;
+#if defined(__SSE2__)
+  __m128i const ones = _mm_set1_epi16 (1);
+  for (; i + 8 <= count; i += 8)
+    {
+      __m128i a = _mm_loadu_si128 ((__m128i const *) (pcm + 2 * i));
+      __m128i b = _mm_loadu_si128 ((__m128i const *) (pcm + 2 * i + 8));
+      __m128i sum_a = _mm_srai_epi32 (_mm_madd_epi16 (a, ones), 1);
+      __m128i sum_b = _mm_srai_epi32 (_mm_madd_epi16 (b, ones), 1);
+      _mm_storeu_si128 ((__m128i *) (dst + i), _mm_packs_epi32 (sum_a, sum_b));
+    }
+#endif
+  for (; i < count; i++)
+    dst[i] = (int32_t (pcm[2 * i]) + pcm[2 * i + 1]) >> 1;
+}
+
+
+// Mix count interleaved samples per channel into the planes, starting at
+// offset. With fewer output than input channels, each output channel is the
+// average of every input channel congruent to it; with more, input channels
+// are repeated.
+static void
+mix (int16_t const *pcm, size_t count, size_t in_channels,
+     std::vector<std::vector<int16_t>> &planes, size_t offset)
+{
+  size_t const out_channels = planes.size ();
+
+  if (in_channels == 2 && out_channels == 1)
+    return mix_stereo_to_mono (pcm, count, planes[0].data () + offset);
+
+  for (size_t c = 0; c < out_channels; c++)
+    {
+      int16_t *dst = planes[c].data () + offset;
+      if (in_channels <= out_channels)
+        {
+          int16_t const *src = pcm + c % in_channels;
+          for (size_t i = 0; i < count; i++)
+            dst[i] = src[i * in_channels];
+        }
+      else
+        {
+          int32_t const sources = (in_channels - c + out_channels - 1) / out_channels;
+          for (size_t i = 0; i < count; i++)
+            {
+              int16_t const *frame = pcm + i * in_channels;
+              int32_t sum = 0;
+              for (size_t k = c; k < in_channels; k += out_channels)
+                sum += frame[k];
+              dst[i] = sum / sources;
+            }
+        }
+    }
+}
+
+
+static uint32_t
+gcd (uint32_t a, uint32_t b)
+{
+  while (b != 0)
+    {
+      uint32_t r = a % b;
+      a = b;
+      b = r;
+    }
+  return a;
+}
+
+
+void
+audio_resampler::configure (uint32_t in_rate, uint8_t in_channels, uint32_t out_rate, uint8_t out_channels)
+{
+  if (this->in_rate == in_rate && this->in_channels == in_channels
+      && this->out_rate == out_rate && this->out_channels == out_channels)
+    return;
+
+  this->in_rate = in_rate;
+  this->in_channels = in_channels;
+  this->out_rate = out_rate;
+  this->out_channels = out_channels;
+
+  uint32_t divisor = gcd (in_rate, out_rate);
+  step_num = in_rate / divisor;
+  step_den = out_rate / divisor;
+
+  design_filter ();
+  reset ();
+}
+
+
+void
+audio_resampler::design_filter ()
+{
+  if (in_rate == out_rate)
+    {
+      taps = 0;
+      phases = 0;
+      coefficients.clear ();
+      return;
+    }
+
+  // Cut off a little below the lower of the two Nyquist frequencies,
+  // relative to the input rate, so that the transition band doesn't alias.
+  double const cutoff = 0.9 * std::min (1.0, double (step_den) / step_num);
+  size_t const half = std::ceil (zero_crossings / cutoff);
+  taps = (2 * half + tap_alignment - 1) / tap_alignment * tap_alignment;
+  phases = std::min (step_den, max_phases);
+  coefficients.assign (phases * taps, 0);
+
+  // Tap j of phase p weighs input sample index + j for an output sample at
+  // index + taps / 2 - 1 + p / phases.
+  double const width = taps / 2;
+  std::vector<double> row (taps);
+  for (size_t p = 0; p < phases; p++)
+    {
+      double const t = double (p) / phases;
+      double sum = 0;
+      for (size_t j = 0; j < taps; j++)
+        {
+          double const d = double (j) - (width - 1) - t;
+          double h = 0;
+          if (std::fabs (d) < width)
+            {
+              double const x = pi * cutoff * d;
+              double const sinc = x == 0 ? 1 : std::sin (x) / x;
+              double const window = 0.42
+                + 0.5 * std::cos (pi * d / width)
+                + 0.08 * std::cos (2 * pi * d / width);
+              h = cutoff * sinc * window;
+            }
+          row[j] = h;
+          sum += h;
+        }
+
+      // Normalise each phase to unity gain, so a constant signal stays
+      // constant whatever the phase.
+      int16_t *dst = &coefficients[p * taps];
+      for (size_t j = 0; j < taps; j++)
+        dst[j] = std::lround (row[j] / sum * (1 << coefficient_bits));
+    }
+}
+
+
+void
+audio_resampler::reset ()
+{
+  // Prime the history with silence, so that the first output sample lies on
+  // the first input sample.
+  size_t const history = taps == 0 ? 0 : taps / 2 - 1;
+  planes.resize (out_channels);
+  for (auto &plane : planes)
+    plane.assign (history, 0);
+  index = 0;
+  fraction = 0;
+}
+
+
+void
+audio_resampler::process (int16_t const *pcm, size_t sample_count, std::vector<int16_t> &out)
+{
+  if (in_rate == out_rate && in_channels == out_channels)
+    {
+      out.insert (out.end (), pcm, pcm + sample_count * in_channels);
+      return;
+    }
+
+  // Reserve for the worst case of this frame size, not for what the current
+  // filter state needs: the history and the output vary by a sample from one
+  // call to the next, and growing them exactly would reallocate whenever they
+  // do. With frames of constant size, only the first call allocates.
+  size_t const offset = planes[0].size ();
+  for (auto &plane : planes)
+    {
+      plane.reserve (taps + sample_count);
+      plane.resize (offset + sample_count);
+    }
+  mix (pcm, sample_count, in_channels, planes, offset);
+
+  if (in_rate == out_rate)
+    {
+      // Only the channel count differs; interleave the mixed planes.
+      size_t const start = out.size ();
+      out.resize (start + sample_count * out_channels);
+      for (size_t c = 0; c < out_channels; c++)
+        for (size_t i = 0; i < sample_count; i++)
+          out[start + i * out_channels + c] = planes[c][i];
+      for (auto &plane : planes)
+        plane.clear ();
+      return;
+    }
+
+  size_t const available = planes[0].size ();
+  out.reserve (out.size () + (sample_count * step_den / step_num + 1) * out_channels);
+  while (index + taps <= available)
+    {
+      size_t phase = phases == step_den ? fraction : uint64_t (fraction) * phases / step_den;
+      int16_t const *h = &coefficients[phase * taps];
+      for (auto const &plane : planes)
+        {
+          int32_t sample = dot (plane.data () + index, h, taps);
+          out.push_back (saturate ((sample + (1 << (coefficient_bits - 1))) >> coefficient_bits));
+        }
+
+      fraction += step_num;
+      index += fraction / step_den;
+      fraction %= step_den;
+    }
+
+  // Drop the input that no future output sample can reach. When decimating,
+  // the next window may start beyond the end of the input we have.
+  size_t const consumed = std::min (index, available);
+  for (auto &plane : planes)
+    plane.erase (plane.begin (), plane.begin () + consumed);
+  index -= consumed;
+}
+
+size_t
+audio_resampler::heap_size () const
+{
+  size_t size = ::heap_size (coefficients) + ::heap_size (planes);
+  for (auto const &plane : planes)
+    size += ::heap_size (plane);
+  return size;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+// Converts interleaved 16 bit PCM of any sampling rate and channel count to
+// the format of a call. Channels are mixed first, so the filter only runs on
+// the output channels. Rate conversion uses a polyphase windowed-sinc filter
+// whose dot products are vectorised with SSE2 or AVX2 where the CPU supports
+// it. The filter keeps its history between calls to process, so a stream can
+// be fed in frames of any length.
+struct audio_resampler
+{
+  // Prepare for input in the given format. The filter state is kept if the
+  // format didn't change.
+  void configure (uint32_t in_rate, uint8_t in_channels, uint32_t out_rate, uint8_t out_channels);
+
+  // Convert sample_count samples per channel from pcm and append the result
+  // to out. The number of samples appended depends on the filter state, not
+  // only on sample_count.
+  void process (int16_t const *pcm, size_t sample_count, std::vector<int16_t> &out);
+
+  // Heap memory held by the filter and its history, in bytes.
+  size_t heap_size () const;
+
+private:
+  void design_filter ();
+  void reset ();
+
+  uint32_t in_rate = 0;
+  uint32_t out_rate = 0;
+  uint8_t in_channels = 0;
+  uint8_t out_channels = 0;
+
+  // The input advances by step_num / step_den samples per output sample.
+  uint32_t step_num = 1;
+  uint32_t step_den = 1;
+
+  // Filter table: `phases` rows of `taps` coefficients in Q14.
+  size_t taps = 0;
+  size_t phases = 0;
+  std::vector<int16_t> coefficients;
+
+  // Mixed input per output channel, including the last taps - 1 samples of
+  // the previous call.
+  std::vector<std::vector<int16_t>> planes;
+  // Start of the filter window for the next output sample, and the fractional
+  // part of its position in units of 1 / step_den.
+  size_t index = 0;
+  uint32_t fraction = 0;
+};
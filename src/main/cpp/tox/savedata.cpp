@@ -0,0 +1,137 @@
+#include "savedata.h"
+
+#include <cstring>
+
+#include <lz4.h>
+
+
+static uint8_t const magic[4] = { 'T', 'O', 'X', 'Z' };
+
+enum
+{
+  VERSION = 1,
+  CODEC_LZ4 = 1,
+  HEADER_SIZE = 20,
+};
+
+// LZ4 cannot expand data by more than this factor, so a larger uncompressed
+// size in the header is damage, and we don't allocate for it.
+static uint64_t const max_ratio = 255;
+
+
+static void
+put_u32 (uint8_t *out, uint32_t value)
+{
+  out[0] = value;
+  out[1] = value >> 8;
+  out[2] = value >> 16;
+  out[3] = value >> 24;
+}
+
+static uint32_t
+get_u32 (uint8_t const *in)
+{
+  return uint32_t (in[0])
+       | uint32_t (in[1]) << 8
+       | uint32_t (in[2]) << 16
+       | uint32_t (in[3]) << 24;
+}
+
+
+// CRC-32 as in zlib and PNG, four bytes at a time (slicing-by-4). Save data
+// runs to megabytes, and the byte-wise loop would take as long as LZ4.
+namespace
+{
+  struct crc32_tables
+  {
+    uint32_t table[4][256];
+
+    crc32_tables ()
+    {
+      for (uint32_t i = 0; i < 256; i++)
+        {
+          uint32_t crc = i;
+          for (int bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
+          table[0][i] = crc;
+        }
+      for (uint32_t i = 0; i < 256; i++)
+        for (int slice = 1; slice < 4; slice++)
+          table[slice][i] = (table[slice - 1][i] >> 8) ^ table[0][table[slice - 1][i] & 0xff];
+    }
+  };
+}
+
+static uint32_t
+crc32 (uint8_t const *data, size_t length)
+{
+  static crc32_tables const tables;
+  auto const &t = tables.table;
+
+  uint32_t crc = 0xffffffff;
+  for (; length >= 4; data += 4, length -= 4)
+    {
+      crc ^= get_u32 (data);
+      crc = t[3][crc & 0xff] ^ t[2][(crc >> 8) & 0xff] ^ t[1][(crc >> 16) & 0xff] ^ t[0][crc >> 24];
+    }
+  for (; length != 0; data++, length--)
+    crc = (crc >> 8) ^ t[0][(crc ^ *data) & 0xff];
+  return ~crc;
+}
+
+
+bool
+savedata_is_compressed (uint8_t const *data, size_t length)
+{
+  return length >= sizeof magic && std::memcmp (data, magic, sizeof magic) == 0;
+}
+
+size_t
+savedata_compressed_bound (size_t length)
+{
+  return HEADER_SIZE + LZ4_compressBound (length);
+}
+
+size_t
+savedata_compress (uint8_t const *data, size_t length, uint8_t *out)
+{
+  // The fastest LZ4 mode: save data is mostly fixed-size records padded
+  // with zeros, which compresses well without searching harder.
+  int const compressed = LZ4_compress_default (reinterpret_cast<char const *> (data),
+                                               reinterpret_cast<char *> (out + HEADER_SIZE),
+                                               length, LZ4_compressBound (length));
+
+  std::memcpy (out, magic, sizeof magic);
+  out[4] = VERSION;
+  out[5] = CODEC_LZ4;
+  out[6] = 0;
+  out[7] = 0;
+  put_u32 (out + 8, length);
+  put_u32 (out + 12, compressed);
+  put_u32 (out + 16, crc32 (data, length));
+
+  return HEADER_SIZE + compressed;
+}
+
+bool
+savedata_decompress (uint8_t const *data, size_t length, std::vector<uint8_t> &plain)
+{
+  if (length < HEADER_SIZE || !savedata_is_compressed (data, length))
+    return false;
+  if (data[4] != VERSION || data[5] != CODEC_LZ4)
+    return false;
+
+  uint32_t const uncompressed = get_u32 (data + 8);
+  uint32_t const compressed = get_u32 (data + 12);
+  if (compressed != length - HEADER_SIZE || uncompressed > compressed * max_ratio)
+    return false;
+
+  plain.resize (uncompressed);
+  int const decoded = LZ4_decompress_safe (reinterpret_cast<char const *> (data + HEADER_SIZE),
+                                           reinterpret_cast<char *> (plain.data ()),
+                                           compressed, uncompressed);
+  if (decoded < 0 || uint32_t (decoded) != uncompressed)
+    return false;
+
+  return crc32 (plain.data (), plain.size ()) == get_u32 (data + 16);
+}
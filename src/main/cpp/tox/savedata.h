@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+// Compressed save data container, written by tox_save_formatted and
+// recognised by tox_new. The layout, with integers in little endian:
+//
+//    0  magic              "TOXZ"
+//    4  version            1
+//    5  codec              1 = LZ4 block
+//    6  reserved           0 (2 bytes)
+//    8  uncompressed size  (4 bytes)
+//   12  compressed size    (4 bytes)
+//   16  CRC-32             of the uncompressed data (4 bytes)
+//   20  compressed data
+//
+// Plain tox_save output starts with four zero bytes and encrypted saves with
+// "toxEsave", so the magic tells the formats apart.
+
+// Whether data starts like a compressed container. It may still be damaged.
+bool savedata_is_compressed (uint8_t const *data, size_t length);
+
+// Upper bound on the container size for length bytes of save data.
+size_t savedata_compressed_bound (size_t length);
+
+// Compress length bytes of save data into out, which must hold
+// savedata_compressed_bound (length) bytes. Returns the container size.
+size_t savedata_compress (uint8_t const *data, size_t length, uint8_t *out);
+
+// Unpack a container into plain. Returns false if the container has an
+// unknown version or codec, is truncated, or fails its checksum.
+bool savedata_decompress (uint8_t const *data, size_t length, std::vector<uint8_t> &plain);
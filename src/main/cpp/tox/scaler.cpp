@@ -0,0 +1,170 @@
+#include "scaler.h"
+#include "memory.h"
+
+#include "colorspace.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+void
+video_scaler::fit (uint16_t width, uint16_t height, uint16_t max_width, uint16_t max_height,
+                   uint16_t &out_width, uint16_t &out_height)
+{
+  if (width <= max_width && height <= max_height)
+    {
+      out_width = width;
+      out_height = height;
+      return;
+    }
+
+  // Compare width / max_width with height / max_height without dividing.
+  if (uint32_t (width) * max_height >= uint32_t (height) * max_width)
+    {
+      out_width = max_width;
+      out_height = uint32_t (height) * max_width / width;
+    }
+  else
+    {
+      out_width = uint32_t (width) * max_height / height;
+      out_height = max_height;
+    }
+
+  out_width = std::max (out_width & ~1, 2);
+  out_height = std::max (out_height & ~1, 2);
+}
+
+
+// dst = (top * (256 - weight) + bottom * weight + 128) >> 8
+static void
+blend_rows (uint8_t const *top, uint8_t const *bottom, uint16_t weight, uint16_t width, uint8_t *dst)
+{
+  size_t x = 0;
+#if defined(__SSE2__)
+  __m128i const zero = _mm_setzero_si128 ();
+  __m128i const top_weight = _mm_set1_epi16 (256 - weight);
+  __m128i const bottom_weight = _mm_set1_epi16 (weight);
+  __m128i const round = _mm_set1_epi16 (128);
+  for (; x + 16 <= width; x += 16)
+    {
+      __m128i t = _mm_loadu_si128 ((__m128i const *) (top + x));
+      __m128i b = _mm_loadu_si128 ((__m128i const *) (bottom + x));
+      // 255 * 256 + 128 fits into an unsigned 16 bit lane, so the sum and the
+      // logical shift cannot overflow.
+      __m128i lo = _mm_add_epi16 (_mm_mullo_epi16 (_mm_unpacklo_epi8 (t, zero), top_weight),
+                                  _mm_mullo_epi16 (_mm_unpacklo_epi8 (b, zero), bottom_weight));
+      __m128i hi = _mm_add_epi16 (_mm_mullo_epi16 (_mm_unpackhi_epi8 (t, zero), top_weight),
+                                  _mm_mullo_epi16 (_mm_unpackhi_epi8 (b, zero), bottom_weight));
+      lo = _mm_srli_epi16 (_mm_add_epi16 (lo, round), 8);
+      hi = _mm_srli_epi16 (_mm_add_epi16 (hi, round), 8);
+      _mm_storeu_si128 ((__m128i *) (dst + x), _mm_packus_epi16 (lo, hi));
+    }
+#endif
+  for (; x < width; x++)
+    dst[x] = (top[x] * (256 - weight) + bottom[x] * weight + 128) >> 8;
+}
+
+
+// Source position and 8 bit fraction of output sample i, sampling pixel
+// centres. The position is clamped so that position + 1 is still inside.
+static void
+source_position (size_t i, uint16_t size, uint16_t out_size, uint16_t &position, uint16_t &weight)
+{
+  // (i + 0.5) * size / out_size - 0.5, in 1/256ths.
+  int32_t const fixed = int32_t (((2 * i + 1) * size * 256) / (2 * out_size)) - 128;
+  int32_t const clamped = std::min (std::max (fixed, int32_t (0)), int32_t (size - 1) * 256);
+  position = clamped >> 8;
+  weight = clamped & 0xff;
+  if (position + 1 >= size)
+    {
+      position = std::max (size - 2, 0);
+      weight = size > 1 ? 256 : 0;
+    }
+}
+
+
+void
+video_scaler::bilinear (uint8_t const *src, uint16_t width, uint16_t height,
+                        uint8_t *dst, uint16_t out_width, uint16_t out_height)
+{
+  columns.resize (out_width);
+  weights.resize (out_width);
+  row.resize (width);
+  for (size_t x = 0; x < out_width; x++)
+    source_position (x, width, out_width, columns[x], weights[x]);
+
+  for (size_t y = 0; y < out_height; y++)
+    {
+      uint16_t line, weight;
+      source_position (y, height, out_height, line, weight);
+      uint8_t const *top = src + size_t (line) * width;
+      uint8_t const *bottom = height > 1 ? top + width : top;
+      blend_rows (top, bottom, weight, width, row.data ());
+
+      uint8_t *out = dst + y * out_width;
+      if (width == 1)
+        {
+          std::fill (out, out + out_width, row[0]);
+          continue;
+        }
+      uint8_t const *blended = row.data ();
+      uint16_t const *column = columns.data ();
+      uint16_t const *fraction = weights.data ();
+      for (size_t x = 0; x < out_width; x++)
+        {
+          uint8_t const *pair = blended + column[x];
+          out[x] = (pair[0] * (256 - fraction[x]) + pair[1] * fraction[x] + 128) >> 8;
+        }
+    }
+}
+
+
+void
+video_scaler::scale_plane (uint8_t const *src, uint16_t width, uint16_t height,
+                           uint8_t *dst, uint16_t out_width, uint16_t out_height)
+{
+  // Box filter down while the plane is at least twice the target size, so
+  // that the bilinear step never skips source pixels.
+  size_t current = 0;
+  while (width >= 2 * out_width && height >= 2 * out_height)
+    {
+      std::vector<uint8_t> &next = halved[current];
+      next.resize (size_t (width / 2) * (height / 2));
+      halve_plane (src, width, height, next.data ());
+      src = next.data ();
+      width /= 2;
+      height /= 2;
+      current ^= 1;
+    }
+
+  if (width == out_width && height == out_height)
+    std::memcpy (dst, src, size_t (width) * height);
+  else
+    bilinear (src, width, height, dst, out_width, out_height);
+}
+
+
+void
+video_scaler::scale_i420 (uint8_t const *src, uint16_t width, uint16_t height,
+                          uint8_t *dst, uint16_t out_width, uint16_t out_height)
+{
+  size_t const luma = size_t (width) * height;
+  size_t const chroma = luma / 4;
+  size_t const out_luma = size_t (out_width) * out_height;
+  size_t const out_chroma = out_luma / 4;
+
+  scale_plane (src, width, height, dst, out_width, out_height);
+  scale_plane (src + luma, width / 2, height / 2, dst + out_luma, out_width / 2, out_height / 2);
+  scale_plane (src + luma + chroma, width / 2, height / 2, dst + out_luma + out_chroma, out_width / 2, out_height / 2);
+}
+
+size_t
+video_scaler::heap_size () const
+{
+  return ::heap_size (halved[0]) + ::heap_size (halved[1]) + ::heap_size (row)
+       + ::heap_size (columns) + ::heap_size (weights);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+// Downscales I420 frames. Each plane is first halved with a 2x2 box filter
+// while it is at least twice the target size, then resampled bilinearly to
+// the exact size, so that large reductions still average every source
+// pixel. The vertical pass of the bilinear filter and the halving use SSE2.
+// All intermediate buffers are kept between frames.
+struct video_scaler
+{
+  // The largest size with the aspect ratio of width x height that fits into
+  // max_width x max_height, rounded down to even numbers.
+  static void fit (uint16_t width, uint16_t height, uint16_t max_width, uint16_t max_height,
+                   uint16_t &out_width, uint16_t &out_height);
+
+  // Scale a contiguous I420 frame to a smaller contiguous I420 frame. All
+  // dimensions must be even.
+  void scale_i420 (uint8_t const *src, uint16_t width, uint16_t height,
+                   uint8_t *dst, uint16_t out_width, uint16_t out_height);
+
+  // Heap memory held by the scratch buffers, in bytes.
+  size_t heap_size () const;
+
+private:
+  void scale_plane (uint8_t const *src, uint16_t width, uint16_t height,
+                    uint8_t *dst, uint16_t out_width, uint16_t out_height);
+  void bilinear (uint8_t const *src, uint16_t width, uint16_t height,
+                 uint8_t *dst, uint16_t out_width, uint16_t out_height);
+
+  // Ping-pong buffers for the halving steps.
+  std::vector<uint8_t> halved[2];
+  // One vertically interpolated source row.
+  std::vector<uint8_t> row;
+  // Source column and 8 bit weight of the right neighbour, per output column.
+  std::vector<uint16_t> columns;
+  std::vector<uint16_t> weights;
+};
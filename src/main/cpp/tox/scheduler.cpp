@@ -0,0 +1,32 @@
+#include "scheduler.h"
+
+#include <algorithm>
+
+
+// std::*_heap build a max-heap, so compare the other way around.
+static bool
+later (frame_scheduler::entry const &a, frame_scheduler::entry const &b)
+{
+  return a.due > b.due;
+}
+
+
+void
+frame_scheduler::schedule (entry const &request)
+{
+  heap.push_back (request);
+  std::push_heap (heap.begin (), heap.end (), later);
+}
+
+
+bool
+frame_scheduler::pop_due (clock::time_point now, entry &request)
+{
+  if (heap.empty () || heap.front ().due > now)
+    return false;
+
+  std::pop_heap (heap.begin (), heap.end (), later);
+  request = heap.back ();
+  heap.pop_back ();
+  return true;
+}
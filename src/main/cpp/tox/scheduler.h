@@ -0,0 +1,48 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+
+// Orders the frame requests of all calls by deadline. Each audio or video
+// stream of a call has at most one live entry, holding the time its next
+// frame is due. The entries form a binary min-heap, so the next deadline is
+// known in constant time and rescheduling a stream costs O(log n).
+//
+// Entries are never removed from the middle of the heap. A stream that stops
+// or restarts bumps its call's generation instead, and entries carrying an
+// older generation are dropped when they come up.
+struct frame_scheduler
+{
+  typedef std::chrono::steady_clock clock;
+
+  enum stream_kind : uint8_t
+  {
+    audio_stream,
+    video_stream,
+  };
+
+  struct entry
+  {
+    clock::time_point due;
+    uint32_t friend_number;
+    uint32_t generation;
+    stream_kind kind;
+  };
+
+  void schedule (entry const &request);
+
+  bool empty () const { return heap.empty (); }
+  // The earliest deadline. Must not be called on an empty scheduler.
+  clock::time_point next_due () const { return heap.front ().due; }
+
+  // Remove the earliest entry if it is due at now.
+  bool pop_due (clock::time_point now, entry &request);
+
+  // Heap memory held by the queue, in bytes.
+  size_t heap_size () const { return heap.capacity () * sizeof (entry); }
+
+private:
+  std::vector<entry> heap;
+};
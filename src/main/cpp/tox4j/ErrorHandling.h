@@ -10,6 +10,8 @@ void throw_illegal_state_exception(JNIEnv *env, jint instance_number, char const
 void throw_illegal_state_exception(JNIEnv *env, jint instance_number, std::string const &message);
 void throw_tox_exception(JNIEnv *env, char const *module, char const *method, char const *code);
 
+#include "EventStream.h"
+#include "NativeStats.h"
 #include "ToxInstances.h"
 
 
@@ -81,7 +83,7 @@ using tox_success_t = typename std::result_of<SuccessFunc(typename std::result_o
 
 namespace av {
     namespace proto = im::tox::tox4j::av::proto;
-    using Events = proto::AvEvents;
+    using Events = event_stream;
 
     struct Deleter {
         void operator()(ToxAV *av) {
@@ -101,7 +103,7 @@ namespace av {
 
 namespace core {
     namespace proto = im::tox::tox4j::core::proto;
-    using Events = proto::CoreEvents;
+    using Events = event_stream;
 
     struct Deleter {
         void operator()(Tox *tox) {
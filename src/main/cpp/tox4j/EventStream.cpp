@@ -0,0 +1,344 @@
+#include "EventStream.h"
+
+#include "Av.pb.h"
+#include "Core.pb.h"
+#include "NativeStats.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+
+
+namespace {
+
+namespace cp = im::tox::tox4j::core::proto;
+namespace ap = im::tox::tox4j::av::proto;
+
+// Wire types of the protobuf encoding.
+enum wire_type {
+    VARINT = 0,
+    LENGTH_DELIMITED = 2,
+};
+
+// Field numbers of the batch fields, shared by CoreEvents and AvEvents.
+int const receive_base_field = cp::CoreEvents::kReceiveBaseFieldNumber;
+int const serialize_time_field = cp::CoreEvents::kSerializeTimeFieldNumber;
+int const more_pending_field = cp::CoreEvents::kMorePendingFieldNumber;
+// ... and of receiveTime in every event.
+int const receive_time_field = cp::ConnectionStatus::kReceiveTimeFieldNumber;
+
+static_assert(ap::AvEvents::kReceiveBaseFieldNumber == receive_base_field &&
+              ap::AvEvents::kSerializeTimeFieldNumber == serialize_time_field &&
+              ap::AvEvents::kMorePendingFieldNumber == more_pending_field,
+              "CoreEvents and AvEvents must have their batch fields at the same numbers");
+
+// Whether all the event messages have their receiveTime at receive_time_field.
+template<typename... Events>
+struct same_receive_time_field;
+
+template<>
+struct same_receive_time_field<> {
+    static bool const value = true;
+};
+
+template<typename Event, typename... Rest>
+struct same_receive_time_field<Event, Rest...> {
+    static bool const value =
+        Event::kReceiveTimeFieldNumber == receive_time_field && same_receive_time_field<Rest...>::value;
+};
+
+static_assert(same_receive_time_field<
+                  cp::ConnectionStatus, cp::FileControl, cp::FileReceive, cp::FileReceiveChunk, cp::FileProgress,
+                  cp::FileRequestChunk, cp::FriendAction, cp::FriendConnectionStatus, cp::FriendMessage,
+                  cp::FriendName, cp::FriendRequest, cp::FriendStatus, cp::FriendStatusMessage, cp::FriendTyping,
+                  cp::FriendLosslessPacket, cp::FriendLossyPacket, cp::ReadReceipt,
+                  ap::Call, ap::CallState, ap::RequestAudioFrame, ap::RequestVideoFrame, ap::ReceiveAudioFrame,
+                  ap::ReceiveVideoFrame>::value,
+              "Every event message must have its receiveTime at the same field number");
+
+// Room for the batch fields: three two-byte tags, two 64 bit varints and a bool.
+size_t const header_space = 32;
+
+// Bound on the encoding of an event's fields, except for the contents of its variable-length ones: at most 8 fields
+// (ReceiveVideoFrame with receiveTime), each with a one-byte tag and a varint of at most 10 bytes.
+size_t const max_fixed_size = 8 * 11;
+
+// A timeDelta placeholder is a uint32 varint padded to full width.
+size_t const time_delta_width = 5;
+
+size_t
+varint_size(uint64_t value)
+{
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+void
+put_varint(std::vector<uint8_t> &buffer, uint64_t value)
+{
+    while (value >= 0x80) {
+        buffer.push_back(uint8_t(value) | 0x80);
+        value >>= 7;
+    }
+    buffer.push_back(uint8_t(value));
+}
+
+// A varint in exactly width bytes, with continuation bits on leading zero groups. Parsers accept these.
+void
+put_padded_varint(uint8_t *out, uint64_t value, size_t width)
+{
+    for (size_t i = 0; i < width - 1; i++) {
+        out[i] = uint8_t(value) | 0x80;
+        value >>= 7;
+    }
+    out[width - 1] = uint8_t(value);
+}
+
+uint8_t *
+put_varint(uint8_t *out, uint64_t value)
+{
+    while (value >= 0x80) {
+        *out++ = uint8_t(value) | 0x80;
+        value >>= 7;
+    }
+    *out++ = uint8_t(value);
+    return out;
+}
+
+uint32_t
+tag(int field, wire_type type)
+{
+    return (uint32_t(field) << 3) | type;
+}
+
+void
+put_tag(std::vector<uint8_t> &buffer, int field, wire_type type)
+{
+    put_varint(buffer, tag(field, type));
+}
+
+}
+
+
+uint64_t
+event_clock()
+{
+    auto const now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+
+event_stream::event_stream(char const *module)
+: module(module)
+, buffer(header_space)
+, begin(header_space)
+{
+}
+
+void
+event_stream::reserve(size_t size)
+{
+    size_t const needed = buffer.size() + size;
+    if (needed > buffer.capacity()) {
+        buffer.reserve(std::max(needed, buffer.capacity() * 2));
+    }
+}
+
+uint32_t
+event_stream::stamp()
+{
+    uint64_t const now = event_clock();
+    compact();
+    if (!pending()) {
+        receive_base = now;
+    }
+    return uint32_t(now - receive_base);
+}
+
+void
+event_stream::compact()
+{
+    if (!pending()) {
+        buffer.resize(header_space);
+        begin = header_space;
+        records.clear();
+        first = 0;
+        return;
+    }
+
+    size_t const consumed = begin - header_space;
+    if (consumed <= buffer.size() - begin) {
+        return;
+    }
+
+    std::memmove(buffer.data() + header_space, buffer.data() + begin, buffer.size() - begin);
+    buffer.resize(buffer.size() - consumed);
+    begin = header_space;
+
+    records.erase(records.begin(), records.begin() + first);
+    first = 0;
+    for (event_record &record : records) {
+        record.end -= consumed;
+        if (record.time_delta != 0) {
+            record.time_delta -= consumed;
+        }
+    }
+}
+
+void
+event_stream::patch_time_deltas(size_t last, uint64_t now)
+{
+    uint64_t const elapsed = now - receive_base;
+    for (size_t i = first; i < last; i++) {
+        if (records[i].time_delta != 0) {
+            uint32_t const waited = uint32_t((elapsed - records[i].receive_time) / 1000);
+            put_padded_varint(buffer.data() + records[i].time_delta, waited, time_delta_width);
+        }
+    }
+}
+
+void
+event_stream::record_latencies(size_t last, uint64_t now)
+{
+    if (!native_stats_enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (method_stats *stats = find_method_stats(module, "EventLatency")) {
+        uint64_t const elapsed = now - receive_base;
+        for (size_t i = first; i < last; i++) {
+            record_method_call(stats, std::chrono::microseconds(elapsed - records[i].receive_time));
+        }
+    }
+}
+
+event_batch
+event_stream::drain(size_t max_events, size_t max_bytes)
+{
+    if (!pending()) {
+        return event_batch { buffer.data() + begin, 0 };
+    }
+
+    // At least one event, then whole events while they fit.
+    size_t last = first;
+    do {
+        last++;
+    } while (last < records.size() && last - first < max_events && records[last].end - begin <= max_bytes);
+    size_t const end = records[last - 1].end;
+
+    uint64_t const now = event_clock();
+    patch_time_deltas(last, now);
+
+    // The batch fields go in front of the events, into room left by the header space or by consumed events.
+    uint8_t header[header_space];
+    uint8_t *out = header;
+    out = put_varint(out, tag(receive_base_field, VARINT));
+    out = put_varint(out, receive_base);
+    out = put_varint(out, tag(serialize_time_field, VARINT));
+    out = put_varint(out, now);
+    if (last < records.size()) {
+        out = put_varint(out, tag(more_pending_field, VARINT));
+        out = put_varint(out, true);
+    }
+    size_t const header_size = out - header;
+    std::memcpy(buffer.data() + begin - header_size, header, header_size);
+
+    event_batch const batch { buffer.data() + begin - header_size, end - begin + header_size };
+
+    record_latencies(last, event_clock());
+    first = last;
+    begin = end;
+    return batch;
+}
+
+size_t
+event_stream::heap_size() const
+{
+    return buffer.capacity() + records.capacity() * sizeof(event_record);
+}
+
+
+event_writer::event_writer(event_stream &stream, int field, size_t max_payload)
+: stream(stream)
+, receive_time(stream.stamp())
+{
+    size_t const max_length = max_payload + max_fixed_size;
+    length_width = varint_size(max_length);
+    stream.reserve(2 + length_width + max_length);
+
+    put_tag(stream.buffer, field, LENGTH_DELIMITED);
+    length_offset = stream.buffer.size();
+    stream.buffer.resize(length_offset + length_width);
+
+    uint32(receive_time_field, receive_time);
+}
+
+event_writer::~event_writer()
+{
+    size_t const length = stream.buffer.size() - (length_offset + length_width);
+    assert(varint_size(length) <= length_width);
+    put_padded_varint(stream.buffer.data() + length_offset, length, length_width);
+
+    stream.records.push_back(event_stream::event_record { stream.buffer.size(), receive_time, time_delta_offset });
+}
+
+void
+event_writer::uint32(int field, uint32_t value)
+{
+    put_tag(stream.buffer, field, VARINT);
+    put_varint(stream.buffer, value);
+}
+
+void
+event_writer::uint64(int field, uint64_t value)
+{
+    put_tag(stream.buffer, field, VARINT);
+    put_varint(stream.buffer, value);
+}
+
+void
+event_writer::boolean(int field, bool value)
+{
+    put_tag(stream.buffer, field, VARINT);
+    put_varint(stream.buffer, value);
+}
+
+void
+event_writer::bytes(int field, uint8_t const *data, size_t length)
+{
+    put_tag(stream.buffer, field, LENGTH_DELIMITED);
+    put_varint(stream.buffer, length);
+    stream.buffer.insert(stream.buffer.end(), data, data + length);
+}
+
+void
+event_writer::packed_int32(int field, int16_t const *values, size_t count)
+{
+    put_tag(stream.buffer, field, LENGTH_DELIMITED);
+    size_t const offset = stream.buffer.size();
+    size_t const width = varint_size(count * 10);
+
+    // Encode through a pointer into room for the worst case, then cut the buffer back to what was used.
+    stream.buffer.resize(offset + width + count * 10);
+    uint8_t *const start = stream.buffer.data() + offset + width;
+    uint8_t *out = start;
+    for (size_t i = 0; i < count; i++) {
+        // int32 is sign-extended to 64 bits on the wire.
+        out = put_varint(out, uint64_t(int64_t(values[i])));
+    }
+    stream.buffer.resize(out - stream.buffer.data());
+    put_padded_varint(stream.buffer.data() + offset, out - start, width);
+}
+
+void
+event_writer::time_delta(int field)
+{
+    put_tag(stream.buffer, field, VARINT);
+    time_delta_offset = stream.buffer.size();
+    stream.buffer.resize(time_delta_offset + time_delta_width);
+    put_padded_varint(stream.buffer.data() + time_delta_offset, 0, time_delta_width);
+}
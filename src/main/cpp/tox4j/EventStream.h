@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+/*
+ * An instance's pending events, kept serialised. The callbacks encode each event straight onto the end of an
+ * append-only buffer, in the wire format of CoreEvents or AvEvents: a repeated message field is a sequence of
+ * (tag, length, message) records, and the records of different fields may be interleaved, so the events in arrival
+ * order already form a valid batch. Each payload is copied once, from the callback's arguments into the buffer, and
+ * there is no separate size pass.
+ *
+ * The length of an event is not known until it is written. The writer reserves as many bytes for it as an upper bound
+ * on the length needs, then patches the length in place, padded to that width if it turned out shorter.
+ *
+ * Receive timestamps: each event is stamped with the monotonic time at which it was written, as an offset in
+ * microseconds from the first pending event (the batch's receiveBase), which fits a short varint. A batch is stamped
+ * with the time it was drained, and the events with a timeDelta field get the time they waited up to then, in
+ * milliseconds. With native statistics enabled, the time from each callback to its drain is also recorded under the
+ * pseudo-method "EventLatency" of the module, one call per event.
+ *
+ * Partial drains take a prefix of the pending events in arrival order, at least one event and then as many whole
+ * events as max_events and max_bytes allow. The rest stays queued with their timestamps intact, and the batch is
+ * marked morePending.
+ */
+
+// Monotonic time in microseconds.
+uint64_t event_clock();
+
+// A drained batch, pointing into the stream's buffer. Valid until the next event is written.
+struct event_batch {
+    uint8_t const *data;
+    size_t size;
+};
+
+class event_stream {
+    friend class event_writer;
+
+public:
+    // The module ("core" or "av") under which event latencies are recorded.
+    explicit event_stream(char const *module);
+
+    event_stream(event_stream const &) = delete;
+
+    // Whether events are queued.
+    bool pending() const { return first < records.size(); }
+    // Serialised size of the queued events, without the batch fields.
+    size_t pending_bytes() const { return pending() ? records.back().end - begin : 0; }
+
+    // Take up to max_events events or max_bytes of serialised events from the front of the queue, and serialise them
+    // as a batch. An empty queue gives an empty batch.
+    event_batch drain(size_t max_events, size_t max_bytes);
+    // Take all queued events.
+    event_batch drain() { return drain(SIZE_MAX, SIZE_MAX); }
+
+    // Heap memory held by the buffer and the event index, including their spare capacity.
+    size_t heap_size() const;
+
+private:
+    // Where an event ends in the buffer, when it arrived, and where its timeDelta placeholder is (0 if it has none).
+    struct event_record {
+        size_t end;
+        uint32_t receive_time;
+        size_t time_delta;
+    };
+
+    // Make room for size more bytes, growing geometrically. Called before each write, so the writes themselves never
+    // reallocate.
+    void reserve(size_t size);
+    // Prepare for a new event and return its receive time.
+    uint32_t stamp();
+    // Drop consumed events: start over if there are none left, or move the pending ones to the front once the
+    // consumed part is larger than they are.
+    void compact();
+    // For the events from first up to last.
+    void patch_time_deltas(size_t last, uint64_t now);
+    void record_latencies(size_t last, uint64_t now);
+
+    char const *const module;
+    // The first header_space bytes are reserved for the batch fields, which a drain writes just before the first
+    // event it takes. Consumed events free up more room there.
+    std::vector<uint8_t> buffer;
+    size_t begin;
+    std::vector<event_record> records;
+    size_t first = 0;
+    uint64_t receive_base = 0;
+};
+
+
+// Encodes one event onto the end of a stream, from construction to destruction. Fields are written with their proto
+// field numbers, e.g. proto::FriendName::kNameFieldNumber.
+class event_writer {
+public:
+    // field is the event's field in the batch message. max_payload bounds the total size of the variable-length
+    // fields, so that with the fixed-size ones it bounds the event's length.
+    event_writer(event_stream &stream, int field, size_t max_payload);
+    ~event_writer();
+
+    event_writer(event_writer const &) = delete;
+
+    void uint32(int field, uint32_t value);
+    void uint64(int field, uint64_t value);
+    void boolean(int field, bool value);
+    void bytes(int field, uint8_t const *data, size_t length);
+    // A packed repeated int32 field. Negative values take 10 bytes each.
+    void packed_int32(int field, int16_t const *values, size_t count);
+    // A uint32 placeholder, filled in with the time the event waited when it is drained.
+    void time_delta(int field);
+
+private:
+    event_stream &stream;
+    uint32_t const receive_time;
+    size_t length_offset;
+    size_t length_width;
+    size_t time_delta_offset = 0;
+};
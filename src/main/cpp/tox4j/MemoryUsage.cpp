@@ -0,0 +1,84 @@
+#include "MemoryUsage.h"
+
+#include "ErrorHandling.h"
+
+#include <tox/memory.h>
+
+
+namespace {
+
+// The instance slot, its mutex and the event stream object.
+template<typename ToxTraits>
+size_t instance_overhead() {
+    return sizeof(tox_instance<ToxTraits>) + sizeof(std::mutex) + sizeof(typename ToxTraits::events);
+}
+
+uint64_t sum(std::vector<uint64_t> const &values) {
+    uint64_t total = 0;
+    for (uint64_t value : values) {
+        total += value;
+    }
+    return total;
+}
+
+}
+
+
+std::vector<uint64_t>
+core_memory_usage(Tox const *tox, event_stream const &events)
+{
+    Tox_Memory_Usage usage;
+    tox_get_memory_usage(tox, &usage);
+
+    return std::vector<uint64_t> {
+        usage.core_estimate,
+        usage.transfers,
+        usage.buffers,
+        events.heap_size(),
+        usage.instance + instance_overhead<core::tox_traits>(),
+    };
+}
+
+std::vector<uint64_t>
+av_memory_usage(ToxAV const *av, event_stream const &events)
+{
+    ToxAV_Memory_Usage usage;
+    toxav_get_memory_usage(av, &usage);
+
+    return std::vector<uint64_t> {
+        usage.av_estimate,
+        usage.calls,
+        usage.mixing,
+        events.heap_size(),
+        usage.instance + instance_overhead<av::tox_traits>(),
+    };
+}
+
+
+std::vector<uint64_t>
+native_memory_usage()
+{
+    uint64_t core_instances = 0;
+    uint64_t av_instances = 0;
+    uint64_t accounted = 0;
+
+    // Live slots are already part of each instance's usage; the tables add their free and spare slots.
+    accounted += instance_manager<core::tox_traits>::self.table_size();
+    instance_manager<core::tox_traits>::self.for_each_live([&](Tox *tox, core::Events &events) {
+        core_instances++;
+        accounted += sum(core_memory_usage(tox, events)) - sizeof(tox_instance<core::tox_traits>);
+    });
+
+    accounted += instance_manager<av::tox_traits>::self.table_size();
+    instance_manager<av::tox_traits>::self.for_each_live([&](ToxAV *av, av::Events &events) {
+        av_instances++;
+        accounted += sum(av_memory_usage(av, events)) - sizeof(tox_instance<av::tox_traits>);
+    });
+
+    return std::vector<uint64_t> {
+        core_instances,
+        av_instances,
+        accounted,
+        heap_in_use(),
+    };
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <tox/av.h>
+#include <tox/core.h>
+
+#include "EventStream.h"
+
+#include <cstdint>
+#include <vector>
+
+
+/*
+ * Native memory accounting for Tox and ToxAv instances, in bytes. The subsystems report their own state through
+ * tox_get_memory_usage and toxav_get_memory_usage. On top of that, each instance holds an event stream, which keeps
+ * its capacity across drains, a mutex, and a slot in the instance table.
+ */
+
+// The fields of ToxMemoryUsage: coreEstimate, transfers, buffers, events, instance.
+std::vector<uint64_t> core_memory_usage(Tox const *tox, event_stream const &events);
+// The fields of ToxAvMemoryUsage: avEstimate, calls, mixing, events, instance.
+std::vector<uint64_t> av_memory_usage(ToxAV const *av, event_stream const &events);
+
+// The fields of ToxNativeMemoryUsage: live Tox and ToxAv instances, the memory accounted to them and to the instance
+// tables, and the heap in use by the whole process (0 if unknown). Locks every instance in turn.
+std::vector<uint64_t> native_memory_usage();
@@ -0,0 +1,209 @@
+#include "NativeStats.h"
+
+#include "Stats.pb.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+
+
+std::atomic<bool> native_stats_enabled(false);
+
+void
+set_native_stats_enabled(bool enabled)
+{
+    native_stats_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+
+size_t
+native_latency_bucket(uint64_t nanoseconds)
+{
+    size_t const sub = native_latency_sub_buckets;
+    if (nanoseconds < 2 * sub) {
+        return nanoseconds;
+    }
+
+    // Position of the highest set bit; at least 4 here.
+    size_t const exponent = 63 - __builtin_clzll(nanoseconds);
+    size_t const bucket = 2 * sub + (exponent - 4) * sub + ((nanoseconds >> (exponent - 3)) & (sub - 1));
+    return std::min(bucket, native_latency_buckets - 1);
+}
+
+uint64_t
+native_latency_bucket_limit(size_t bucket)
+{
+    size_t const sub = native_latency_sub_buckets;
+    if (bucket < 2 * sub) {
+        return bucket + 1;
+    }
+    if (bucket == native_latency_buckets - 1) {
+        return INT64_MAX;
+    }
+
+    size_t const exponent = (bucket - 2 * sub) / sub + 4;
+    uint64_t const mantissa = sub + (bucket - 2 * sub) % sub;
+    return (mantissa + 1) << (exponent - 3);
+}
+
+
+struct method_stats {
+    // Both keys are set before ready, and never change afterwards.
+    char const *module;
+    char const *method;
+    std::atomic<bool> ready;
+
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> errors;
+    std::atomic<uint64_t> total_latency;
+    std::atomic<uint64_t> max_latency;
+    std::atomic<uint64_t> latency[native_latency_buckets];
+
+    // Error codes are the literals from failure_case, so they are keyed by address. Errors beyond the last slot are
+    // only counted in the total.
+    static size_t const error_slots = 8;
+    std::atomic<char const *> error_code[error_slots];
+    std::atomic<uint64_t> error_count[error_slots];
+};
+
+// Open addressing on the key pointers. Slots are only ever added, so lookups need no lock; the mutex only serialises
+// insertions. Static storage, so everything starts out zero.
+static size_t const method_slots = 256;
+static method_stats methods[method_slots];
+static std::mutex insert_mutex;
+
+
+static size_t
+slot_of(char const *module, char const *method)
+{
+    uint64_t hash = reinterpret_cast<uintptr_t>(method) * 0x9e3779b97f4a7c15ULL ^ reinterpret_cast<uintptr_t>(module);
+    return (hash >> 32) % method_slots;
+}
+
+static method_stats *
+probe(char const *module, char const *method, bool insert)
+{
+    size_t slot = slot_of(module, method);
+    for (size_t i = 0; i < method_slots; i++, slot = (slot + 1) % method_slots) {
+        method_stats &stats = methods[slot];
+        if (!stats.ready.load(std::memory_order_acquire)) {
+            if (!insert) {
+                return nullptr;
+            }
+            stats.module = module;
+            stats.method = method;
+            stats.ready.store(true, std::memory_order_release);
+            return &stats;
+        }
+        if (stats.method == method && stats.module == module) {
+            return &stats;
+        }
+    }
+    return nullptr;
+}
+
+method_stats *
+find_method_stats(char const *module, char const *method)
+{
+    if (method_stats *stats = probe(module, method, false)) {
+        return stats;
+    }
+
+    std::lock_guard<std::mutex> lock(insert_mutex);
+    return probe(module, method, true);
+}
+
+
+void
+record_method_call(method_stats *stats, std::chrono::steady_clock::duration latency)
+{
+    uint64_t const nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count();
+    stats->calls.fetch_add(1, std::memory_order_relaxed);
+    stats->total_latency.fetch_add(nanoseconds, std::memory_order_relaxed);
+    stats->latency[native_latency_bucket(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t max = stats->max_latency.load(std::memory_order_relaxed);
+    while (nanoseconds > max && !stats->max_latency.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed)) {
+    }
+}
+
+void
+record_method_error(method_stats *stats, char const *code)
+{
+    stats->errors.fetch_add(1, std::memory_order_relaxed);
+    for (size_t i = 0; i < method_stats::error_slots; i++) {
+        char const *current = stats->error_code[i].load(std::memory_order_relaxed);
+        if (current == nullptr) {
+            // Claim the empty slot; if another thread got there first, it may have claimed it for this same code.
+            stats->error_code[i].compare_exchange_strong(current, code, std::memory_order_relaxed);
+        }
+        if (current == nullptr || current == code) {
+            stats->error_count[i].fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+
+std::vector<char>
+native_stats_snapshot()
+{
+    namespace proto = im::tox::tox4j::proto;
+
+    proto::NativeStats snapshot;
+    snapshot.set_enabled(native_stats_enabled.load(std::memory_order_relaxed));
+
+    // Equal names from different translation units may have different addresses; merge them here.
+    std::map<std::pair<std::string, std::string>, std::vector<method_stats const *>> by_name;
+    for (method_stats const &stats : methods) {
+        if (stats.ready.load(std::memory_order_acquire)) {
+            by_name[std::make_pair(std::string(stats.module), std::string(stats.method))].push_back(&stats);
+        }
+    }
+
+    for (auto const &entry : by_name) {
+        proto::MethodStats *method = snapshot.add_method();
+        method->set_module(entry.first.first);
+        method->set_method(entry.first.second);
+
+        uint64_t calls = 0, errors = 0, total_latency = 0, max_latency = 0;
+        std::vector<uint64_t> latency(native_latency_buckets);
+        std::map<std::string, uint64_t> error_counts;
+        for (method_stats const *stats : entry.second) {
+            calls += stats->calls.load(std::memory_order_relaxed);
+            errors += stats->errors.load(std::memory_order_relaxed);
+            total_latency += stats->total_latency.load(std::memory_order_relaxed);
+            max_latency = std::max(max_latency, stats->max_latency.load(std::memory_order_relaxed));
+            for (size_t i = 0; i < native_latency_buckets; i++) {
+                latency[i] += stats->latency[i].load(std::memory_order_relaxed);
+            }
+            for (size_t i = 0; i < method_stats::error_slots; i++) {
+                if (char const *code = stats->error_code[i].load(std::memory_order_relaxed)) {
+                    error_counts[code] += stats->error_count[i].load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        method->set_calls(calls);
+        method->set_errors(errors);
+        method->set_totallatency(total_latency);
+        method->set_maxlatency(max_latency);
+        for (auto const &error : error_counts) {
+            proto::ErrorCount *count = method->add_errorcount();
+            count->set_code(error.first);
+            count->set_count(error.second);
+        }
+        for (size_t i = 0; i < native_latency_buckets; i++) {
+            if (latency[i] != 0) {
+                proto::LatencyBucket *bucket = method->add_latency();
+                bucket->set_limit(native_latency_bucket_limit(i));
+                bucket->set_count(latency[i]);
+            }
+        }
+    }
+
+    std::vector<char> buffer(snapshot.ByteSize());
+    snapshot.SerializeToArray(buffer.data(), buffer.size());
+    return buffer;
+}
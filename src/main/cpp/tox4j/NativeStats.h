@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+/*
+ * Per-method statistics for the JNI entry points: call count, error count by code and a latency histogram, keyed by
+ * module ("core" or "av") and the method name that with_instance and with_error_handling already receive.
+ *
+ * Recording is switched on and off at runtime. While it is off, a call costs one relaxed load and a branch; while it
+ * is on, two clock reads and a few relaxed atomic increments. All counters are cumulative since the library was
+ * loaded, so callers compare snapshots.
+ */
+
+// The latency histogram is log-linear, like HdrHistogram with 3 bits of precision: values below 16ns have a bucket
+// each, above that every power of two is split into 8 buckets, so a bucket is at most 12.5% wide. Values from 2^36ns
+// (about 69 seconds) up go into the last bucket.
+static size_t const native_latency_sub_buckets = 8;
+static size_t const native_latency_buckets = 2 * native_latency_sub_buckets + (36 - 4) * native_latency_sub_buckets;
+
+size_t native_latency_bucket(uint64_t nanoseconds);
+// Exclusive upper bound of a bucket, in nanoseconds. The last bucket's bound is INT64_MAX.
+uint64_t native_latency_bucket_limit(size_t bucket);
+
+
+struct method_stats;
+
+extern std::atomic<bool> native_stats_enabled;
+
+void set_native_stats_enabled(bool enabled);
+
+// The statistics slot of a method, created on first use. Returns nullptr if all slots are taken.
+method_stats *find_method_stats(char const *module, char const *method);
+void record_method_call(method_stats *stats, std::chrono::steady_clock::duration latency);
+void record_method_error(method_stats *stats, char const *code);
+
+// A serialised im.tox.tox4j.proto.NativeStats message.
+std::vector<char> native_stats_snapshot();
+
+
+// Times one native call from construction to destruction.
+class method_timer {
+public:
+    method_timer(char const *module, char const *method)
+    : stats(native_stats_enabled.load(std::memory_order_relaxed) ? find_method_stats(module, method) : nullptr)
+    {
+        if (stats != nullptr) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    method_timer(method_timer const &) = delete;
+
+    ~method_timer() {
+        if (stats != nullptr) {
+            record_method_call(stats, std::chrono::steady_clock::now() - start);
+        }
+    }
+
+    void error(char const *code) {
+        if (stats != nullptr) {
+            record_method_error(stats, code);
+        }
+    }
+
+private:
+    method_stats *const stats;
+    std::chrono::steady_clock::time_point start;
+};
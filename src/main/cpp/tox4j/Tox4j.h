@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ErrorHandling.h"
+#include "MemoryUsage.h"
 
 #include <algorithm>
 #include <sstream>
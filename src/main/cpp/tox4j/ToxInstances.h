@@ -343,6 +343,25 @@ public:
         setFree(instanceNumber);
     }
 
+    // Call func with each live instance's subsystem and events, under the manager lock and the instance's own lock.
+    template<typename Func>
+    void for_each_live(Func func)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (instance_type const &instance : instances) {
+            if (instance.isLive()) {
+                instance.with_lock(func);
+            }
+        }
+    }
+
+    // Heap memory held by the instance table and the free list.
+    size_t table_size()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return instances.capacity() * sizeof(instance_type) + freelist.capacity() * sizeof(jint);
+    }
+
     static instance_manager self;
 };
 
@@ -1,16 +1,23 @@
+// If timer is given, calls on dead or invalid instances are counted as errors in the native statistics.
 template<typename Func>
 typename std::result_of<Func(tox_traits::subsystem *, Events &)>::type
-with_instance(JNIEnv *env, jint instance_number, Func func)
+with_instance(JNIEnv *env, jint instance_number, Func func, method_timer *timer = nullptr)
 {
     typedef typename std::result_of<Func(tox_traits::subsystem *, Events &)>::type return_type;
 
     if (instance_number == 0) {
+        if (timer != nullptr) {
+            timer->error("INCOMPLETE_OBJECT");
+        }
         throw_illegal_state_exception(env, instance_number, "Function called on incomplete object");
         return default_value<return_type>();
     }
 
     auto lock = instance_manager<tox_traits>::self.lock();
     if (!instance_manager<tox_traits>::self.isValid(instance_number)) {
+        if (timer != nullptr) {
+            timer->error("INVALID_INSTANCE");
+        }
         throw_tox_killed_exception(env, instance_number, "Tox function invoked on invalid tox instance");
         return default_value<return_type>();
     }
@@ -18,6 +25,9 @@ with_instance(JNIEnv *env, jint instance_number, Func func)
     auto const &instance = instance_manager<tox_traits>::self[instance_number];
 
     if (!instance.isLive()) {
+        if (timer != nullptr) {
+            timer->error("KILLED");
+        }
         throw_tox_killed_exception(env, instance_number, "Tox function invoked on killed tox instance");
         return default_value<return_type>();
     }
@@ -28,10 +38,19 @@ with_instance(JNIEnv *env, jint instance_number, Func func)
     });
 }
 
+// As above, recording the call in the native statistics under the given method name.
+template<typename Func>
+typename std::result_of<Func(tox_traits::subsystem *, Events &)>::type
+with_instance(JNIEnv *env, jint instance_number, char const *method, Func func)
+{
+    method_timer timer(tox_traits::module, method);
+    return with_instance(env, instance_number, func, &timer);
+}
+
 
 template<typename ErrorFunc, typename SuccessFunc, typename ToxFunc, typename... Args>
 tox_success_t<SuccessFunc, ToxFunc, Args...>
-with_error_handling(JNIEnv *env, char const *method, ErrorFunc error_func, SuccessFunc success_func, ToxFunc tox_func, Args ...args)
+handle_tox_errors(JNIEnv *env, char const *method, method_timer &timer, ErrorFunc error_func, SuccessFunc success_func, ToxFunc tox_func, Args ...args)
 {
     tox_error_t<ToxFunc> error;
     auto value = tox_func(args..., &error);
@@ -40,9 +59,11 @@ with_error_handling(JNIEnv *env, char const *method, ErrorFunc error_func, Succe
         case ErrorHandling::SUCCESS:
             return success_func(value);
         case ErrorHandling::FAILURE:
+            timer.error(result.error);
             throw_tox_exception(env, tox_traits::module, method, result.error);
             break;
         case ErrorHandling::UNHANDLED:
+            timer.error("UNHANDLED");
             throw_illegal_state_exception(env, error, "Unknown error code");
             break;
     }
@@ -51,12 +72,22 @@ with_error_handling(JNIEnv *env, char const *method, ErrorFunc error_func, Succe
 }
 
 
+template<typename ErrorFunc, typename SuccessFunc, typename ToxFunc, typename... Args>
+tox_success_t<SuccessFunc, ToxFunc, Args...>
+with_error_handling(JNIEnv *env, char const *method, ErrorFunc error_func, SuccessFunc success_func, ToxFunc tox_func, Args ...args)
+{
+    method_timer timer(tox_traits::module, method);
+    return handle_tox_errors(env, method, timer, error_func, success_func, tox_func, args...);
+}
+
+
 template<typename ErrorFunc, typename SuccessFunc, typename ToxFunc, typename... Args>
 tox_success_t<SuccessFunc, ToxFunc, tox_traits::subsystem *, Args...>
 with_instance(JNIEnv *env, jint instanceNumber, char const *method, ErrorFunc error_func, SuccessFunc success_func, ToxFunc tox_func, Args ...args)
 {
-    return with_instance(env, instanceNumber, [=](tox_traits::subsystem *tox, Events &events) {
+    method_timer timer(tox_traits::module, method);
+    return with_instance(env, instanceNumber, [=, &timer](tox_traits::subsystem *tox, Events &events) {
         (void)events;
-        return with_error_handling(env, method, error_func, success_func, tox_func, tox, args...);
-    });
+        return handle_tox_errors(env, method, timer, error_func, success_func, tox_func, tox, args...);
+    }, &timer);
 }
@@ -4,13 +4,23 @@ import com.google.protobuf.InvalidProtocolBufferException;
 import im.tox.tox4j.annotations.NotNull;
 import im.tox.tox4j.annotations.Nullable;
 import im.tox.tox4j.av.ToxAv;
+import im.tox.tox4j.av.ToxAvMemoryUsage;
+import im.tox.tox4j.av.ToxCallStats;
+import im.tox.tox4j.av.ToxRequestStats;
+import im.tox.tox4j.av.ToxStreamStats;
+import im.tox.tox4j.av.ToxVideoReceiveStats;
+import im.tox.tox4j.av.ToxVideoSendStats;
 import im.tox.tox4j.av.callbacks.*;
 import im.tox.tox4j.av.enums.ToxCallControl;
 import im.tox.tox4j.av.enums.ToxCallState;
+import im.tox.tox4j.av.enums.ToxVideoFormat;
 import im.tox.tox4j.av.exceptions.*;
 import im.tox.tox4j.av.proto.Av;
+import im.tox.tox4j.core.ToxConstants;
 import im.tox.tox4j.core.ToxCore;
 
+import java.util.List;
+
 public final class ToxAvImpl implements ToxAv {
 
     static {
@@ -72,6 +82,26 @@ public final class ToxAvImpl implements ToxAv {
     }
 
 
+    private static native void toxAvSetMaxIterationInterval(int instanceNumber, int maxInterval);
+
+    @Override
+    public void setMaxIterationInterval(int maxInterval) {
+        if (maxInterval < ToxConstants.MIN_ITERATION_INTERVAL) {
+            throw new IllegalArgumentException("Iteration interval cap must be at least "
+                    + ToxConstants.MIN_ITERATION_INTERVAL + " ms");
+        }
+        toxAvSetMaxIterationInterval(instanceNumber, maxInterval);
+    }
+
+
+    private static native int toxAvIterationWakeups(int instanceNumber);
+
+    @Override
+    public int getIterationWakeups() {
+        return toxAvIterationWakeups(instanceNumber);
+    }
+
+
     private static ToxCallState convert(Av.CallState.Kind kind) {
         switch (kind) {
             case RINGING: return ToxCallState.RINGING;
@@ -90,7 +120,25 @@ public final class ToxAvImpl implements ToxAv {
 
     @Override
     public void iteration() {
-        byte[] events = toxAvIteration(instanceNumber);
+        dispatchEvents(toxAvIteration(instanceNumber));
+    }
+
+
+    private static native @NotNull byte[] toxAvIterationLimited(int instanceNumber, int maxEvents, int maxBytes);
+
+    @Override
+    public boolean iteration(int maxEvents, int maxBytes) {
+        if (maxEvents <= 0) {
+            throw new IllegalArgumentException("Maximum number of events must be positive");
+        }
+        if (maxBytes < 0) {
+            throw new IllegalArgumentException("Maximum number of bytes cannot be negative");
+        }
+        return dispatchEvents(toxAvIterationLimited(instanceNumber, maxEvents, maxBytes)).getMorePending();
+    }
+
+    @NotNull
+    private Av.AvEvents dispatchEvents(@NotNull byte[] events) {
         Av.AvEvents toxEvents;
         try {
             toxEvents = Av.AvEvents.parseFrom(events);
@@ -142,6 +190,8 @@ public final class ToxAvImpl implements ToxAv {
                 );
             }
         }
+
+        return toxEvents;
     }
 
 
@@ -207,6 +257,15 @@ public final class ToxAvImpl implements ToxAv {
         toxAvSendVideoFrame(instanceNumber, friendNumber, width, height, y, u, v, a);
     }
 
+
+    private static native void toxAvSendVideoFramePacked(int instanceNumber, int friendNumber, int width, int height, int format, byte[] data) throws ToxSendFrameException;
+
+    @Override
+    public void sendVideoFrame(int friendNumber, int width, int height, @NotNull ToxVideoFormat format, @NotNull byte[] data) throws ToxSendFrameException {
+        toxAvSendVideoFramePacked(instanceNumber, friendNumber, width, height, format.ordinal(), data);
+    }
+
+
     @Override
     public void callbackRequestAudioFrame(@Nullable RequestAudioFrameCallback callback) {
         this.requestAudioFrameCallback = callback;
@@ -220,6 +279,7 @@ public final class ToxAvImpl implements ToxAv {
         toxAvSendAudioFrame(instanceNumber, friendNumber, pcm, sampleCount, channels, samplingRate);
     }
 
+
     @Override
     public void callbackReceiveVideoFrame(ReceiveVideoFrameCallback callback) {
         this.receiveVideoFrameCallback = callback;
@@ -230,6 +290,80 @@ public final class ToxAvImpl implements ToxAv {
         this.receiveAudioFrameCallback = callback;
     }
 
+
+    private static native void toxAvMixerAddFriend(int instanceNumber, int friendNumber) throws ToxMixerException;
+
+    @Override
+    public void mixerAddFriend(int friendNumber) throws ToxMixerException {
+        toxAvMixerAddFriend(instanceNumber, friendNumber);
+    }
+
+
+    private static native void toxAvMixerRemoveFriend(int instanceNumber, int friendNumber) throws ToxMixerException;
+
+    @Override
+    public void mixerRemoveFriend(int friendNumber) throws ToxMixerException {
+        toxAvMixerRemoveFriend(instanceNumber, friendNumber);
+    }
+
+
+    private static native @NotNull byte[] toxAvGetCallStats(int instanceNumber, int friendNumber) throws ToxCallStatsException;
+
+    @NotNull
+    private static int[] toIntArray(@NotNull List<Integer> list) {
+        int[] array = new int[list.size()];
+        for (int i = 0; i < array.length; i++) {
+            array[i] = list.get(i);
+        }
+        return array;
+    }
+
+    @NotNull
+    private static ToxStreamStats convert(@NotNull Av.StreamStats stats) {
+        return new ToxStreamStats(stats.getFramesRequested(), stats.getFramesSent(), stats.getFramesReceived(),
+                stats.getFramesDropped(), stats.getEncodeTimeAverage(), stats.getEncodeTimeMax(), stats.getBitRate(),
+                stats.getConfiguredBitRate(), stats.getJitter(), stats.getSendLatencyMax(),
+                toIntArray(stats.getSendLatencyList()));
+    }
+
+    @NotNull
+    @Override
+    public ToxCallStats getCallStats(int friendNumber) throws ToxCallStatsException {
+        Av.CallStats stats;
+        try {
+            stats = Av.CallStats.parseFrom(toxAvGetCallStats(instanceNumber, friendNumber));
+        } catch (InvalidProtocolBufferException e) {
+            throw new RuntimeException(e);
+        }
+
+        Av.VideoSendStats videoSend = stats.getVideoSend();
+        Av.VideoReceiveStats videoReceive = stats.getVideoReceive();
+        Av.RequestStats requests = stats.getRequests();
+        return new ToxCallStats(
+                new ToxVideoSendStats(videoSend.getFrames(), videoSend.getScaledFrames(),
+                        videoSend.getLastConvertTime(), videoSend.getLastScaleTime(), videoSend.getLastEncodeTime(),
+                        videoSend.getMaxConvertTime(), videoSend.getMaxScaleTime(), videoSend.getMaxEncodeTime()),
+                new ToxVideoReceiveStats(videoReceive.getFrames(), videoReceive.getBufferAllocations(),
+                        videoReceive.getLastCopyTime(), videoReceive.getMaxCopyTime()),
+                new ToxRequestStats(requests.getAudioRequests(), requests.getVideoRequests(),
+                        requests.getSkippedDeadlines(), requests.getMaxLateness(),
+                        toIntArray(requests.getLatenessList())),
+                convert(stats.getAudio()),
+                convert(stats.getVideo())
+        );
+    }
+
+
+    private static native @NotNull long[] toxAvGetMemoryUsage(int instanceNumber);
+
+    @NotNull
+    @Override
+    public ToxAvMemoryUsage getMemoryUsage() {
+        long[] usage = toxAvGetMemoryUsage(instanceNumber);
+        return new ToxAvMemoryUsage(usage[0], usage[1], usage[2], usage[3], usage[4]);
+    }
+
+
     @Override
     public void callback(@Nullable ToxAvEventListener handler) {
         callbackCall(handler);
@@ -4,15 +4,27 @@ import com.google.protobuf.InvalidProtocolBufferException;
 import im.tox.tox4j.annotations.NotNull;
 import im.tox.tox4j.annotations.Nullable;
 import im.tox.tox4j.core.AbstractToxCore;
+import im.tox.tox4j.core.ToxAutosaveStats;
 import im.tox.tox4j.core.ToxConstants;
+import im.tox.tox4j.core.ToxEventBudgetStats;
+import im.tox.tox4j.core.ToxMemoryUsage;
 import im.tox.tox4j.core.ToxOptions;
 import im.tox.tox4j.core.callbacks.*;
 import im.tox.tox4j.core.enums.ToxConnection;
+import im.tox.tox4j.core.enums.ToxEventOverflow;
 import im.tox.tox4j.core.enums.ToxFileControl;
 import im.tox.tox4j.core.enums.ToxFileKind;
+import im.tox.tox4j.core.enums.ToxSaveFormat;
 import im.tox.tox4j.core.enums.ToxStatus;
 import im.tox.tox4j.core.exceptions.*;
 import im.tox.tox4j.core.proto.Core;
+import im.tox.tox4j.proto.Stats;
+
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.List;
+import java.util.Map;
+import java.util.TreeMap;
 
 public final class ToxCoreImpl extends AbstractToxCore {
 
@@ -52,6 +64,7 @@ public final class ToxCoreImpl extends AbstractToxCore {
     private FileRequestChunkCallback fileRequestChunkCallback;
     private FileReceiveCallback fileReceiveCallback;
     private FileReceiveChunkCallback fileReceiveChunkCallback;
+    private FileProgressCallback fileProgressCallback;
     private FriendLossyPacketCallback friendLossyPacketCallback;
     private FriendLosslessPacketCallback friendLosslessPacketCallback;
 
@@ -84,14 +97,49 @@ public final class ToxCoreImpl extends AbstractToxCore {
     }
 
     public ToxCoreImpl(@NotNull ToxOptions options, @NotNull byte[] data) throws ToxNewException {
-        instanceNumber = toxNew(
+        this(toxNew(
             data,
             options.isIpv6Enabled(),
             options.isUdpEnabled(),
             options.getProxyType().ordinal(),
             options.getProxyAddress(),
             options.getProxyPort()
-        );
+        ));
+    }
+
+    private ToxCoreImpl(int instanceNumber) {
+        this.instanceNumber = instanceNumber;
+    }
+
+
+    private static native int toxNewFromFile(
+        String path,
+        boolean ipv6Enabled,
+        boolean udpEnabled,
+        int proxyType,
+        String proxyAddress,
+        int proxyPort
+    ) throws ToxNewException;
+
+    /**
+     * Create a new instance from a save file. The file is memory-mapped and loaded natively, so its contents are never
+     * copied onto the Java heap.
+     *
+     * @param options the startup options.
+     * @param path    the path of a file containing data previously returned by {@link #save()}.
+     * @return the new instance.
+     * @throws ToxNewException if the file could not be read or loaded.
+     */
+    @NotNull
+    public static ToxCoreImpl fromFile(@NotNull ToxOptions options, @NotNull String path) throws ToxNewException {
+        return new ToxCoreImpl(toxNewFromFile(
+            path,
+            options.isIpv6Enabled(),
+            options.isUdpEnabled(),
+            options.getProxyType().ordinal(),
+            options.getProxyAddress(),
+            options.getProxyPort()
+        ));
     }
 
 
@@ -128,6 +176,134 @@ public final class ToxCoreImpl extends AbstractToxCore {
     }
 
 
+    private static native byte[] toxSaveFormatted(int instanceNumber, int format);
+
+    @NotNull
+    @Override
+    public byte[] save(@NotNull ToxSaveFormat format) {
+        return toxSaveFormatted(instanceNumber, format.ordinal());
+    }
+
+
+    private static native void toxSetAutosave(int instanceNumber, @Nullable String path, int minInterval) throws ToxSetAutosaveException;
+
+    @Override
+    public void setAutosave(@Nullable String path, int minInterval) throws ToxSetAutosaveException {
+        if (minInterval < 0) {
+            throw new IllegalArgumentException("Autosave interval cannot be negative");
+        }
+        toxSetAutosave(instanceNumber, path, minInterval);
+    }
+
+
+    private static native void toxSetAutosaveFormat(int instanceNumber, int format);
+
+    @Override
+    public void setAutosaveFormat(@NotNull ToxSaveFormat format) {
+        toxSetAutosaveFormat(instanceNumber, format.ordinal());
+    }
+
+
+    private static native @NotNull int[] toxGetAutosaveStats(int instanceNumber);
+
+    @NotNull
+    @Override
+    public ToxAutosaveStats getAutosaveStats() {
+        int[] stats = toxGetAutosaveStats(instanceNumber);
+        return new ToxAutosaveStats(stats[0], stats[1], stats[2], stats[3], stats[4]);
+    }
+
+
+    private static native @NotNull long[] toxGetMemoryUsage(int instanceNumber);
+
+    @NotNull
+    @Override
+    public ToxMemoryUsage getMemoryUsage() {
+        long[] usage = toxGetMemoryUsage(instanceNumber);
+        return new ToxMemoryUsage(usage[0], usage[1], usage[2], usage[3], usage[4]);
+    }
+
+
+    private static native void toxSetEventBudget(int instanceNumber, int budget, int overflow);
+
+    @Override
+    public void setEventBudget(int budget, @NotNull ToxEventOverflow overflow) {
+        if (budget < 0) {
+            throw new IllegalArgumentException("Event budget cannot be negative");
+        }
+        toxSetEventBudget(instanceNumber, budget, overflow.ordinal());
+    }
+
+
+    private static native @NotNull long[] toxGetEventBudgetStats(int instanceNumber);
+
+    @NotNull
+    @Override
+    public ToxEventBudgetStats getEventBudgetStats() {
+        long[] stats = toxGetEventBudgetStats(instanceNumber);
+        return new ToxEventBudgetStats(stats[0], stats[1], stats[2], stats[3]);
+    }
+
+
+    private static native void toxSetNativeStatsEnabled(boolean enabled);
+
+    /**
+     * Turn recording of per-method call counts, error codes and latencies in the native library on or off. Recording
+     * is off by default and applies to all instances. While it is off, it costs a single branch per native call.
+     */
+    public static void setNativeStatsEnabled(boolean enabled) {
+        toxSetNativeStatsEnabled(enabled);
+    }
+
+
+    private static native @NotNull byte[] toxGetNativeStats();
+
+    /**
+     * Take a snapshot of the native per-method statistics of all instances.
+     */
+    @NotNull
+    public static ToxNativeStats getNativeStats() {
+        Stats.NativeStats stats;
+        try {
+            stats = Stats.NativeStats.parseFrom(toxGetNativeStats());
+        } catch (InvalidProtocolBufferException e) {
+            throw new RuntimeException(e);
+        }
+
+        List<ToxMethodStats> methods = new ArrayList<ToxMethodStats>(stats.getMethodCount());
+        for (Stats.MethodStats method : stats.getMethodList()) {
+            Map<String, Long> errorCodes = new TreeMap<String, Long>();
+            for (Stats.ErrorCount error : method.getErrorCountList()) {
+                errorCodes.put(error.getCode(), error.getCount());
+            }
+
+            long[] bucketLimits = new long[method.getLatencyCount()];
+            long[] bucketCounts = new long[method.getLatencyCount()];
+            for (int i = 0; i < bucketLimits.length; i++) {
+                bucketLimits[i] = method.getLatency(i).getLimit();
+                bucketCounts[i] = method.getLatency(i).getCount();
+            }
+
+            methods.add(new ToxMethodStats(method.getModule(), method.getMethod(), method.getCalls(), method.getErrors(),
+                    Collections.unmodifiableMap(errorCodes), method.getTotalLatency(), method.getMaxLatency(),
+                    bucketLimits, bucketCounts));
+        }
+        return new ToxNativeStats(stats.getEnabled(), Collections.unmodifiableList(methods));
+    }
+
+
+    private static native @NotNull long[] toxGetNativeMemoryUsage();
+
+    /**
+     * Sum up the native memory of all live Tox and ToxAv instances. Briefly locks each instance in turn.
+     */
+    @NotNull
+    public static ToxNativeMemoryUsage getNativeMemoryUsage() {
+        long[] usage = toxGetNativeMemoryUsage();
+        return new ToxNativeMemoryUsage(usage[0], usage[1], usage[2], usage[3]);
+    }
+
+
     private static native void toxBootstrap(int instanceNumber, @NotNull String address, int port, @NotNull byte[] public_key) throws ToxBootstrapException;
     private static native void toxAddTcpRelay(int instanceNumber, @NotNull String address, int port, @NotNull byte[] public_key) throws ToxBootstrapException;
 
@@ -202,6 +378,26 @@ public final class ToxCoreImpl extends AbstractToxCore {
     }
 
 
+    private static native void toxSetMaxIterationInterval(int instanceNumber, int maxInterval);
+
+    @Override
+    public void setMaxIterationInterval(int maxInterval) {
+        if (maxInterval < ToxConstants.MIN_ITERATION_INTERVAL) {
+            throw new IllegalArgumentException("Iteration interval cap must be at least "
+                    + ToxConstants.MIN_ITERATION_INTERVAL + " ms");
+        }
+        toxSetMaxIterationInterval(instanceNumber, maxInterval);
+    }
+
+
+    private static native int toxIterationWakeups(int instanceNumber);
+
+    @Override
+    public int getIterationWakeups() {
+        return toxIterationWakeups(instanceNumber);
+    }
+
+
     private static @NotNull ToxConnection convert(@NotNull Core.Socket status) {
         switch (status) {
             case NONE: return ToxConnection.NONE;
@@ -243,7 +439,25 @@ public final class ToxCoreImpl extends AbstractToxCore {
 
     @Override
     public void iteration() {
-        byte[] events = toxIteration(instanceNumber);
+        dispatchEvents(toxIteration(instanceNumber));
+    }
+
+
+    private static native @NotNull byte[] toxIterationLimited(int instanceNumber, int maxEvents, int maxBytes);
+
+    @Override
+    public boolean iteration(int maxEvents, int maxBytes) {
+        if (maxEvents <= 0) {
+            throw new IllegalArgumentException("Maximum number of events must be positive");
+        }
+        if (maxBytes < 0) {
+            throw new IllegalArgumentException("Maximum number of bytes cannot be negative");
+        }
+        return dispatchEvents(toxIterationLimited(instanceNumber, maxEvents, maxBytes)).getMorePending();
+    }
+
+    @NotNull
+    private Core.CoreEvents dispatchEvents(@NotNull byte[] events) {
         Core.CoreEvents toxEvents;
         try {
             toxEvents = Core.CoreEvents.parseFrom(events);
@@ -322,6 +536,11 @@ public final class ToxCoreImpl extends AbstractToxCore {
 				fileReceiveChunkCallback.fileReceiveChunk(fileReceiveChunk.getFriendNumber(), fileReceiveChunk.getFileNumber(), fileReceiveChunk.getPosition(), fileReceiveChunk.getData().toByteArray());
 			}
 		}
+        if (fileProgressCallback != null) {
+			for (Core.FileProgress fileProgress : toxEvents.getFileProgressList()) {
+				fileProgressCallback.fileProgress(fileProgress.getFriendNumber(), fileProgress.getFileNumber(), fileProgress.getPosition());
+			}
+		}
         if (friendLossyPacketCallback != null) {
 			for (Core.FriendLossyPacket friendLossyPacket : toxEvents.getFriendLossyPacketList()) {
 				friendLossyPacketCallback.friendLossyPacket(friendLossyPacket.getFriendNumber(), friendLossyPacket.getData().toByteArray());
@@ -332,6 +551,8 @@ public final class ToxCoreImpl extends AbstractToxCore {
 				friendLosslessPacketCallback.friendLosslessPacket(friendLosslessPacket.getFriendNumber(), friendLosslessPacket.getData().toByteArray());
 			}
 		}
+
+        return toxEvents;
     }
 
 
@@ -592,11 +813,19 @@ public final class ToxCoreImpl extends AbstractToxCore {
     }
 
 
-    private static native void toxFileSendChunk(int instanceNumber, int friendNumber, int fileNumber, @NotNull byte[] data) throws ToxFileSendChunkException;
+    private static native int toxFileSendFromPath(int instanceNumber, int friendNumber, int kind, @NotNull String path, @NotNull byte[] filename) throws ToxFileSendFromPathException;
+
+    @Override
+    public int fileSendFromPath(int friendNumber, @NotNull ToxFileKind kind, @NotNull String path, @NotNull byte[] filename) throws ToxFileSendFromPathException {
+        return toxFileSendFromPath(instanceNumber, friendNumber, kind.ordinal(), path, filename);
+    }
+
+
+    private static native void toxFileSendChunk(int instanceNumber, int friendNumber, int fileNumber, long position, @NotNull byte[] data) throws ToxFileSendChunkException;
 
     @Override
-    public void fileSendChunk(int friendNumber, int fileNumber, @NotNull byte[] data) throws ToxFileSendChunkException {
-        toxFileSendChunk(instanceNumber, friendNumber, fileNumber, data);
+    public void fileSendChunk(int friendNumber, int fileNumber, long position, @NotNull byte[] data) throws ToxFileSendChunkException {
+        toxFileSendChunk(instanceNumber, friendNumber, fileNumber, position, data);
     }
 
 
@@ -616,6 +845,19 @@ public final class ToxCoreImpl extends AbstractToxCore {
     }
 
 
+    private static native void toxFileSetSink(int instanceNumber, int friendNumber, int fileNumber, @NotNull String path) throws ToxFileSetSinkException;
+
+    @Override
+    public void fileSetSink(int friendNumber, int fileNumber, @NotNull String path) throws ToxFileSetSinkException {
+        toxFileSetSink(instanceNumber, friendNumber, fileNumber, path);
+    }
+
+    @Override
+    public void callbackFileProgress(FileProgressCallback callback) {
+        this.fileProgressCallback = callback;
+    }
+
+
     private static native void toxSendLossyPacket(int instanceNumber, int friendNumber, @NotNull byte[] data) throws ToxSendCustomPacketException;
 
     @Override
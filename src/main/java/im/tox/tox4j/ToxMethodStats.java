@@ -0,0 +1,118 @@
+package im.tox.tox4j;
+
+import im.tox.tox4j.annotations.NotNull;
+
+import java.util.Map;
+
+/**
+ * Call statistics of one native method, as recorded while native statistics were enabled. Methods are named as in
+ * their exceptions, so natives sharing an exception type (e.g. getUdpPort and getTcpPort) are counted together.
+ * Latencies are in nanoseconds and cover the whole native call, including waiting for the instance lock.
+ */
+public final class ToxMethodStats {
+
+    /**
+     * "core" or "av".
+     */
+    private final @NotNull String module;
+    private final @NotNull String method;
+    private final long calls;
+    /**
+     * Number of calls that threw an exception.
+     */
+    private final long errors;
+    /**
+     * Number of errors by error code. Codes are those of the method's exception, or KILLED, INVALID_INSTANCE,
+     * INCOMPLETE_OBJECT and UNHANDLED for errors not specific to the method.
+     */
+    private final @NotNull Map<String, Long> errorCodes;
+    private final long totalLatency;
+    private final long maxLatency;
+    /**
+     * Latency histogram: bucketCounts[i] calls took less than bucketLimits[i] nanoseconds, and at least
+     * bucketLimits[i - 1]. Only non-empty buckets are listed. Each bucket is at most 12.5% wide.
+     */
+    private final @NotNull long[] bucketLimits;
+    private final @NotNull long[] bucketCounts;
+
+    public ToxMethodStats(@NotNull String module, @NotNull String method, long calls, long errors,
+                          @NotNull Map<String, Long> errorCodes, long totalLatency, long maxLatency,
+                          @NotNull long[] bucketLimits, @NotNull long[] bucketCounts) {
+        this.module = module;
+        this.method = method;
+        this.calls = calls;
+        this.errors = errors;
+        this.errorCodes = errorCodes;
+        this.totalLatency = totalLatency;
+        this.maxLatency = maxLatency;
+        this.bucketLimits = bucketLimits;
+        this.bucketCounts = bucketCounts;
+    }
+
+    @NotNull
+    public String getModule() {
+        return module;
+    }
+
+    @NotNull
+    public String getMethod() {
+        return method;
+    }
+
+    public long getCalls() {
+        return calls;
+    }
+
+    public long getErrors() {
+        return errors;
+    }
+
+    @NotNull
+    public Map<String, Long> getErrorCodes() {
+        return errorCodes;
+    }
+
+    public long getTotalLatency() {
+        return totalLatency;
+    }
+
+    public long getMeanLatency() {
+        return calls == 0 ? 0 : totalLatency / calls;
+    }
+
+    public long getMaxLatency() {
+        return maxLatency;
+    }
+
+    @NotNull
+    public long[] getBucketLimits() {
+        return bucketLimits.clone();
+    }
+
+    @NotNull
+    public long[] getBucketCounts() {
+        return bucketCounts.clone();
+    }
+
+    /**
+     * An upper bound for the given percentile (0 to 100) of the latency: the limit of the histogram bucket containing
+     * it, but never more than the maximum latency.
+     */
+    public long getLatencyPercentile(double percentile) {
+        long total = 0;
+        for (long count : bucketCounts) {
+            total += count;
+        }
+
+        long rank = (long) Math.ceil(total * percentile / 100);
+        long seen = 0;
+        for (int i = 0; i < bucketCounts.length; i++) {
+            seen += bucketCounts[i];
+            if (seen >= rank) {
+                return Math.min(bucketLimits[i], maxLatency);
+            }
+        }
+        return maxLatency;
+    }
+
+}
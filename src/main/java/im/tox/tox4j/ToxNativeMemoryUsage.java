@@ -0,0 +1,50 @@
+package im.tox.tox4j;
+
+/**
+ * Native memory of the whole library, in bytes: the sum of the usage of all live Tox and ToxAv instances and the
+ * instance tables, next to the heap in use by the whole process as reported by the C library.
+ */
+public final class ToxNativeMemoryUsage {
+
+    /**
+     * Number of live Tox instances.
+     */
+    private final long coreInstances;
+    /**
+     * Number of live ToxAv instances.
+     */
+    private final long avInstances;
+    /**
+     * Memory accounted to the instances and the instance tables. Includes the estimates of toxcore's and toxav's own
+     * state, so it inherits their unreliability under concurrent activity.
+     */
+    private final long accounted;
+    /**
+     * Heap in use by the process, including the JVM's own native allocations. 0 if the C library does not report it.
+     */
+    private final long heapInUse;
+
+    public ToxNativeMemoryUsage(long coreInstances, long avInstances, long accounted, long heapInUse) {
+        this.coreInstances = coreInstances;
+        this.avInstances = avInstances;
+        this.accounted = accounted;
+        this.heapInUse = heapInUse;
+    }
+
+    public long getCoreInstances() {
+        return coreInstances;
+    }
+
+    public long getAvInstances() {
+        return avInstances;
+    }
+
+    public long getAccounted() {
+        return accounted;
+    }
+
+    public long getHeapInUse() {
+        return heapInUse;
+    }
+
+}
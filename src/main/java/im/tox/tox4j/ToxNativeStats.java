@@ -0,0 +1,47 @@
+package im.tox.tox4j;
+
+import im.tox.tox4j.annotations.NotNull;
+import im.tox.tox4j.annotations.Nullable;
+
+import java.util.List;
+
+/**
+ * A snapshot of the per-method statistics of the native library, shared by all Tox and ToxAv instances. Counters are
+ * cumulative since the library was loaded; compare two snapshots to measure an interval.
+ */
+public final class ToxNativeStats {
+
+    /**
+     * Whether calls were being recorded when the snapshot was taken.
+     */
+    private final boolean enabled;
+    /**
+     * All methods that were called while recording was enabled, ordered by module and method name.
+     */
+    private final @NotNull List<ToxMethodStats> methods;
+
+    public ToxNativeStats(boolean enabled, @NotNull List<ToxMethodStats> methods) {
+        this.enabled = enabled;
+        this.methods = methods;
+    }
+
+    public boolean isEnabled() {
+        return enabled;
+    }
+
+    @NotNull
+    public List<ToxMethodStats> getMethods() {
+        return methods;
+    }
+
+    @Nullable
+    public ToxMethodStats getMethod(@NotNull String module, @NotNull String method) {
+        for (ToxMethodStats stats : methods) {
+            if (stats.getModule().equals(module) && stats.getMethod().equals(method)) {
+                return stats;
+            }
+        }
+        return null;
+    }
+
+}
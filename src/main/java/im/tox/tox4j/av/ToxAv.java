@@ -4,6 +4,7 @@ import im.tox.tox4j.annotations.NotNull;
 import im.tox.tox4j.annotations.Nullable;
 import im.tox.tox4j.av.callbacks.*;
 import im.tox.tox4j.av.enums.ToxCallControl;
+import im.tox.tox4j.av.enums.ToxVideoFormat;
 import im.tox.tox4j.av.exceptions.*;
 
 import java.io.Closeable;
@@ -17,6 +18,20 @@ public interface ToxAv extends Closeable {
 
     void iteration();
 
+    /**
+     * Deliver at most maxEvents events or about maxBytes of events, leaving the rest queued. New frames are only
+     * received and new frame requests only issued once the queued events fit into maxBytes, so the queue stays bounded
+     * by about maxBytes plus one iteration's events.
+     *
+     * @return true if events are still queued.
+     * @see im.tox.tox4j.core.ToxCore#iteration(int, int)
+     */
+    boolean iteration(int maxEvents, int maxBytes);
+
+    void setMaxIterationInterval(int maxInterval);
+
+    int getIterationWakeups();
+
     void call(int friendNumber, int audioBitRate, int videoBitRate) throws ToxCallException;
 
     void callbackCall(@Nullable CallCallback callback);
@@ -35,6 +50,8 @@ public interface ToxAv extends Closeable {
 
     void sendVideoFrame(int friendNumber, int width, int height, @NotNull byte[] y, @NotNull byte[] u, @NotNull byte[] v, @Nullable byte[] a) throws ToxSendFrameException;
 
+    void sendVideoFrame(int friendNumber, int width, int height, @NotNull ToxVideoFormat format, @NotNull byte[] data) throws ToxSendFrameException;
+
     void callbackRequestAudioFrame(@Nullable RequestAudioFrameCallback callback);
 
     void sendAudioFrame(int friendNumber, @NotNull short[] pcm, int sampleCount, int channels, int samplingRate) throws ToxSendFrameException;
@@ -43,6 +60,16 @@ public interface ToxAv extends Closeable {
 
     void callbackReceiveAudioFrame(@Nullable ReceiveAudioFrameCallback callback);
 
+    void mixerAddFriend(int friendNumber) throws ToxMixerException;
+
+    void mixerRemoveFriend(int friendNumber) throws ToxMixerException;
+
+    @NotNull
+    ToxCallStats getCallStats(int friendNumber) throws ToxCallStatsException;
+
+    @NotNull
+    ToxAvMemoryUsage getMemoryUsage();
+
     /**
      * Convenience method to set all event handlers at once.
      *
@@ -0,0 +1,66 @@
+package im.tox.tox4j.av;
+
+/**
+ * Native memory held by one ToxAv instance, in bytes. Toxav's own share is only an estimate; see
+ * {@link #getAvEstimate}. Everything else counts the capacity of the native buffers, not just the part in use.
+ */
+public final class ToxAvMemoryUsage {
+
+    /**
+     * Estimate of toxav's own state, as allocated when the instance was created.
+     */
+    private final long avEstimate;
+    /**
+     * Per-call state: resamplers, scalers and conversion buffers.
+     */
+    private final long calls;
+    /**
+     * The frame scheduler and the audio mixer with its participant buffers.
+     */
+    private final long mixing;
+    /**
+     * The event buffer, including received frames that were cleared and are kept for reuse.
+     */
+    private final long events;
+    /**
+     * The instance objects themselves and their slot in the instance table.
+     */
+    private final long instance;
+
+    public ToxAvMemoryUsage(long avEstimate, long calls, long mixing, long events, long instance) {
+        this.avEstimate = avEstimate;
+        this.calls = calls;
+        this.mixing = mixing;
+        this.events = events;
+        this.instance = instance;
+    }
+
+    /**
+     * The growth of the process heap while the instance was created. As for
+     * {@link im.tox.tox4j.core.ToxMemoryUsage#getCoreEstimate}, this is unreliable with concurrent activity.
+     */
+    public long getAvEstimate() {
+        return avEstimate;
+    }
+
+    public long getCalls() {
+        return calls;
+    }
+
+    public long getMixing() {
+        return mixing;
+    }
+
+    public long getEvents() {
+        return events;
+    }
+
+    public long getInstance() {
+        return instance;
+    }
+
+    public long getTotal() {
+        return avEstimate + calls + mixing + events + instance;
+    }
+
+}
@@ -0,0 +1,51 @@
+package im.tox.tox4j.av;
+
+import im.tox.tox4j.annotations.NotNull;
+
+/**
+ * All counters the native layer keeps for a call.
+ */
+public final class ToxCallStats {
+
+    private final @NotNull ToxVideoSendStats videoSend;
+    private final @NotNull ToxVideoReceiveStats videoReceive;
+    private final @NotNull ToxRequestStats requests;
+    private final @NotNull ToxStreamStats audio;
+    private final @NotNull ToxStreamStats video;
+
+    public ToxCallStats(@NotNull ToxVideoSendStats videoSend, @NotNull ToxVideoReceiveStats videoReceive,
+                        @NotNull ToxRequestStats requests,
+                        @NotNull ToxStreamStats audio, @NotNull ToxStreamStats video) {
+        this.videoSend = videoSend;
+        this.videoReceive = videoReceive;
+        this.requests = requests;
+        this.audio = audio;
+        this.video = video;
+    }
+
+    @NotNull
+    public ToxVideoSendStats getVideoSend() {
+        return videoSend;
+    }
+
+    @NotNull
+    public ToxVideoReceiveStats getVideoReceive() {
+        return videoReceive;
+    }
+
+    @NotNull
+    public ToxRequestStats getRequests() {
+        return requests;
+    }
+
+    @NotNull
+    public ToxStreamStats getAudio() {
+        return audio;
+    }
+
+    @NotNull
+    public ToxStreamStats getVideo() {
+        return video;
+    }
+
+}
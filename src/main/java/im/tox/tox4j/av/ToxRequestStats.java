@@ -0,0 +1,59 @@
+package im.tox.tox4j.av;
+
+/**
+ * Per-call counters for the frame request events, which are issued at each stream's frame deadline by the first
+ * iteration after it. Lateness is in microseconds.
+ */
+public final class ToxRequestStats {
+
+    /**
+     * Number of audio frame deadlines passed, including those of conference participants.
+     */
+    private final int audioRequests;
+    /**
+     * Number of video frame requests issued.
+     */
+    private final int videoRequests;
+    /**
+     * Number of deadlines skipped because a later one had already passed when the request was issued.
+     */
+    private final int skippedDeadlines;
+    /**
+     * Highest lateness of any request.
+     */
+    private final int maxLateness;
+    /**
+     * Lateness histogram. Bucket 0 counts requests less than a millisecond late, bucket i those at least 2^(i-1) and
+     * less than 2^i milliseconds late. The last bucket has no upper bound.
+     */
+    private final int[] lateness;
+
+    public ToxRequestStats(int audioRequests, int videoRequests, int skippedDeadlines, int maxLateness, int[] lateness) {
+        this.audioRequests = audioRequests;
+        this.videoRequests = videoRequests;
+        this.skippedDeadlines = skippedDeadlines;
+        this.maxLateness = maxLateness;
+        this.lateness = lateness;
+    }
+
+    public int getAudioRequests() {
+        return audioRequests;
+    }
+
+    public int getVideoRequests() {
+        return videoRequests;
+    }
+
+    public int getSkippedDeadlines() {
+        return skippedDeadlines;
+    }
+
+    public int getMaxLateness() {
+        return maxLateness;
+    }
+
+    public int[] getLateness() {
+        return lateness.clone();
+    }
+
+}
@@ -0,0 +1,115 @@
+package im.tox.tox4j.av;
+
+/**
+ * Quality counters for the audio or the video of a call. Times are in microseconds, bit rates in kbit/s.
+ */
+public final class ToxStreamStats {
+
+    /**
+     * Number of frame requests emitted.
+     */
+    private final int framesRequested;
+    /**
+     * Number of encoded frames sent.
+     */
+    private final int framesSent;
+    /**
+     * Number of frames received from the friend.
+     */
+    private final int framesReceived;
+    /**
+     * Number of frames not sent in time: requests still unanswered when the next one was due, and deadlines that
+     * passed without a request.
+     */
+    private final int framesDropped;
+    /**
+     * Average encoding time of a sent frame.
+     */
+    private final int encodeTimeAverage;
+    /**
+     * Highest encoding time of a sent frame.
+     */
+    private final int encodeTimeMax;
+    /**
+     * Bit rate of the encoded frames over the last complete second.
+     */
+    private final int bitRate;
+    /**
+     * Bit rate the call was set up with.
+     */
+    private final int configuredBitRate;
+    /**
+     * Smoothed difference between the intervals of consecutive received frames.
+     */
+    private final int jitter;
+    /**
+     * Highest time from a frame request to the frame sent in response.
+     */
+    private final int sendLatencyMax;
+    /**
+     * Histogram of the time from a frame request to the frame sent in response, with the buckets of
+     * {@link ToxRequestStats#getLateness}.
+     */
+    private final int[] sendLatency;
+
+    public ToxStreamStats(int framesRequested, int framesSent, int framesReceived, int framesDropped,
+                          int encodeTimeAverage, int encodeTimeMax, int bitRate, int configuredBitRate,
+                          int jitter, int sendLatencyMax, int[] sendLatency) {
+        this.framesRequested = framesRequested;
+        this.framesSent = framesSent;
+        this.framesReceived = framesReceived;
+        this.framesDropped = framesDropped;
+        this.encodeTimeAverage = encodeTimeAverage;
+        this.encodeTimeMax = encodeTimeMax;
+        this.bitRate = bitRate;
+        this.configuredBitRate = configuredBitRate;
+        this.jitter = jitter;
+        this.sendLatencyMax = sendLatencyMax;
+        this.sendLatency = sendLatency;
+    }
+
+    public int getFramesRequested() {
+        return framesRequested;
+    }
+
+    public int getFramesSent() {
+        return framesSent;
+    }
+
+    public int getFramesReceived() {
+        return framesReceived;
+    }
+
+    public int getFramesDropped() {
+        return framesDropped;
+    }
+
+    public int getEncodeTimeAverage() {
+        return encodeTimeAverage;
+    }
+
+    public int getEncodeTimeMax() {
+        return encodeTimeMax;
+    }
+
+    public int getBitRate() {
+        return bitRate;
+    }
+
+    public int getConfiguredBitRate() {
+        return configuredBitRate;
+    }
+
+    public int getJitter() {
+        return jitter;
+    }
+
+    public int getSendLatencyMax() {
+        return sendLatencyMax;
+    }
+
+    public int[] getSendLatency() {
+        return sendLatency.clone();
+    }
+
+}
@@ -0,0 +1,49 @@
+package im.tox.tox4j.av;
+
+/**
+ * Per-call counters for the video receive path. Decoded frames with padded rows are packed into a buffer owned by the
+ * call, which is only reallocated when the frame size grows. Times are in microseconds.
+ */
+public final class ToxVideoReceiveStats {
+
+    /**
+     * Number of video frames received in this call.
+     */
+    private final int frames;
+    /**
+     * Number of times the frame buffer had to be allocated or grown.
+     */
+    private final int bufferAllocations;
+    /**
+     * Time spent packing the last frame.
+     */
+    private final int lastCopyTime;
+    /**
+     * Highest time spent packing any frame.
+     */
+    private final int maxCopyTime;
+
+    public ToxVideoReceiveStats(int frames, int bufferAllocations, int lastCopyTime, int maxCopyTime) {
+        this.frames = frames;
+        this.bufferAllocations = bufferAllocations;
+        this.lastCopyTime = lastCopyTime;
+        this.maxCopyTime = maxCopyTime;
+    }
+
+    public int getFrames() {
+        return frames;
+    }
+
+    public int getBufferAllocations() {
+        return bufferAllocations;
+    }
+
+    public int getLastCopyTime() {
+        return lastCopyTime;
+    }
+
+    public int getMaxCopyTime() {
+        return maxCopyTime;
+    }
+
+}
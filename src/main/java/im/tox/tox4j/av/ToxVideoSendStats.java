@@ -0,0 +1,87 @@
+package im.tox.tox4j.av;
+
+/**
+ * Per-call counters for the video send path. Frames larger than the call's maximum resolution are downscaled to fit
+ * before they are encoded. Times are in microseconds and cover a single frame.
+ */
+public final class ToxVideoSendStats {
+
+    /**
+     * Number of video frames sent in this call.
+     */
+    private final int frames;
+    /**
+     * Number of those frames that had to be downscaled.
+     */
+    private final int scaledFrames;
+    /**
+     * Time to convert the last frame to the encoder's format.
+     */
+    private final int lastConvertTime;
+    /**
+     * Time to downscale the last frame, 0 if it was not scaled.
+     */
+    private final int lastScaleTime;
+    /**
+     * Time to encode the last frame.
+     */
+    private final int lastEncodeTime;
+    /**
+     * Highest conversion time of any frame.
+     */
+    private final int maxConvertTime;
+    /**
+     * Highest downscaling time of any frame.
+     */
+    private final int maxScaleTime;
+    /**
+     * Highest encoding time of any frame.
+     */
+    private final int maxEncodeTime;
+
+    public ToxVideoSendStats(int frames, int scaledFrames,
+                             int lastConvertTime, int lastScaleTime, int lastEncodeTime,
+                             int maxConvertTime, int maxScaleTime, int maxEncodeTime) {
+        this.frames = frames;
+        this.scaledFrames = scaledFrames;
+        this.lastConvertTime = lastConvertTime;
+        this.lastScaleTime = lastScaleTime;
+        this.lastEncodeTime = lastEncodeTime;
+        this.maxConvertTime = maxConvertTime;
+        this.maxScaleTime = maxScaleTime;
+        this.maxEncodeTime = maxEncodeTime;
+    }
+
+    public int getFrames() {
+        return frames;
+    }
+
+    public int getScaledFrames() {
+        return scaledFrames;
+    }
+
+    public int getLastConvertTime() {
+        return lastConvertTime;
+    }
+
+    public int getLastScaleTime() {
+        return lastScaleTime;
+    }
+
+    public int getLastEncodeTime() {
+        return lastEncodeTime;
+    }
+
+    public int getMaxConvertTime() {
+        return maxConvertTime;
+    }
+
+    public int getMaxScaleTime() {
+        return maxScaleTime;
+    }
+
+    public int getMaxEncodeTime() {
+        return maxEncodeTime;
+    }
+
+}
@@ -0,0 +1,8 @@
+package im.tox.tox4j.av.enums;
+
+public enum ToxVideoFormat {
+    NV21,
+    NV12,
+    RGBA,
+    BGRA,
+}
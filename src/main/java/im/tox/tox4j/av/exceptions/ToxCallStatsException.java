@@ -0,0 +1,23 @@
+package im.tox.tox4j.av.exceptions;
+
+import im.tox.tox4j.annotations.NotNull;
+import im.tox.tox4j.exceptions.ToxException;
+
+public class ToxCallStatsException extends ToxException {
+
+    public enum Code {
+        FRIEND_NOT_IN_CALL,
+    }
+
+    private final @NotNull Code code;
+
+    public ToxCallStatsException(@NotNull Code code) {
+        this.code = code;
+    }
+
+    @NotNull
+    @Override
+    public Code getCode() {
+        return code;
+    }
+}
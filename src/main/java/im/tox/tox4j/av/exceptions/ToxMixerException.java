@@ -0,0 +1,25 @@
+package im.tox.tox4j.av.exceptions;
+
+import im.tox.tox4j.annotations.NotNull;
+import im.tox.tox4j.exceptions.ToxException;
+
+public class ToxMixerException extends ToxException {
+
+    public enum Code {
+        FRIEND_NOT_FOUND,
+        ALREADY_MIXED,
+        NOT_MIXED,
+    }
+
+    private final @NotNull Code code;
+
+    public ToxMixerException(@NotNull Code code) {
+        this.code = code;
+    }
+
+    @NotNull
+    @Override
+    public Code getCode() {
+        return code;
+    }
+}
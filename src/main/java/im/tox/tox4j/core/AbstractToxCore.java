@@ -9,6 +9,7 @@ public abstract class AbstractToxCore implements ToxCore {
     public void callback(@Nullable ToxEventListener handler) {
         callbackConnectionStatus(handler);
         callbackFileControl(handler);
+        callbackFileProgress(handler);
         callbackFileReceive(handler);
         callbackFileReceiveChunk(handler);
         callbackFileRequestChunk(handler);
@@ -0,0 +1,58 @@
+package im.tox.tox4j.core;
+
+/**
+ * Counters for the background autosave facility. Latencies are in microseconds and cover writing, syncing and
+ * renaming the save file.
+ */
+public final class ToxAutosaveStats {
+
+    /**
+     * Number of snapshots written to disk.
+     */
+    private final int saves;
+    /**
+     * Number of snapshots that were identical to the last saved one and therefore not written.
+     */
+    private final int skipped;
+    /**
+     * Number of writes that failed.
+     */
+    private final int failures;
+    /**
+     * Latency of the last successful write.
+     */
+    private final int lastLatency;
+    /**
+     * Highest latency of any successful write.
+     */
+    private final int maxLatency;
+
+    public ToxAutosaveStats(int saves, int skipped, int failures, int lastLatency, int maxLatency) {
+        this.saves = saves;
+        this.skipped = skipped;
+        this.failures = failures;
+        this.lastLatency = lastLatency;
+        this.maxLatency = maxLatency;
+    }
+
+    public int getSaves() {
+        return saves;
+    }
+
+    public int getSkipped() {
+        return skipped;
+    }
+
+    public int getFailures() {
+        return failures;
+    }
+
+    public int getLastLatency() {
+        return lastLatency;
+    }
+
+    public int getMaxLatency() {
+        return maxLatency;
+    }
+
+}
@@ -52,4 +52,10 @@ public interface ToxConstants {
      */
     int HASH_LENGTH                 = /*crypto_hash_sha256_BYTES*/ 32;
 
+    /**
+     * The iteration interval in milliseconds while file transfers or calls are running, and the smallest cap accepted
+     * by setMaxIterationInterval.
+     */
+    int MIN_ITERATION_INTERVAL      = 5;
+
 }
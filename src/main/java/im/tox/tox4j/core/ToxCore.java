@@ -3,8 +3,10 @@ package im.tox.tox4j.core;
 import im.tox.tox4j.annotations.NotNull;
 import im.tox.tox4j.annotations.Nullable;
 import im.tox.tox4j.core.callbacks.*;
+import im.tox.tox4j.core.enums.ToxEventOverflow;
 import im.tox.tox4j.core.enums.ToxFileControl;
 import im.tox.tox4j.core.enums.ToxFileKind;
+import im.tox.tox4j.core.enums.ToxSaveFormat;
 import im.tox.tox4j.core.enums.ToxStatus;
 import im.tox.tox4j.core.exceptions.*;
 
@@ -38,6 +40,72 @@ public interface ToxCore extends Closeable {
     @NotNull
     byte[] save();
 
+    /**
+     * Save the current tox instance in the given format. Instances can be created from the result of any format.
+     *
+     * @param format the format of the save data.
+     * @return a byte array containing the tox instance
+     */
+    @NotNull
+    byte[] save(@NotNull ToxSaveFormat format);
+
+    /**
+     * Periodically save the tox instance to a file in the background.
+     * <p>
+     * At most every minInterval milliseconds, {@link #iteration()} takes a snapshot of the data {@link #save()} would
+     * return. If it differs from the last saved snapshot, it is written on a native background thread to a temporary
+     * file, which is synced to disk and renamed over the save file. A last snapshot is written in {@link #close()}.
+     *
+     * @param path        the path of the save file, or <code>null</code> to disable autosaving.
+     * @param minInterval the minimum time between two snapshots in milliseconds.
+     * @throws ToxSetAutosaveException if no file can be created next to the given path.
+     */
+    void setAutosave(@Nullable String path, int minInterval) throws ToxSetAutosaveException;
+
+    /**
+     * Set the format of the snapshots written by the background autosave facility. The default is
+     * {@link ToxSaveFormat#PLAIN}. Snapshots are compressed on the background thread, after unchanged ones have been
+     * skipped, and the smaller file is faster to write and sync.
+     *
+     * @param format the format of the save file.
+     */
+    void setAutosaveFormat(@NotNull ToxSaveFormat format);
+
+    /**
+     * Get the counters of the background autosave facility.
+     *
+     * @return the number of saves, skipped saves and failures, and the save latency.
+     */
+    @NotNull
+    ToxAutosaveStats getAutosaveStats();
+
+    /**
+     * Get the native memory held by this instance.
+     *
+     * @return the memory used by toxcore, file transfers, buffers, pending events and the instance itself.
+     */
+    @NotNull
+    ToxMemoryUsage getMemoryUsage();
+
+    /**
+     * Limit the payload of the events delivered by a single {@link #iteration}: messages, names, file names, file
+     * chunks and custom packets. No lossless event is ever dropped, so the limit is soft; chunks already in flight
+     * when a transfer is paused still arrive. Events still queued after a bounded {@link #iteration(int, int)} count
+     * against the budget of the next iteration.
+     *
+     * @param budget   the payload in bytes per iteration, or 0 for no limit (the default).
+     * @param overflow what to do once the budget is exceeded.
+     */
+    void setEventBudget(int budget, @NotNull ToxEventOverflow overflow);
+
+    /**
+     * Get the counters of the event budget.
+     *
+     * @return the largest payload of a single iteration, and how often the budget was exceeded.
+     */
+    @NotNull
+    ToxEventBudgetStats getEventBudgetStats();
+
     /**
      * Bootstrap into the tox network.
      * <p>
@@ -107,6 +175,43 @@ public interface ToxCore extends Closeable {
      */
     void iteration();
 
+    /**
+     * A bounded variant of {@link #iteration()} for dispatchers that serve several instances.
+     * <p>
+     * Delivers at most maxEvents events, and stops before the first event that would take the serialised batch over
+     * maxBytes, but always delivers at least one. Events beyond the limits stay queued in the native instance. The
+     * main loop still runs whenever {@link #iterationInterval()} has passed since it last ran, so the network is serviced
+     * during a long drain. The event budget counts the queued events, so with {@link #setEventBudget} the queue stays
+     * bounded: transfers paused for the budget are not resumed, and lossy packets are dropped, until the queue has been
+     * drained below the budget. Without a budget, the queue can grow as long as events arrive faster than they are
+     * drained.
+     *
+     * @param maxEvents the maximum number of events to deliver; must be positive.
+     * @param maxBytes  the maximum size of the serialised batch.
+     * @return true if events are still queued, in which case this should be called again without waiting for
+     * {@link #iterationInterval()}.
+     */
+    boolean iteration(int maxEvents, int maxBytes);
+
+    /**
+     * Set the upper bound for {@link #iterationInterval()}.
+     * <p>
+     * While file transfers are running, the interval is shortened. When the instance is idle, it grows exponentially
+     * up to this cap. The default is 1000 milliseconds.
+     *
+     * @param maxInterval the maximum interval in milliseconds, at least {@link ToxConstants#MIN_ITERATION_INTERVAL}.
+     * @throws IllegalArgumentException if maxInterval is smaller than that.
+     */
+    void setMaxIterationInterval(int maxInterval);
+
+    /**
+     * Get the number of times {@link #iteration()} was called during the last complete second. This is 0 once it has
+     * not been called for more than a second.
+     *
+     * @return the number of wake-ups per second.
+     */
+    int getIterationWakeups();
+
     /**
      * Gets our own public key.
      *
@@ -336,14 +441,56 @@ public interface ToxCore extends Closeable {
 
     int fileSend(int friendNumber, @NotNull ToxFileKind kind, long fileSize, @NotNull byte[] filename) throws ToxFileSendException;
 
-    void fileSendChunk(int friendNumber, int fileNumber, @NotNull byte[] data) throws ToxFileSendChunkException;
+    void fileSendChunk(int friendNumber, int fileNumber, long position, @NotNull byte[] data) throws ToxFileSendChunkException;
 
     void callbackFileRequestChunk(@Nullable FileRequestChunkCallback callback);
 
+    /**
+     * Send the contents of a local file.
+     * <p>
+     * This works like {@link #fileSend} with the size of the file at the given path, except that the native code reads
+     * the file and sends its data during {@link #iteration()}. No {@link FileRequestChunkCallback} events are generated
+     * for this transfer. Instead, the {@link FileProgressCallback} reports the number of bytes sent, at most once per
+     * iteration, and a final time with the file size when the friend has received the whole file. If the file can no
+     * longer be read, the transfer is cancelled and a {@link ToxFileControl#CANCEL} is passed to the
+     * {@link FileControlCallback}.
+     *
+     * @param friendNumber the friend number to send the file to.
+     * @param kind         the meaning of the file.
+     * @param path         the path of the local file to send.
+     * @param filename     the file name to send to the friend.
+     * @return the file number of the new transfer.
+     * @throws ToxFileSendFromPathException if the file could not be opened or the send request failed.
+     */
+    int fileSendFromPath(int friendNumber, @NotNull ToxFileKind kind, @NotNull String path, @NotNull byte[] filename) throws ToxFileSendFromPathException;
+
     void callbackFileReceive(@Nullable FileReceiveCallback callback);
 
     void callbackFileReceiveChunk(@Nullable FileReceiveChunkCallback callback);
 
+    /**
+     * Write the data of an incoming file transfer directly to a file instead of passing it to the
+     * {@link FileReceiveChunkCallback}.
+     * <p>
+     * The file is created if it does not exist, and space for the whole file is allocated up front. Received chunks
+     * are written at their position in the file, and only their progress is reported through the
+     * {@link FileProgressCallback}, at most once per iteration. When the reported position equals the file size, the
+     * file is complete and has been closed.
+     *
+     * @param friendNumber the friend number of the friend who is sending the file.
+     * @param fileNumber   the file number of the incoming transfer.
+     * @param path         the path of the destination file.
+     * @throws ToxFileSetSinkException if the transfer was not found or the file could not be opened.
+     */
+    void fileSetSink(int friendNumber, int fileNumber, @NotNull String path) throws ToxFileSetSinkException;
+
+    /**
+     * Set the callback for progress of file transfers whose data is handled natively.
+     *
+     * @param callback the callback.
+     */
+    void callbackFileProgress(@Nullable FileProgressCallback callback);
+
     void sendLossyPacket(int friendNumber, @NotNull byte[] data) throws ToxSendCustomPacketException;
 
     void callbackFriendLossyPacket(@Nullable FriendLossyPacketCallback callback);
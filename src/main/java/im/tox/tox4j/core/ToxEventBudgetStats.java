@@ -0,0 +1,48 @@
+package im.tox.tox4j.core;
+
+/**
+ * Counters for the event budget. The high watermark is kept while no budget is set, so it can be used to choose one.
+ */
+public final class ToxEventBudgetStats {
+
+    /**
+     * Most payload bytes delivered in the events of a single iteration.
+     */
+    private final long highWatermark;
+    /**
+     * Number of iterations that exceeded the budget.
+     */
+    private final long overflows;
+    /**
+     * Number of times an incoming file transfer was paused.
+     */
+    private final long paused;
+    /**
+     * Number of lossy packets dropped.
+     */
+    private final long dropped;
+
+    public ToxEventBudgetStats(long highWatermark, long overflows, long paused, long dropped) {
+        this.highWatermark = highWatermark;
+        this.overflows = overflows;
+        this.paused = paused;
+        this.dropped = dropped;
+    }
+
+    public long getHighWatermark() {
+        return highWatermark;
+    }
+
+    public long getOverflows() {
+        return overflows;
+    }
+
+    public long getPaused() {
+        return paused;
+    }
+
+    public long getDropped() {
+        return dropped;
+    }
+
+}
@@ -0,0 +1,69 @@
+package im.tox.tox4j.core;
+
+/**
+ * Native memory held by one Tox instance, in bytes. Toxcore has no allocation hooks, so its own share is only an
+ * estimate; see {@link #getCoreEstimate}. Everything else counts the capacity of the native buffers, not just the part
+ * in use. The overhead of native maps and queues is estimated from the layouts of the common C++ standard libraries.
+ */
+public final class ToxMemoryUsage {
+
+    /**
+     * Estimate of toxcore's own state: DHT, friends, onion paths and network buffers.
+     */
+    private final long coreEstimate;
+    /**
+     * Bookkeeping for file transfers, including queued chunk requests.
+     */
+    private final long transfers;
+    /**
+     * File chunk and savedata buffers, and the snapshots held by the autosave facility.
+     */
+    private final long buffers;
+    /**
+     * The event buffer, including events that were cleared and are kept for reuse.
+     */
+    private final long events;
+    /**
+     * The instance objects themselves and their slot in the instance table.
+     */
+    private final long instance;
+
+    public ToxMemoryUsage(long coreEstimate, long transfers, long buffers, long events, long instance) {
+        this.coreEstimate = coreEstimate;
+        this.transfers = transfers;
+        this.buffers = buffers;
+        this.events = events;
+        this.instance = instance;
+    }
+
+    /**
+     * The growth of the process heap while the instance was created, including the friends loaded from savedata but
+     * nothing allocated since. Allocations and frees by other threads at that time are counted too, so with concurrent
+     * activity, e.g. several instances being created at once, this value is unreliable. 0 if the C library does not
+     * report its heap usage.
+     */
+    public long getCoreEstimate() {
+        return coreEstimate;
+    }
+
+    public long getTransfers() {
+        return transfers;
+    }
+
+    public long getBuffers() {
+        return buffers;
+    }
+
+    public long getEvents() {
+        return events;
+    }
+
+    public long getInstance() {
+        return instance;
+    }
+
+    public long getTotal() {
+        return coreEstimate + transfers + buffers + events + instance;
+    }
+
+}
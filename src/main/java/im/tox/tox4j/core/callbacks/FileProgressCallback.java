@@ -0,0 +1,7 @@
+package im.tox.tox4j.core.callbacks;
+
+public interface FileProgressCallback {
+
+    void fileProgress(int friendNumber, int fileNumber, long position);
+
+}
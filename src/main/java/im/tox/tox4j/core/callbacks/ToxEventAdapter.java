@@ -9,6 +9,7 @@ import im.tox.tox4j.core.enums.ToxStatus;
 public class ToxEventAdapter implements ToxEventListener {
     @Override public void connectionStatus(@NotNull ToxConnection connectionStatus) { }
     @Override public void fileControl(int friendNumber, int fileNumber, @NotNull ToxFileControl control) { }
+    @Override public void fileProgress(int friendNumber, int fileNumber, long position) { }
     @Override public void fileReceive(int friendNumber, int fileNumber, @NotNull ToxFileKind kind, long fileSize, @NotNull byte[] filename) { }
     @Override public void fileReceiveChunk(int friendNumber, int fileNumber, long position, @NotNull byte[] data) { }
     @Override public void fileRequestChunk(int friendNumber, int fileNumber, long position, int length) { }
@@ -3,6 +3,7 @@ package im.tox.tox4j.core.callbacks;
 public interface ToxEventListener extends
         ConnectionStatusCallback,
         FileControlCallback,
+        FileProgressCallback,
         FileReceiveCallback,
         FileReceiveChunkCallback,
         FileRequestChunkCallback,
@@ -0,0 +1,14 @@
+package im.tox.tox4j.core.enums;
+
+public enum ToxEventOverflow {
+
+    /**
+     * Pause incoming file transfers until the events of the current iteration have been handled.
+     */
+    PAUSE_TRANSFERS,
+    /**
+     * Drop lossy custom packets until the events of the current iteration have been handled.
+     */
+    DROP_LOSSY,
+
+}
@@ -0,0 +1,15 @@
+package im.tox.tox4j.core.enums;
+
+public enum ToxSaveFormat {
+
+    /**
+     * The save data as toxcore writes it.
+     */
+    PLAIN,
+    /**
+     * The save data compressed with LZ4, in a container with a header, a format version and a checksum. Large friend
+     * lists compress well. Loading recognises this format.
+     */
+    LZ4,
+
+}
@@ -10,6 +10,7 @@ public final class ToxFileSendChunkException extends ToxException {
         FRIEND_NOT_FOUND,
         FRIEND_NOT_CONNECTED,
         NOT_FOUND,
+        WRONG_POSITION,
     }
 
     private final @NotNull Code code;
@@ -0,0 +1,30 @@
+package im.tox.tox4j.core.exceptions;
+
+import im.tox.tox4j.annotations.NotNull;
+import im.tox.tox4j.exceptions.ToxException;
+
+public final class ToxFileSendFromPathException extends ToxException {
+
+    public static enum Code {
+        NULL,
+        FRIEND_NOT_FOUND,
+        FRIEND_NOT_CONNECTED,
+        NAME_EMPTY,
+        NAME_TOO_LONG,
+        TOO_MANY,
+        IO,
+    }
+
+    private final @NotNull Code code;
+
+    public ToxFileSendFromPathException(@NotNull Code code) {
+        this.code = code;
+    }
+
+    @NotNull
+    @Override
+    public Code getCode() {
+        return code;
+    }
+
+}
@@ -0,0 +1,27 @@
+package im.tox.tox4j.core.exceptions;
+
+import im.tox.tox4j.annotations.NotNull;
+import im.tox.tox4j.exceptions.ToxException;
+
+public final class ToxFileSetSinkException extends ToxException {
+
+    public static enum Code {
+        NULL,
+        FRIEND_NOT_FOUND,
+        NOT_FOUND,
+        IO,
+    }
+
+    private final @NotNull Code code;
+
+    public ToxFileSetSinkException(@NotNull Code code) {
+        this.code = code;
+    }
+
+    @NotNull
+    @Override
+    public Code getCode() {
+        return code;
+    }
+
+}
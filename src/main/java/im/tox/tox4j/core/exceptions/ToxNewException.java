@@ -14,6 +14,7 @@ public final class ToxNewException extends ToxException {
         PROXY_NOT_FOUND,
         LOAD_ENCRYPTED,
         LOAD_BAD_FORMAT,
+        LOAD_IO,
     }
 
     private final @NotNull Code code;
@@ -0,0 +1,24 @@
+package im.tox.tox4j.core.exceptions;
+
+import im.tox.tox4j.annotations.NotNull;
+import im.tox.tox4j.exceptions.ToxException;
+
+public final class ToxSetAutosaveException extends ToxException {
+
+    public static enum Code {
+        IO,
+    }
+
+    private final @NotNull Code code;
+
+    public ToxSetAutosaveException(@NotNull Code code) {
+        this.code = code;
+    }
+
+    @NotNull
+    @Override
+    public Code getCode() {
+        return code;
+    }
+
+}
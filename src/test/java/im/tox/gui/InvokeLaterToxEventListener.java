@@ -50,6 +50,16 @@ public class InvokeLaterToxEventListener implements ToxEventListener {
         });
     }
 
+    @Override
+    public void fileProgress(final int friendNumber, final int fileNumber, final long position) {
+        SwingUtilities.invokeLater(new Runnable() {
+            @Override
+            public void run() {
+                underlying.fileProgress(friendNumber, fileNumber, position);
+            }
+        });
+    }
+
     @Override
     public void fileRequestChunk(final int friendNumber, final int fileNumber, final long position, final int length) {
         SwingUtilities.invokeLater(new Runnable() {
@@ -65,6 +65,8 @@ public class ToxGui extends JFrame {
 
     private ToxCore tox;
     private Thread eventLoop;
+    // Size of the latest incoming file, for the progress bar's percentage.
+    private long fileProgressSize;
 
     private DefaultListModel<String> messageModel = new DefaultListModel<>();
     private FriendList friendListModel = new FriendList();
@@ -131,9 +133,19 @@ public class ToxGui extends JFrame {
             }
         }
 
+        @Override
+        public void fileProgress(int friendNumber, int fileNumber, long position) {
+            addMessage("fileProgress", friendNumber, fileNumber, position);
+            if (fileProgressSize > 0) {
+                fileProgress.setValue((int) (position * 100 / fileProgressSize));
+            }
+        }
+
         @Override
         public void fileReceive(int friendNumber, int fileNumber, @NotNull ToxFileKind kind, long fileSize, @NotNull byte[] filename) {
             addMessage("fileReceive", friendNumber, fileNumber, kind, fileSize, new String(filename));
+            fileProgressSize = fileSize;
+            fileProgress.setValue(0);
             try {
                 if (JOptionPane.showConfirmDialog(ToxGui.this, "Incoming file transfer: " + new String(filename)) == JOptionPane.OK_OPTION) {
                     JFileChooser chooser = new JFileChooser();
@@ -167,7 +179,7 @@ public class ToxGui extends JFrame {
                 if (length == 0) {
                     fileModel.remove(friendNumber, fileNumber);
                 } else {
-                    tox.fileSendChunk(friendNumber, fileNumber, fileModel.get(friendNumber, fileNumber).read(position, length));
+                    tox.fileSendChunk(friendNumber, fileNumber, position, fileModel.get(friendNumber, fileNumber).read(position, length));
                 }
             } catch (Throwable e) {
                 JOptionPane.showMessageDialog(ToxGui.this, printExn(e));
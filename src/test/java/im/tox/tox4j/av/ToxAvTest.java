@@ -2,13 +2,19 @@ package im.tox.tox4j.av;
 
 import im.tox.tox4j.*;
 import im.tox.tox4j.annotations.NotNull;
+import im.tox.tox4j.av.enums.ToxVideoFormat;
+import im.tox.tox4j.av.exceptions.ToxMixerException;
+import im.tox.tox4j.av.exceptions.ToxSendFrameException;
+import im.tox.tox4j.av.exceptions.ToxCallStatsException;
 import im.tox.tox4j.core.ToxCore;
 import im.tox.tox4j.core.ToxOptions;
 import im.tox.tox4j.core.exceptions.ToxNewException;
 import org.junit.Test;
 
+import static org.junit.Assert.assertEquals;
 import static org.junit.Assert.assertNotEquals;
 import static org.junit.Assert.assertTrue;
+import static org.junit.Assert.fail;
 
 public class ToxAvTest extends ToxAvImplTestBase {
 
@@ -33,4 +39,124 @@ public class ToxAvTest extends ToxAvImplTestBase {
         }
     }
 
-}
\ No newline at end of file
+    @Test
+    public void testCallStatsNotInCall() throws Exception {
+        try (ToxCore tox = newTox()) {
+            addFriends(tox, 1);
+            try (ToxAv av = newToxAv(tox)) {
+                av.getCallStats(0);
+                fail();
+            } catch (ToxCallStatsException e) {
+                assertEquals(ToxCallStatsException.Code.FRIEND_NOT_IN_CALL, e.getCode());
+            }
+        }
+    }
+
+    @Test
+    public void testMixerFriendNotFound() throws Exception {
+        try (ToxAv av = newToxAv()) {
+            av.mixerAddFriend(0);
+            fail();
+        } catch (ToxMixerException e) {
+            assertEquals(ToxMixerException.Code.FRIEND_NOT_FOUND, e.getCode());
+        }
+    }
+
+    @Test
+    public void testMixerAddTwice() throws Exception {
+        try (ToxCore tox = newTox()) {
+            addFriends(tox, 1);
+            try (ToxAv av = newToxAv(tox)) {
+                av.mixerAddFriend(0);
+                try {
+                    av.mixerAddFriend(0);
+                    fail();
+                } catch (ToxMixerException e) {
+                    assertEquals(ToxMixerException.Code.ALREADY_MIXED, e.getCode());
+                }
+                av.mixerRemoveFriend(0);
+            }
+        }
+    }
+
+    @Test
+    public void testMixerRemoveNotMixed() throws Exception {
+        try (ToxAv av = newToxAv()) {
+            av.mixerRemoveFriend(0);
+            fail();
+        } catch (ToxMixerException e) {
+            assertEquals(ToxMixerException.Code.NOT_MIXED, e.getCode());
+        }
+    }
+
+    @Test
+    public void testSendVideoFrameBadLength() throws Exception {
+        try (ToxAv av = newToxAv()) {
+            av.sendVideoFrame(0, 640, 480, ToxVideoFormat.NV21, new byte[640 * 480]);
+            fail();
+        } catch (ToxSendFrameException e) {
+            assertEquals(ToxSendFrameException.Code.BAD_LENGTH, e.getCode());
+        }
+    }
+
+    @Test
+    public void testSendVideoFrameOddSize() throws Exception {
+        try (ToxAv av = newToxAv()) {
+            av.sendVideoFrame(0, 3, 2, ToxVideoFormat.RGBA, new byte[3 * 2 * 4]);
+            fail();
+        } catch (ToxSendFrameException e) {
+            assertEquals(ToxSendFrameException.Code.INVALID, e.getCode());
+        }
+    }
+
+    @Test
+    public void testSendVideoFrameNegativeSize() throws Exception {
+        try (ToxAv av = newToxAv()) {
+            av.sendVideoFrame(0, -2, -2, ToxVideoFormat.RGBA, new byte[16]);
+            fail();
+        } catch (ToxSendFrameException e) {
+            assertEquals(ToxSendFrameException.Code.INVALID, e.getCode());
+        }
+    }
+
+    @Test
+    public void testSendVideoFrameOversized() throws Exception {
+        try (ToxAv av = newToxAv()) {
+            // 65536 * 32768 * 4 overflows an int to 0.
+            av.sendVideoFrame(0, 65536, 32768, ToxVideoFormat.RGBA, new byte[0]);
+            fail();
+        } catch (ToxSendFrameException e) {
+            assertEquals(ToxSendFrameException.Code.INVALID, e.getCode());
+        }
+    }
+
+    @Test
+    public void testSendPlanarVideoFrameNegativeSize() throws Exception {
+        try (ToxAv av = newToxAv()) {
+            byte[] plane = new byte[4];
+            av.sendVideoFrame(0, -2, -2, plane, plane, plane, null);
+            fail();
+        } catch (ToxSendFrameException e) {
+            assertEquals(ToxSendFrameException.Code.INVALID, e.getCode());
+        }
+    }
+
+    @Test
+    public void testSendVideoFrameNotInCall() throws Exception {
+        for (ToxVideoFormat format : ToxVideoFormat.values()) {
+            try (ToxCore tox = newTox()) {
+                addFriends(tox, 1);
+                try (ToxAv av = newToxAv(tox)) {
+                    int length = format == ToxVideoFormat.RGBA || format == ToxVideoFormat.BGRA
+                            ? 640 * 480 * 4
+                            : 640 * 480 * 3 / 2;
+                    av.sendVideoFrame(0, 640, 480, format, new byte[length]);
+                    fail();
+                } catch (ToxSendFrameException e) {
+                    assertEquals(ToxSendFrameException.Code.FRIEND_NOT_IN_CALL, e.getCode());
+                }
+            }
+        }
+    }
+
+}
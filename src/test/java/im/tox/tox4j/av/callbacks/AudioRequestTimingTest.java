@@ -0,0 +1,106 @@
+package im.tox.tox4j.av.callbacks;
+
+import im.tox.tox4j.annotations.NotNull;
+import im.tox.tox4j.av.AliceBobAvTest;
+import im.tox.tox4j.av.ToxAv;
+import im.tox.tox4j.av.ToxRequestStats;
+import im.tox.tox4j.core.enums.ToxConnection;
+import im.tox.tox4j.exceptions.ToxException;
+
+import java.util.Arrays;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertTrue;
+
+/**
+ * Audio frames are requested at the audio frame duration of the call, no matter how often the client iterates. Alice
+ * counts the requests she gets over a number of frame durations and reports the lateness histogram.
+ */
+public final class AudioRequestTimingTest extends AliceBobAvTest {
+
+    private static final int AUDIO_BIT_RATE = 64;
+    // Frame duration of every call made by the native layer.
+    private static final int FRAME_DURATION = 60;
+
+    private static final int REQUESTS = 30;
+
+
+    @NotNull
+    @Override
+    protected ChatClient newAlice() throws Exception {
+        return new Alice();
+    }
+
+    private static class Alice extends AvClient {
+
+        private int requests = 0;
+        private long start;
+
+        @Override
+        public void friendConnectionStatus(final int friendNumber, @NotNull ToxConnection connection) {
+            assertEquals(FRIEND_NUMBER, friendNumber);
+            if (connection != ToxConnection.NONE) {
+                debug("is now connected to friend " + friendNumber);
+                addTask(new Task() {
+                    @Override
+                    public void perform(@NotNull ToxAv av) throws ToxException {
+                        debug("calling " + getFriendName());
+                        av.call(friendNumber, AUDIO_BIT_RATE, 0);
+                    }
+                });
+            }
+        }
+
+        @Override
+        public void requestAudioFrame(final int friendNumber) {
+            assertEquals(FRIEND_NUMBER, friendNumber);
+            if (requests == 0) {
+                start = System.nanoTime();
+            }
+            requests++;
+            if (requests == REQUESTS) {
+                final long elapsed = (System.nanoTime() - start) / 1000000;
+                addTask(new Task() {
+                    @Override
+                    public void perform(@NotNull ToxAv av) throws ToxException {
+                        ToxRequestStats stats = av.getCallStats(friendNumber).getRequests();
+                        debug("got " + REQUESTS + " requests in " + elapsed + "ms, "
+                                + stats.getSkippedDeadlines() + " deadlines skipped, "
+                                + "lateness histogram " + Arrays.toString(stats.getLateness()));
+                        // The first request is issued right away; every further one waits for its deadline.
+                        assertTrue(elapsed >= (REQUESTS - 1) * FRAME_DURATION * 9 / 10);
+                        assertTrue(stats.getAudioRequests() >= REQUESTS);
+                        finish();
+                    }
+                });
+            }
+        }
+
+    }
+
+
+    @NotNull
+    @Override
+    protected ChatClient newBob() throws Exception {
+        return new Bob();
+    }
+
+    private static class Bob extends AvClient {
+
+        @Override
+        public void call(final int friendNumber, boolean audioEnabled, boolean videoEnabled) {
+            assertEquals(FRIEND_NUMBER, friendNumber);
+            debug("received call from " + getFriendName());
+            addTask(new Task() {
+                @Override
+                public void perform(@NotNull ToxAv av) throws ToxException {
+                    debug("answering call");
+                    av.answer(friendNumber, AUDIO_BIT_RATE, 0);
+                    finish();
+                }
+            });
+        }
+
+    }
+
+}
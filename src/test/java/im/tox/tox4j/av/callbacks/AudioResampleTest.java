@@ -0,0 +1,173 @@
+package im.tox.tox4j.av.callbacks;
+
+import im.tox.tox4j.annotations.NotNull;
+import im.tox.tox4j.av.AliceBobAvTest;
+import im.tox.tox4j.av.ToxAv;
+import im.tox.tox4j.core.enums.ToxConnection;
+import im.tox.tox4j.exceptions.ToxException;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertTrue;
+
+/**
+ * Alice captures 48 kHz stereo in 10 ms frames and sends it into an 8 kHz mono call, leaving the conversion to the
+ * native resampler. The left channel carries a 1 kHz tone, which must arrive intact; the right channel carries a 5 kHz
+ * tone, which is above the call's Nyquist frequency and must be filtered out rather than aliased down to 3 kHz.
+ * Alice also reports how long each conversion and send took.
+ */
+public final class AudioResampleTest extends AliceBobAvTest {
+
+    private static final int AUDIO_BIT_RATE = 64;
+
+    private static final int INPUT_RATE     = 48000;
+    private static final int INPUT_CHANNELS = 2;
+    private static final int INPUT_FRAME    = INPUT_RATE / 100;
+
+    private static final int CALL_RATE      = 8000;
+    private static final int CALL_FRAME     = 480;
+
+    private static final int SIGNAL_FREQUENCY = 1000;
+    private static final int NOISE_FREQUENCY  = 5000;
+    private static final int ALIAS_FREQUENCY  = CALL_RATE - NOISE_FREQUENCY;
+
+    // Alice sends three seconds of audio. Bob analyses the second one, after the codec has settled, leaving a second
+    // for the filter delay and partial frames.
+    private static final int INPUT_FRAMES  = 300;
+    private static final int SKIP_SAMPLES  = CALL_RATE;
+    private static final int TOTAL_SAMPLES = CALL_RATE * 2;
+
+
+    private static short tone(int frequency, int t, int rate) {
+        return (short) (8000 * Math.sin(2 * Math.PI * frequency * t / rate));
+    }
+
+    /**
+     * Power of one frequency in a signal, using the Goertzel algorithm.
+     */
+    private static double power(short[] samples, int length, int frequency, int rate) {
+        double coefficient = 2 * Math.cos(2 * Math.PI * frequency / rate);
+        double s1 = 0;
+        double s2 = 0;
+        for (int i = 0; i < length; i++) {
+            double s0 = samples[i] + coefficient * s1 - s2;
+            s2 = s1;
+            s1 = s0;
+        }
+        return s1 * s1 + s2 * s2 - coefficient * s1 * s2;
+    }
+
+
+    @NotNull
+    @Override
+    protected ChatClient newAlice() throws Exception {
+        return new Alice();
+    }
+
+    private static class Alice extends AvClient {
+
+        private final short[] frame = new short[INPUT_FRAME * INPUT_CHANNELS];
+        private int frames = 0;
+        private int t = 0;
+        private long sendTime = 0;
+
+        @Override
+        public void friendConnectionStatus(final int friendNumber, @NotNull ToxConnection connection) {
+            assertEquals(FRIEND_NUMBER, friendNumber);
+            if (connection != ToxConnection.NONE) {
+                debug("is now connected to friend " + friendNumber);
+                addTask(new Task() {
+                    @Override
+                    public void perform(@NotNull ToxAv av) throws ToxException {
+                        debug("calling " + getFriendName());
+                        av.call(friendNumber, AUDIO_BIT_RATE, 0);
+                    }
+                });
+            }
+        }
+
+        @Override
+        public void requestAudioFrame(final int friendNumber) {
+            assertEquals(FRIEND_NUMBER, friendNumber);
+            if (frames == INPUT_FRAMES) {
+                return;
+            }
+            addTask(new Task() {
+                @Override
+                public void perform(@NotNull ToxAv av) throws ToxException {
+                    for (int i = 0; i < INPUT_FRAME; i++, t++) {
+                        frame[i * 2] = tone(SIGNAL_FREQUENCY, t, INPUT_RATE);
+                        frame[i * 2 + 1] = tone(NOISE_FREQUENCY, t, INPUT_RATE);
+                    }
+
+                    long start = System.nanoTime();
+                    av.sendAudioFrame(friendNumber, frame, INPUT_FRAME, INPUT_CHANNELS, INPUT_RATE);
+                    sendTime += System.nanoTime() - start;
+
+                    frames++;
+                    if (frames == INPUT_FRAMES) {
+                        debug(String.format("sent %d frames of %d Hz stereo, %.1f us per frame",
+                                frames, INPUT_RATE, sendTime / 1000d / frames));
+                        finish();
+                    }
+                }
+            });
+        }
+
+    }
+
+
+    @NotNull
+    @Override
+    protected ChatClient newBob() throws Exception {
+        return new Bob();
+    }
+
+    private static class Bob extends AvClient {
+
+        private final short[] received = new short[TOTAL_SAMPLES];
+        private int t = 0;
+
+        @Override
+        public void call(final int friendNumber, boolean audioEnabled, boolean videoEnabled) {
+            assertEquals(FRIEND_NUMBER, friendNumber);
+            debug("received call from " + getFriendName());
+            addTask(new Task() {
+                @Override
+                public void perform(@NotNull ToxAv av) throws ToxException {
+                    debug("answering call");
+                    av.answer(friendNumber, AUDIO_BIT_RATE, 0);
+                }
+            });
+        }
+
+        @Override
+        public void receiveAudioFrame(int friendNumber, @NotNull short[] pcm, int channels, int samplingRate) {
+            assertEquals(FRIEND_NUMBER, friendNumber);
+            assertEquals(1, channels);
+            assertEquals(CALL_RATE, samplingRate);
+            assertEquals(CALL_FRAME, pcm.length);
+
+            if (t == TOTAL_SAMPLES) {
+                return;
+            }
+            int length = Math.min(pcm.length, TOTAL_SAMPLES - t);
+            System.arraycopy(pcm, 0, received, t, length);
+            t += length;
+
+            if (t == TOTAL_SAMPLES) {
+                short[] settled = new short[TOTAL_SAMPLES - SKIP_SAMPLES];
+                System.arraycopy(received, SKIP_SAMPLES, settled, 0, settled.length);
+
+                double signal = power(settled, settled.length, SIGNAL_FREQUENCY, CALL_RATE);
+                double alias = power(settled, settled.length, ALIAS_FREQUENCY, CALL_RATE);
+                double rejection = 10 * Math.log10(signal / Math.max(alias, 1));
+                debug(String.format("%d Hz alias is %.1f dB below the %d Hz signal",
+                        ALIAS_FREQUENCY, rejection, SIGNAL_FREQUENCY));
+                assertTrue("aliasing rejection too low: " + rejection + " dB", rejection > 30);
+                finish();
+            }
+        }
+
+    }
+
+}
@@ -0,0 +1,123 @@
+package im.tox.tox4j.av.callbacks;
+
+import im.tox.tox4j.annotations.NotNull;
+import im.tox.tox4j.av.AliceBobAvTest;
+import im.tox.tox4j.av.ToxAv;
+import im.tox.tox4j.core.enums.ToxConnection;
+import im.tox.tox4j.exceptions.ToxException;
+
+import java.lang.management.ManagementFactory;
+
+import static org.junit.Assert.assertEquals;
+
+/**
+ * Streams audio from Alice to Bob and counts the Java heap bytes allocated on the sending thread by each call to
+ * {@link ToxAv#sendAudioFrame}. After warm-up, neither the Java wrapper nor the JNI entry point may allocate Java
+ * objects per frame.
+ * <p>
+ * The JVM's per-thread counter only sees the Java heap. Native allocations, such as a scratch buffer in the native
+ * send path or a copy made by GetShortArrayElements, are invisible to it, so this test does not cover them.
+ */
+public final class AudioSendJavaAllocationTest extends AliceBobAvTest {
+
+    private static final int SAMPLING_RATE  = 8000;
+    private static final int AUDIO_BIT_RATE = 64;
+    private static final int CHANNELS       = 1;
+    private static final int FRAME_SIZE     = 480;
+
+    private static final int WARMUP_FRAMES = 10;
+    private static final int FRAMES        = 100;
+
+
+    private static final com.sun.management.ThreadMXBean threads =
+            (com.sun.management.ThreadMXBean) ManagementFactory.getThreadMXBean();
+
+    private static long allocatedBytes() {
+        return threads.getThreadAllocatedBytes(Thread.currentThread().getId());
+    }
+
+
+    @NotNull
+    @Override
+    protected ChatClient newAlice() throws Exception {
+        return new Alice();
+    }
+
+    private static class Alice extends AvClient {
+
+        private final short[] frame = new short[FRAME_SIZE];
+        private int frames = 0;
+        private long allocated = 0;
+
+        @Override
+        public void friendConnectionStatus(final int friendNumber, @NotNull ToxConnection connection) {
+            assertEquals(FRIEND_NUMBER, friendNumber);
+            if (connection != ToxConnection.NONE) {
+                debug("is now connected to friend " + friendNumber);
+                addTask(new Task() {
+                    @Override
+                    public void perform(@NotNull ToxAv av) throws ToxException {
+                        debug("calling " + getFriendName());
+                        av.call(friendNumber, AUDIO_BIT_RATE, 0);
+                    }
+                });
+            }
+        }
+
+        @Override
+        public void requestAudioFrame(final int friendNumber) {
+            assertEquals(FRIEND_NUMBER, friendNumber);
+            addTask(new Task() {
+                @Override
+                public void perform(@NotNull ToxAv av) throws ToxException {
+                    for (int i = 0; i < frame.length; i++) {
+                        frame[i] = (short) ((frames * FRAME_SIZE + i) << 6);
+                    }
+
+                    // Measuring itself may allocate, so subtract the cost of an empty measurement.
+                    long overhead = -allocatedBytes() + allocatedBytes();
+                    long before = allocatedBytes();
+                    av.sendAudioFrame(friendNumber, frame, FRAME_SIZE, CHANNELS, SAMPLING_RATE);
+                    long after = allocatedBytes();
+
+                    frames++;
+                    if (frames > WARMUP_FRAMES) {
+                        allocated += Math.max(0, after - before - overhead);
+                    }
+                    if (frames == FRAMES) {
+                        debug("sent " + (FRAMES - WARMUP_FRAMES) + " frames, allocating " + allocated + " bytes");
+                        assertEquals(0, allocated);
+                        finish();
+                    }
+                }
+            });
+        }
+
+    }
+
+
+    @NotNull
+    @Override
+    protected ChatClient newBob() throws Exception {
+        return new Bob();
+    }
+
+    private static class Bob extends AvClient {
+
+        @Override
+        public void call(final int friendNumber, boolean audioEnabled, boolean videoEnabled) {
+            assertEquals(FRIEND_NUMBER, friendNumber);
+            debug("received call from " + getFriendName());
+            addTask(new Task() {
+                @Override
+                public void perform(@NotNull ToxAv av) throws ToxException {
+                    debug("answering call");
+                    av.answer(friendNumber, AUDIO_BIT_RATE, 0);
+                    finish();
+                }
+            });
+        }
+
+    }
+
+}
@@ -0,0 +1,125 @@
+package im.tox.tox4j.av.callbacks;
+
+import im.tox.tox4j.annotations.NotNull;
+import im.tox.tox4j.av.AliceBobAvTest;
+import im.tox.tox4j.av.ToxAv;
+import im.tox.tox4j.av.ToxStreamStats;
+import im.tox.tox4j.core.enums.ToxConnection;
+import im.tox.tox4j.exceptions.ToxException;
+
+import java.util.Arrays;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertTrue;
+
+/**
+ * Alice answers every audio frame request, Bob counts what arrives. Both then check the native call statistics
+ * against what they saw.
+ */
+public final class CallStatsTest extends AliceBobAvTest {
+
+    private static final int AUDIO_BIT_RATE = 64;
+    private static final int SAMPLING_RATE  = 8000;
+    private static final int FRAME_SIZE     = 480;
+
+    private static final int FRAMES = 50;
+
+
+    @NotNull
+    @Override
+    protected ChatClient newAlice() throws Exception {
+        return new Alice();
+    }
+
+    private static class Alice extends AvClient {
+
+        private final short[] frame = new short[FRAME_SIZE];
+        private int frames = 0;
+
+        @Override
+        public void friendConnectionStatus(final int friendNumber, @NotNull ToxConnection connection) {
+            assertEquals(FRIEND_NUMBER, friendNumber);
+            if (connection != ToxConnection.NONE) {
+                debug("is now connected to friend " + friendNumber);
+                addTask(new Task() {
+                    @Override
+                    public void perform(@NotNull ToxAv av) throws ToxException {
+                        debug("calling " + getFriendName());
+                        av.call(friendNumber, AUDIO_BIT_RATE, 0);
+                    }
+                });
+            }
+        }
+
+        @Override
+        public void requestAudioFrame(final int friendNumber) {
+            assertEquals(FRIEND_NUMBER, friendNumber);
+            addTask(new Task() {
+                @Override
+                public void perform(@NotNull ToxAv av) throws ToxException {
+                    for (int i = 0; i < frame.length; i++) {
+                        frame[i] = (short) (4000 * Math.sin(2 * Math.PI * 440 * (frames * FRAME_SIZE + i) / SAMPLING_RATE));
+                    }
+                    av.sendAudioFrame(friendNumber, frame, FRAME_SIZE, 1, SAMPLING_RATE);
+                    frames++;
+                    if (frames == FRAMES) {
+                        ToxStreamStats stats = av.getCallStats(friendNumber).getAudio();
+                        debug("sent " + stats.getFramesSent() + " frames at " + stats.getBitRate() + "/"
+                                + stats.getConfiguredBitRate() + " kbit/s, " + stats.getEncodeTimeAverage()
+                                + "us average encode time, send latency " + Arrays.toString(stats.getSendLatency()));
+                        assertEquals(FRAMES, stats.getFramesSent());
+                        assertTrue(stats.getFramesRequested() >= FRAMES);
+                        assertEquals(AUDIO_BIT_RATE, stats.getConfiguredBitRate());
+                        assertEquals(0, av.getCallStats(friendNumber).getVideo().getFramesSent());
+                        finish();
+                    }
+                }
+            });
+        }
+
+    }
+
+
+    @NotNull
+    @Override
+    protected ChatClient newBob() throws Exception {
+        return new Bob();
+    }
+
+    private static class Bob extends AvClient {
+
+        private int frames = 0;
+
+        @Override
+        public void call(final int friendNumber, boolean audioEnabled, boolean videoEnabled) {
+            assertEquals(FRIEND_NUMBER, friendNumber);
+            debug("received call from " + getFriendName());
+            addTask(new Task() {
+                @Override
+                public void perform(@NotNull ToxAv av) throws ToxException {
+                    debug("answering call");
+                    av.answer(friendNumber, AUDIO_BIT_RATE, 0);
+                }
+            });
+        }
+
+        @Override
+        public void receiveAudioFrame(final int friendNumber, @NotNull short[] pcm, int channels, int samplingRate) {
+            assertEquals(FRIEND_NUMBER, friendNumber);
+            frames++;
+            if (frames == FRAMES / 2) {
+                addTask(new Task() {
+                    @Override
+                    public void perform(@NotNull ToxAv av) throws ToxException {
+                        ToxStreamStats stats = av.getCallStats(friendNumber).getAudio();
+                        debug("received " + stats.getFramesReceived() + " frames, jitter " + stats.getJitter() + "us");
+                        assertTrue(stats.getFramesReceived() >= FRAMES / 2);
+                        finish();
+                    }
+                });
+            }
+        }
+
+    }
+
+}
@@ -0,0 +1,121 @@
+package im.tox.tox4j.av.callbacks;
+
+import im.tox.tox4j.annotations.NotNull;
+import im.tox.tox4j.av.AliceBobAvTest;
+import im.tox.tox4j.av.ToxAv;
+import im.tox.tox4j.core.enums.ToxConnection;
+import im.tox.tox4j.exceptions.ToxException;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertTrue;
+import static org.junit.Assert.fail;
+
+/**
+ * Alice runs a conference bridge with Bob as its only participant. Bob's audio must stay in Alice's native mixer, so
+ * Alice's client never sees audio events for Bob. The mix Bob gets back is everyone but himself, which is silence.
+ */
+public final class MixerTest extends AliceBobAvTest {
+
+    private static final int AUDIO_BIT_RATE = 64;
+    private static final int SAMPLING_RATE  = 8000;
+    private static final int FRAME_SIZE     = 480;
+
+    private static final int FRAMES = 20;
+
+    // Opus may not decode silence to exact zeros.
+    private static final int SILENCE = 100;
+
+
+    @NotNull
+    @Override
+    protected ChatClient newAlice() throws Exception {
+        return new Alice();
+    }
+
+    private static class Alice extends AvClient {
+
+        @Override
+        public void friendConnectionStatus(final int friendNumber, @NotNull ToxConnection connection) {
+            assertEquals(FRIEND_NUMBER, friendNumber);
+            if (connection != ToxConnection.NONE) {
+                debug("is now connected to friend " + friendNumber);
+                addTask(new Task() {
+                    @Override
+                    public void perform(@NotNull ToxAv av) throws ToxException {
+                        av.mixerAddFriend(friendNumber);
+                        debug("calling " + getFriendName());
+                        av.call(friendNumber, AUDIO_BIT_RATE, 0);
+                        finish();
+                    }
+                });
+            }
+        }
+
+        @Override
+        public void requestAudioFrame(int friendNumber) {
+            fail("audio frame requested for a conference participant");
+        }
+
+        @Override
+        public void receiveAudioFrame(int friendNumber, @NotNull short[] pcm, int channels, int samplingRate) {
+            fail("audio from a conference participant was passed to the client");
+        }
+
+    }
+
+
+    @NotNull
+    @Override
+    protected ChatClient newBob() throws Exception {
+        return new Bob();
+    }
+
+    private static class Bob extends AvClient {
+
+        private final short[] frame = new short[FRAME_SIZE];
+        private int t = 0;
+        private int frames = 0;
+
+        @Override
+        public void call(final int friendNumber, boolean audioEnabled, boolean videoEnabled) {
+            assertEquals(FRIEND_NUMBER, friendNumber);
+            debug("received call from " + getFriendName());
+            addTask(new Task() {
+                @Override
+                public void perform(@NotNull ToxAv av) throws ToxException {
+                    debug("answering call");
+                    av.answer(friendNumber, AUDIO_BIT_RATE, 0);
+                }
+            });
+        }
+
+        @Override
+        public void requestAudioFrame(final int friendNumber) {
+            addTask(new Task() {
+                @Override
+                public void perform(@NotNull ToxAv av) throws ToxException {
+                    for (int i = 0; i < frame.length; i++, t++) {
+                        frame[i] = (short) (8000 * Math.sin(2 * Math.PI * 440 * t / SAMPLING_RATE));
+                    }
+                    av.sendAudioFrame(friendNumber, frame, FRAME_SIZE, 1, SAMPLING_RATE);
+                }
+            });
+        }
+
+        @Override
+        public void receiveAudioFrame(int friendNumber, @NotNull short[] pcm, int channels, int samplingRate) {
+            assertEquals(FRIEND_NUMBER, friendNumber);
+            assertEquals(FRAME_SIZE, pcm.length);
+            for (short sample : pcm) {
+                assertTrue("Bob heard himself: " + sample, Math.abs(sample) < SILENCE);
+            }
+            frames++;
+            if (frames == FRAMES) {
+                debug("received " + frames + " silent mixes");
+                finish();
+            }
+        }
+
+    }
+
+}
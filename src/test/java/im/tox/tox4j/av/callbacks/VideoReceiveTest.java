@@ -0,0 +1,137 @@
+package im.tox.tox4j.av.callbacks;
+
+import im.tox.tox4j.annotations.NotNull;
+import im.tox.tox4j.annotations.Nullable;
+import im.tox.tox4j.av.AliceBobAvTest;
+import im.tox.tox4j.av.ToxAv;
+import im.tox.tox4j.av.ToxVideoReceiveStats;
+import im.tox.tox4j.av.enums.ToxVideoFormat;
+import im.tox.tox4j.core.enums.ToxConnection;
+import im.tox.tox4j.exceptions.ToxException;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertNull;
+import static org.junit.Assert.assertTrue;
+
+/**
+ * Bob streams 640x480 video to Alice, who checks that every frame arrives as tightly packed I420 and reports the
+ * frame rate. The native receive path packs the decoder's padded rows into a per-call buffer, which must only be
+ * allocated once for a constant resolution.
+ */
+public final class VideoReceiveTest extends AliceBobAvTest {
+
+    private static final int AUDIO_BIT_RATE = 64;
+    private static final int VIDEO_BIT_RATE = 500;
+    private static final int WIDTH          = 640;
+    private static final int HEIGHT         = 480;
+
+    private static final int FRAMES = 100;
+
+
+    @NotNull
+    @Override
+    protected ChatClient newAlice() throws Exception {
+        return new Alice();
+    }
+
+    private static class Alice extends AvClient {
+
+        private int frames = 0;
+        private long start;
+
+        @Override
+        public void friendConnectionStatus(final int friendNumber, @NotNull ToxConnection connection) {
+            assertEquals(FRIEND_NUMBER, friendNumber);
+            if (connection != ToxConnection.NONE) {
+                debug("is now connected to friend " + friendNumber);
+                addTask(new Task() {
+                    @Override
+                    public void perform(@NotNull ToxAv av) throws ToxException {
+                        debug("calling " + getFriendName());
+                        av.call(friendNumber, AUDIO_BIT_RATE, VIDEO_BIT_RATE);
+                    }
+                });
+            }
+        }
+
+        @Override
+        public void receiveVideoFrame(final int friendNumber, int width, int height,
+                                      @NotNull byte[] y, @NotNull byte[] u, @NotNull byte[] v, @Nullable byte[] a) {
+            assertEquals(FRIEND_NUMBER, friendNumber);
+            assertEquals(WIDTH, width);
+            assertEquals(HEIGHT, height);
+            assertEquals(WIDTH * HEIGHT, y.length);
+            assertEquals(WIDTH / 2 * HEIGHT / 2, u.length);
+            assertEquals(WIDTH / 2 * HEIGHT / 2, v.length);
+            assertNull(a);
+
+            if (frames == 0) {
+                start = System.nanoTime();
+            }
+            frames++;
+            if (frames == FRAMES) {
+                final double seconds = (System.nanoTime() - start) / 1e9;
+                addTask(new Task() {
+                    @Override
+                    public void perform(@NotNull ToxAv av) throws ToxException {
+                        ToxVideoReceiveStats stats = av.getCallStats(friendNumber).getVideoReceive();
+                        debug("received " + FRAMES + " frames at " + (FRAMES - 1) / seconds + " fps, "
+                                + stats.getBufferAllocations() + " buffer allocations, "
+                                + stats.getMaxCopyTime() + "us max copy time");
+                        assertTrue(stats.getFrames() >= FRAMES);
+                        assertTrue(stats.getBufferAllocations() <= 1);
+                        finish();
+                    }
+                });
+            }
+        }
+
+    }
+
+
+    @NotNull
+    @Override
+    protected ChatClient newBob() throws Exception {
+        return new Bob();
+    }
+
+    private static class Bob extends AvClient {
+
+        private final byte[] frame = new byte[WIDTH * HEIGHT * 3 / 2];
+        private int t = 0;
+
+        @Override
+        public void call(final int friendNumber, boolean audioEnabled, boolean videoEnabled) {
+            assertEquals(FRIEND_NUMBER, friendNumber);
+            assertTrue(videoEnabled);
+            debug("received call from " + getFriendName());
+            addTask(new Task() {
+                @Override
+                public void perform(@NotNull ToxAv av) throws ToxException {
+                    debug("answering call");
+                    av.answer(friendNumber, AUDIO_BIT_RATE, VIDEO_BIT_RATE);
+                    finish();
+                }
+            });
+        }
+
+        @Override
+        public void requestVideoFrame(final int friendNumber) {
+            addTask(new Task() {
+                @Override
+                public void perform(@NotNull ToxAv av) throws ToxException {
+                    // A moving gradient, so that the encoder has something to do.
+                    for (int row = 0; row < HEIGHT; row++) {
+                        for (int col = 0; col < WIDTH; col++) {
+                            frame[row * WIDTH + col] = (byte) (row + col + t);
+                        }
+                    }
+                    t++;
+                    av.sendVideoFrame(friendNumber, WIDTH, HEIGHT, ToxVideoFormat.NV12, frame);
+                }
+            });
+        }
+
+    }
+
+}
@@ -0,0 +1,84 @@
+package im.tox.tox4j.core;
+
+import im.tox.tox4j.ToxCoreImplTestBase;
+import org.junit.Test;
+
+import java.io.File;
+import java.nio.file.Files;
+
+import static org.junit.Assert.*;
+
+public final class AutosaveTest extends ToxCoreImplTestBase {
+
+    private static ToxAutosaveStats waitForSaves(ToxCore tox, int saves) throws InterruptedException {
+        ToxAutosaveStats stats = tox.getAutosaveStats();
+        for (int i = 0; i < 100 && stats.getSaves() < saves; i++) {
+            Thread.sleep(10);
+            stats = tox.getAutosaveStats();
+        }
+        return stats;
+    }
+
+    @Test
+    public void testUnchangedSavesAreSkipped() throws Exception {
+        File file = File.createTempFile("tox4j-autosave", ".tox");
+        file.deleteOnExit();
+
+        try (ToxCore tox = newTox()) {
+            tox.setAutosave(file.getPath(), 0);
+            tox.iteration();
+            assertEquals(1, waitForSaves(tox, 1).getSaves());
+
+            for (int i = 0; i < 10; i++) {
+                tox.iteration();
+            }
+            // The DHT state is part of the save data and may change through LAN discovery, so not every snapshot
+            // is necessarily identical.
+            ToxAutosaveStats stats = tox.getAutosaveStats();
+            assertTrue(stats.getSkipped() > 0);
+            assertTrue(stats.getSaves() + stats.getSkipped() <= 11);
+            assertEquals(0, stats.getFailures());
+            assertTrue(stats.getMaxLatency() >= stats.getLastLatency());
+        }
+    }
+
+    @Test
+    public void testChangesAreSaved() throws Exception {
+        File file = File.createTempFile("tox4j-autosave", ".tox");
+        file.deleteOnExit();
+
+        byte[] name = randomBytes(ToxConstants.MAX_NAME_LENGTH);
+        try (ToxCore tox = newTox()) {
+            tox.setAutosave(file.getPath(), 0);
+            tox.iteration();
+            waitForSaves(tox, 1);
+
+            tox.setName(name);
+            tox.iteration();
+            assertEquals(2, waitForSaves(tox, 2).getSaves());
+        }
+
+        try (ToxCore tox = newTox(Files.readAllBytes(file.toPath()))) {
+            assertArrayEquals(name, tox.getName());
+        }
+    }
+
+    @Test
+    public void testOtherFilesAreLeftAlone() throws Exception {
+        File file = File.createTempFile("tox4j-autosave", ".tox");
+        file.deleteOnExit();
+        File foreign = new File(file.getPath() + ".tmp");
+        foreign.deleteOnExit();
+        byte[] contents = randomBytes(100);
+        Files.write(foreign.toPath(), contents);
+
+        try (ToxCore tox = newTox()) {
+            tox.setAutosave(file.getPath(), 0);
+            tox.iteration();
+            assertEquals(1, waitForSaves(tox, 1).getSaves());
+        }
+
+        assertArrayEquals(contents, Files.readAllBytes(foreign.toPath()));
+    }
+
+}
@@ -0,0 +1,43 @@
+package im.tox.tox4j.core;
+
+import im.tox.tox4j.ToxCoreImplTestBase;
+import im.tox.tox4j.core.enums.ToxEventOverflow;
+import org.junit.Test;
+
+import static org.junit.Assert.*;
+
+public final class EventBudgetTest extends ToxCoreImplTestBase {
+
+    @Test
+    public void testIdleInstanceStaysWithinBudget() throws Exception {
+        try (ToxCore tox = newTox()) {
+            tox.setEventBudget(1024 * 1024, ToxEventOverflow.DROP_LOSSY);
+            for (int i = 0; i < 10; i++) {
+                tox.iteration();
+            }
+            ToxEventBudgetStats stats = tox.getEventBudgetStats();
+            assertTrue(stats.getHighWatermark() <= 1024 * 1024);
+            assertEquals(0, stats.getOverflows());
+            assertEquals(0, stats.getPaused());
+            assertEquals(0, stats.getDropped());
+        }
+    }
+
+    @Test
+    public void testBudgetCanBeRemoved() throws Exception {
+        try (ToxCore tox = newTox()) {
+            tox.setEventBudget(1024, ToxEventOverflow.PAUSE_TRANSFERS);
+            tox.setEventBudget(0, ToxEventOverflow.PAUSE_TRANSFERS);
+            tox.iteration();
+            assertEquals(0, tox.getEventBudgetStats().getOverflows());
+        }
+    }
+
+    @Test(expected = IllegalArgumentException.class)
+    public void testNegativeBudget() throws Exception {
+        try (ToxCore tox = newTox()) {
+            tox.setEventBudget(-1, ToxEventOverflow.PAUSE_TRANSFERS);
+        }
+    }
+
+}
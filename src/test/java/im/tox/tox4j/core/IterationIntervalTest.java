@@ -0,0 +1,50 @@
+package im.tox.tox4j.core;
+
+import im.tox.tox4j.ToxCoreImplTestBase;
+import org.junit.Test;
+
+import static org.junit.Assert.*;
+
+public final class IterationIntervalTest extends ToxCoreImplTestBase {
+
+    @Test(expected = IllegalArgumentException.class)
+    public void testZeroCapIsRejected() throws Exception {
+        try (ToxCore tox = newTox()) {
+            tox.setMaxIterationInterval(0);
+        }
+    }
+
+    @Test(expected = IllegalArgumentException.class)
+    public void testCapBelowActiveIntervalIsRejected() throws Exception {
+        try (ToxCore tox = newTox()) {
+            tox.setMaxIterationInterval(ToxConstants.MIN_ITERATION_INTERVAL - 1);
+        }
+    }
+
+    @Test
+    public void testCapIsApplied() throws Exception {
+        try (ToxCore tox = newTox()) {
+            tox.setMaxIterationInterval(ToxConstants.MIN_ITERATION_INTERVAL);
+            for (int i = 0; i < 10; i++) {
+                tox.iteration();
+                assertTrue(tox.iterationInterval() <= ToxConstants.MIN_ITERATION_INTERVAL);
+            }
+        }
+    }
+
+    @Test
+    public void testWakeupsDropToZeroWhenIdle() throws Exception {
+        try (ToxCore tox = newTox()) {
+            long end = System.currentTimeMillis() + 1100;
+            while (System.currentTimeMillis() < end) {
+                tox.iteration();
+                Thread.sleep(10);
+            }
+            assertTrue(tox.getIterationWakeups() > 0);
+
+            Thread.sleep(2100);
+            assertEquals(0, tox.getIterationWakeups());
+        }
+    }
+
+}
@@ -0,0 +1,105 @@
+package im.tox.tox4j.core;
+
+import im.tox.tox4j.ToxCoreImplTestBase;
+import im.tox.tox4j.annotations.NotNull;
+import im.tox.tox4j.core.callbacks.ToxEventAdapter;
+import im.tox.tox4j.core.enums.ToxConnection;
+import org.junit.Test;
+
+import static org.junit.Assert.*;
+
+public final class IterationLimitedTest extends ToxCoreImplTestBase {
+
+    @Test
+    public void testLimitedAndFullIterationsMix() throws Exception {
+        try (ToxCore tox = newTox()) {
+            for (int i = 0; i < 10; i++) {
+                tox.iteration(1, 16);
+                tox.iteration();
+            }
+            assertFalse(tox.iteration(Integer.MAX_VALUE, Integer.MAX_VALUE));
+        }
+    }
+
+    private static final int MESSAGES = 50;
+    private static final int MESSAGE_SIZE = 200;
+    // Room for three messages with their event framing, but not for four.
+    private static final int MAX_BYTES = 3 * MESSAGE_SIZE + MESSAGE_SIZE / 2;
+
+    private static final class Client extends ToxEventAdapter {
+        private ToxConnection connection = ToxConnection.NONE;
+        private int messages = 0;
+
+        @Override
+        public void friendConnectionStatus(int friendNumber, @NotNull ToxConnection connectionStatus) {
+            connection = connectionStatus;
+        }
+
+        @Override
+        public void friendMessage(int friendNumber, int timeDelta, @NotNull byte[] message) {
+            assertEquals(MESSAGE_SIZE, message.length);
+            assertEquals(messages, Integer.parseInt(new String(message).trim()));
+            messages++;
+        }
+    }
+
+    /**
+     * Alice sends a burst of messages that arrives in Bob's queue faster than he drains it in slices of MAX_BYTES. Each
+     * slice must stay within the byte limit, the messages must arrive in order, and the slices must report that more
+     * events are pending while the backlog lasts.
+     */
+    @Test(timeout = TIMEOUT)
+    public void testBacklogIsSplit() throws Exception {
+        try (ToxCore alice = newTox(false, true); ToxCore bob = newTox(false, true)) {
+            Client aliceEvents = new Client();
+            Client bobEvents = new Client();
+            alice.callback(aliceEvents);
+            bob.callback(bobEvents);
+            int bobNumber = alice.addFriendNoRequest(bob.getPublicKey());
+            bob.addFriendNoRequest(alice.getPublicKey());
+
+            while (aliceEvents.connection == ToxConnection.NONE || bobEvents.connection == ToxConnection.NONE) {
+                alice.iteration();
+                bob.iteration();
+                Thread.sleep(Math.max(alice.iterationInterval(), bob.iterationInterval()));
+            }
+
+            for (int i = 0; i < MESSAGES; i++) {
+                alice.sendMessage(bobNumber, String.format("%-" + MESSAGE_SIZE + "d", i).getBytes());
+            }
+
+            int splits = 0;
+            while (bobEvents.messages < MESSAGES) {
+                alice.iteration();
+                int before = bobEvents.messages;
+                boolean morePending = bob.iteration(Integer.MAX_VALUE, MAX_BYTES);
+                int delivered = bobEvents.messages - before;
+                assertTrue(delivered * MESSAGE_SIZE <= MAX_BYTES);
+                if (morePending) {
+                    // Only the byte limit can have cut the batch short.
+                    assertTrue(delivered > 0);
+                    splits++;
+                } else {
+                    Thread.sleep(Math.max(alice.iterationInterval(), bob.iterationInterval()));
+                }
+            }
+
+            assertTrue(splits > 0);
+        }
+    }
+
+    @Test(expected = IllegalArgumentException.class)
+    public void testZeroEvents() throws Exception {
+        try (ToxCore tox = newTox()) {
+            tox.iteration(0, 1024);
+        }
+    }
+
+    @Test(expected = IllegalArgumentException.class)
+    public void testNegativeBytes() throws Exception {
+        try (ToxCore tox = newTox()) {
+            tox.iteration(1, -1);
+        }
+    }
+
+}
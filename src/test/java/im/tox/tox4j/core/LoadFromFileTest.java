@@ -0,0 +1,101 @@
+package im.tox.tox4j.core;
+
+import im.tox.tox4j.ToxCoreImpl;
+import im.tox.tox4j.ToxCoreImplTestBase;
+import im.tox.tox4j.core.exceptions.ToxNewException;
+import org.junit.Test;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+import java.io.File;
+import java.io.IOException;
+import java.nio.file.Files;
+
+import static org.junit.Assert.*;
+
+public final class LoadFromFileTest extends ToxCoreImplTestBase {
+
+    private static final Logger logger = LoggerFactory.getLogger(LoadFromFileTest.class);
+
+    private static final int FRIENDS = 500;
+    private static final int LOADS = 20;
+
+    private static File saveToFile(byte[] data) throws IOException {
+        File file = File.createTempFile("tox4j-profile", ".tox");
+        file.deleteOnExit();
+        Files.write(file.toPath(), data);
+        return file;
+    }
+
+    @Test
+    public void testLoadFromFile() throws Exception {
+        byte[] name = randomBytes(ToxConstants.MAX_NAME_LENGTH);
+        byte[] publicKey;
+        File file;
+        try (ToxCore tox = newTox()) {
+            tox.setName(name);
+            publicKey = tox.getPublicKey();
+            file = saveToFile(tox.save());
+        }
+
+        try (ToxCore tox = ToxCoreImpl.fromFile(new ToxOptions(), file.getPath())) {
+            assertArrayEquals(name, tox.getName());
+            assertArrayEquals(publicKey, tox.getPublicKey());
+        }
+    }
+
+    @Test
+    public void testEmptyFile() throws Exception {
+        File file = saveToFile(new byte[0]);
+        try (ToxCore tox = ToxCoreImpl.fromFile(new ToxOptions(), file.getPath())) {
+            assertEquals(0, tox.getFriendList().length);
+        }
+    }
+
+    @Test
+    public void testMissingFile() throws Exception {
+        File file = saveToFile(new byte[0]);
+        assertTrue(file.delete());
+        try {
+            ToxCoreImpl.fromFile(new ToxOptions(), file.getPath()).close();
+            fail();
+        } catch (ToxNewException e) {
+            assertEquals(ToxNewException.Code.LOAD_IO, e.getCode());
+        }
+    }
+
+    /**
+     * Compares startup time of the byte[] path (read the file onto the heap, then copy it into native memory) with the
+     * memory-mapped path for a profile with many friends.
+     */
+    @Test
+    public void testStartupTime() throws Exception {
+        File file;
+        try (ToxCore tox = newTox()) {
+            for (int i = 0; i < FRIENDS; i++) {
+                tox.addFriendNoRequest(randomBytes(ToxConstants.PUBLIC_KEY_SIZE));
+            }
+            file = saveToFile(tox.save());
+        }
+
+        long bytesTime = 0;
+        long fileTime = 0;
+        for (int i = 0; i < LOADS; i++) {
+            long start = System.nanoTime();
+            try (ToxCore tox = new ToxCoreImpl(Files.readAllBytes(file.toPath()))) {
+                bytesTime += System.nanoTime() - start;
+                assertEquals(FRIENDS, tox.getFriendList().length);
+            }
+
+            start = System.nanoTime();
+            try (ToxCore tox = ToxCoreImpl.fromFile(new ToxOptions(), file.getPath())) {
+                fileTime += System.nanoTime() - start;
+                assertEquals(FRIENDS, tox.getFriendList().length);
+            }
+        }
+
+        logger.info(String.format("Loading a %d byte profile with %d friends: byte[] %.3f ms, mmap %.3f ms",
+                file.length(), FRIENDS, bytesTime / 1e6 / LOADS, fileTime / 1e6 / LOADS));
+    }
+
+}
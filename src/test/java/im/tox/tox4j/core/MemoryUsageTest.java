@@ -0,0 +1,37 @@
+package im.tox.tox4j.core;
+
+import im.tox.tox4j.ToxCoreImpl;
+import im.tox.tox4j.ToxCoreImplTestBase;
+import im.tox.tox4j.ToxNativeMemoryUsage;
+import org.junit.Test;
+
+import static org.junit.Assert.*;
+
+public final class MemoryUsageTest extends ToxCoreImplTestBase {
+
+    @Test
+    public void testInstanceUsage() throws Exception {
+        try (ToxCore tox = newTox()) {
+            ToxMemoryUsage usage = tox.getMemoryUsage();
+            assertTrue(usage.getCoreEstimate() >= 0);
+            assertTrue(usage.getInstance() > 0);
+            assertTrue(usage.getTransfers() >= 0);
+            assertTrue(usage.getBuffers() >= 0);
+            assertTrue(usage.getEvents() >= 0);
+            assertEquals(usage.getCoreEstimate() + usage.getTransfers() + usage.getBuffers() + usage.getEvents()
+                    + usage.getInstance(), usage.getTotal());
+        }
+    }
+
+    @Test
+    public void testNativeUsageGrowsWithInstances() throws Exception {
+        ToxNativeMemoryUsage before = ToxCoreImpl.getNativeMemoryUsage();
+        try (ToxCore tox = newTox()) {
+            ToxNativeMemoryUsage after = ToxCoreImpl.getNativeMemoryUsage();
+            assertEquals(before.getCoreInstances() + 1, after.getCoreInstances());
+            assertTrue(after.getAccounted() >= before.getAccounted() + tox.getMemoryUsage().getInstance());
+        }
+        assertEquals(before.getCoreInstances(), ToxCoreImpl.getNativeMemoryUsage().getCoreInstances());
+    }
+
+}
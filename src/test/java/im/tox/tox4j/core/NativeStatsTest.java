@@ -0,0 +1,82 @@
+package im.tox.tox4j.core;
+
+import im.tox.tox4j.ToxCoreImpl;
+import im.tox.tox4j.ToxCoreImplTestBase;
+import im.tox.tox4j.ToxMethodStats;
+import im.tox.tox4j.ToxNativeStats;
+import im.tox.tox4j.core.exceptions.ToxFriendGetPublicKeyException;
+import org.junit.After;
+import org.junit.Test;
+
+import static org.junit.Assert.*;
+
+public final class NativeStatsTest extends ToxCoreImplTestBase {
+
+    private static long calls(ToxNativeStats stats, String method) {
+        ToxMethodStats methodStats = stats.getMethod("core", method);
+        return methodStats == null ? 0 : methodStats.getCalls();
+    }
+
+    private static long errors(ToxNativeStats stats, String method, String code) {
+        ToxMethodStats methodStats = stats.getMethod("core", method);
+        if (methodStats == null || !methodStats.getErrorCodes().containsKey(code)) {
+            return 0;
+        }
+        return methodStats.getErrorCodes().get(code);
+    }
+
+    @After
+    public void disableStats() {
+        ToxCoreImpl.setNativeStatsEnabled(false);
+    }
+
+    @Test
+    public void testCallsAndErrorsAreRecorded() throws Exception {
+        ToxCoreImpl.setNativeStatsEnabled(true);
+        ToxNativeStats before = ToxCoreImpl.getNativeStats();
+        assertTrue(before.isEnabled());
+
+        try (ToxCore tox = newTox()) {
+            for (int i = 0; i < 10; i++) {
+                tox.iteration();
+            }
+            try {
+                tox.getPublicKey(1000);
+                fail();
+            } catch (ToxFriendGetPublicKeyException e) {
+                assertEquals(ToxFriendGetPublicKeyException.Code.FRIEND_NOT_FOUND, e.getCode());
+            }
+        }
+
+        ToxNativeStats after = ToxCoreImpl.getNativeStats();
+        assertTrue(calls(after, "Iteration") >= calls(before, "Iteration") + 10);
+        assertEquals(errors(before, "FriendGetPublicKey", "FRIEND_NOT_FOUND") + 1,
+                errors(after, "FriendGetPublicKey", "FRIEND_NOT_FOUND"));
+
+        ToxMethodStats iteration = after.getMethod("core", "Iteration");
+        assertNotNull(iteration);
+        assertTrue(iteration.getMaxLatency() > 0);
+        assertTrue(iteration.getLatencyPercentile(50) <= iteration.getLatencyPercentile(99));
+        assertTrue(iteration.getLatencyPercentile(99) <= iteration.getMaxLatency());
+
+        long histogramCalls = 0;
+        for (long count : iteration.getBucketCounts()) {
+            histogramCalls += count;
+        }
+        assertEquals(iteration.getCalls(), histogramCalls);
+    }
+
+    @Test
+    public void testNothingIsRecordedWhileDisabled() throws Exception {
+        ToxCoreImpl.setNativeStatsEnabled(false);
+        try (ToxCore tox = newTox()) {
+            ToxNativeStats before = ToxCoreImpl.getNativeStats();
+            assertFalse(before.isEnabled());
+            for (int i = 0; i < 10; i++) {
+                tox.iteration();
+            }
+            assertEquals(calls(before, "Iteration"), calls(ToxCoreImpl.getNativeStats(), "Iteration"));
+        }
+    }
+
+}
@@ -0,0 +1,109 @@
+package im.tox.tox4j.core;
+
+import im.tox.tox4j.ToxCoreImpl;
+import im.tox.tox4j.ToxCoreImplTestBase;
+import im.tox.tox4j.core.enums.ToxSaveFormat;
+import im.tox.tox4j.core.exceptions.ToxNewException;
+import org.junit.Test;
+
+import java.io.File;
+import java.nio.file.Files;
+import java.util.Arrays;
+
+import static org.junit.Assert.*;
+
+public final class SaveFormatTest extends ToxCoreImplTestBase {
+
+    private static final int FRIENDS = 200;
+
+    @Test
+    public void testPlainIsDefault() throws Exception {
+        try (ToxCore tox = newTox()) {
+            assertArrayEquals(tox.save(), tox.save(ToxSaveFormat.PLAIN));
+        }
+    }
+
+    @Test
+    public void testLoadCompressed() throws Exception {
+        byte[] name = randomBytes(ToxConstants.MAX_NAME_LENGTH);
+        byte[] plain;
+        byte[] compressed;
+        try (ToxCore tox = newTox()) {
+            tox.setName(name);
+            for (int i = 0; i < FRIENDS; i++) {
+                tox.addFriendNoRequest(randomBytes(ToxConstants.PUBLIC_KEY_SIZE));
+            }
+            plain = tox.save();
+            compressed = tox.save(ToxSaveFormat.LZ4);
+        }
+
+        try (ToxCore tox = newTox(compressed)) {
+            assertArrayEquals(name, tox.getName());
+            assertEquals(FRIENDS, tox.getFriendList().length);
+            assertArrayEquals(plain, tox.save());
+        }
+    }
+
+    @Test
+    public void testCompressedIsSmaller() throws Exception {
+        try (ToxCore tox = newTox()) {
+            for (int i = 0; i < FRIENDS; i++) {
+                tox.addFriendNoRequest(randomBytes(ToxConstants.PUBLIC_KEY_SIZE));
+            }
+            assertTrue(tox.save(ToxSaveFormat.LZ4).length < tox.save().length / 2);
+        }
+    }
+
+    @Test
+    public void testDamagedCompressed() throws Exception {
+        byte[] data;
+        try (ToxCore tox = newTox()) {
+            tox.setName(randomBytes(ToxConstants.MAX_NAME_LENGTH));
+            data = tox.save(ToxSaveFormat.LZ4);
+        }
+        data[data.length - 1] ^= 1;
+
+        try (ToxCore tox = newTox(data)) {
+            fail();
+        } catch (ToxNewException e) {
+            assertEquals(ToxNewException.Code.LOAD_BAD_FORMAT, e.getCode());
+        }
+    }
+
+    @Test
+    public void testTruncatedCompressed() throws Exception {
+        byte[] data;
+        try (ToxCore tox = newTox()) {
+            data = tox.save(ToxSaveFormat.LZ4);
+        }
+
+        try (ToxCore tox = newTox(Arrays.copyOf(data, data.length - 1))) {
+            fail();
+        } catch (ToxNewException e) {
+            assertEquals(ToxNewException.Code.LOAD_BAD_FORMAT, e.getCode());
+        }
+    }
+
+    @Test
+    public void testCompressedAutosave() throws Exception {
+        File file = File.createTempFile("tox4j-autosave", ".tox");
+        file.deleteOnExit();
+
+        byte[] name = randomBytes(ToxConstants.MAX_NAME_LENGTH);
+        try (ToxCore tox = newTox()) {
+            tox.setName(name);
+            tox.setAutosaveFormat(ToxSaveFormat.LZ4);
+            tox.setAutosave(file.getPath(), 0);
+            tox.iteration();
+            for (int i = 0; i < 100 && tox.getAutosaveStats().getSaves() == 0; i++) {
+                Thread.sleep(10);
+            }
+        }
+
+        assertArrayEquals("TOXZ".getBytes(), Arrays.copyOf(Files.readAllBytes(file.toPath()), 4));
+        try (ToxCore tox = ToxCoreImpl.fromFile(new ToxOptions(), file.getPath())) {
+            assertArrayEquals(name, tox.getName());
+        }
+    }
+
+}
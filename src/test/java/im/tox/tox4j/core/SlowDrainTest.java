@@ -0,0 +1,83 @@
+package im.tox.tox4j.core;
+
+import im.tox.tox4j.ToxCoreImplTestBase;
+import im.tox.tox4j.annotations.NotNull;
+import im.tox.tox4j.core.callbacks.ToxEventAdapter;
+import im.tox.tox4j.core.enums.ToxConnection;
+import org.junit.Test;
+
+import static org.junit.Assert.*;
+
+/**
+ * Bob hands out a large backlog of messages one event at a time, slower than they arrived. The main loop has to keep
+ * running during the drain, so Bob keeps waking up and stays connected to Alice.
+ */
+public final class SlowDrainTest extends ToxCoreImplTestBase {
+
+    private static final int MESSAGES = 100;
+    // Long enough for the wake-up count of a stalled main loop to drop to 0.
+    private static final long DRAIN_TIME = 2500;
+
+    private static final class Client extends ToxEventAdapter {
+        private ToxConnection connection = ToxConnection.NONE;
+        private boolean disconnected = false;
+        private int messages = 0;
+
+        @Override
+        public void friendConnectionStatus(int friendNumber, @NotNull ToxConnection connectionStatus) {
+            if (connection != ToxConnection.NONE && connectionStatus == ToxConnection.NONE) {
+                disconnected = true;
+            }
+            connection = connectionStatus;
+        }
+
+        @Override
+        public void friendMessage(int friendNumber, int timeDelta, @NotNull byte[] message) {
+            assertEquals(Integer.toString(messages), new String(message));
+            messages++;
+        }
+    }
+
+    @Test(timeout = TIMEOUT)
+    public void testMainLoopRunsDuringDrain() throws Exception {
+        try (ToxCore alice = newTox(false, true); ToxCore bob = newTox(false, true)) {
+            Client aliceEvents = new Client();
+            Client bobEvents = new Client();
+            alice.callback(aliceEvents);
+            bob.callback(bobEvents);
+            int bobNumber = alice.addFriendNoRequest(bob.getPublicKey());
+            bob.addFriendNoRequest(alice.getPublicKey());
+
+            while (aliceEvents.connection == ToxConnection.NONE || bobEvents.connection == ToxConnection.NONE) {
+                alice.iteration();
+                bob.iteration();
+                Thread.sleep(Math.max(alice.iterationInterval(), bob.iterationInterval()));
+            }
+
+            for (int i = 0; i < MESSAGES; i++) {
+                alice.sendMessage(bobNumber, Integer.toString(i).getBytes());
+            }
+
+            // Deliver one event per call, with a pause that makes the drain take longer than DRAIN_TIME.
+            long drainStart = 0;
+            boolean checked = false;
+            while (bobEvents.messages < MESSAGES) {
+                alice.iteration();
+                boolean pending = bob.iteration(1, Integer.MAX_VALUE);
+                if (pending && drainStart == 0 && bobEvents.messages > 0) {
+                    drainStart = System.currentTimeMillis();
+                }
+                if (drainStart != 0 && !checked && System.currentTimeMillis() - drainStart > DRAIN_TIME) {
+                    assertTrue(bob.getIterationWakeups() > 0);
+                    checked = true;
+                }
+                Thread.sleep(DRAIN_TIME * 2 / MESSAGES);
+            }
+
+            assertTrue(checked);
+            assertFalse(aliceEvents.disconnected);
+            assertFalse(bobEvents.disconnected);
+        }
+    }
+
+}
@@ -0,0 +1,195 @@
+package im.tox.tox4j.core.callbacks;
+
+import im.tox.tox4j.AliceBobTestBase;
+import im.tox.tox4j.annotations.NotNull;
+import im.tox.tox4j.core.ToxCore;
+import im.tox.tox4j.core.ToxEventBudgetStats;
+import im.tox.tox4j.core.enums.ToxConnection;
+import im.tox.tox4j.core.enums.ToxEventOverflow;
+import im.tox.tox4j.core.enums.ToxFileControl;
+import im.tox.tox4j.core.enums.ToxFileKind;
+import im.tox.tox4j.exceptions.ToxException;
+
+import java.util.Arrays;
+import java.util.Random;
+
+import static org.junit.Assert.*;
+
+/**
+ * Bob receives a file and then a stream of lossy packets under an event budget of a few chunks per iteration. While
+ * the file arrives, the overflow policy is to pause the transfer, which must happen at least once without corrupting
+ * the file. Bob then switches to dropping lossy packets, and Alice sends them in bursts larger than the budget until
+ * Bob has dropped some.
+ */
+public class EventBudgetTransferTest extends AliceBobTestBase {
+
+    private static final int BUDGET = 4096;
+
+    @NotNull
+    @Override
+    protected ChatClient newAlice() {
+        return new Client();
+    }
+
+
+    private static class Client extends ChatClient {
+
+        private static final byte[] fileData = new byte[256 * 1024];
+        static {
+            new Random().nextBytes(fileData);
+        }
+
+        // First bytes of the custom packets; toxcore reserves these ranges for them.
+        private static final byte LOSSLESS_ID = (byte) 160;
+        private static final byte LOSSY_ID = (byte) 200;
+        // Lossless commands from Bob to Alice.
+        private static final byte START_LOSSY = 1;
+        private static final byte STOP_LOSSY = 2;
+
+        private final byte[] receivedData = new byte[fileData.length];
+        private long position = 0;
+        // Alice: whether to keep sending lossy bursts.
+        private boolean sendingLossy = false;
+
+        @Override
+        public void setup(ToxCore tox) throws ToxException {
+            if (isBob()) {
+                tox.setEventBudget(BUDGET, ToxEventOverflow.PAUSE_TRANSFERS);
+            }
+        }
+
+        public void friendConnectionStatus(final int friendNumber, @NotNull ToxConnection connection) {
+            if (connection != ToxConnection.NONE) {
+                debug("is now connected to friend " + friendNumber);
+                assertEquals(FRIEND_NUMBER, friendNumber);
+                if (isBob()) return;
+                addTask(new Task() {
+                    @Override
+                    public void perform(@NotNull ToxCore tox) throws ToxException {
+                        tox.fileSend(friendNumber, ToxFileKind.DATA, fileData.length,
+                                ("file for " + getFriendName() + ".bin").getBytes());
+                    }
+                });
+            }
+        }
+
+        @Override
+        public void fileReceive(final int friendNumber, final int fileNumber, @NotNull ToxFileKind kind, long fileSize, @NotNull byte[] filename) {
+            assertTrue(isBob());
+            assertEquals(fileData.length, fileSize);
+            addTask(new Task() {
+                @Override
+                public void perform(@NotNull ToxCore tox) throws ToxException {
+                    tox.fileControl(friendNumber, fileNumber, ToxFileControl.RESUME);
+                }
+            });
+        }
+
+        @Override
+        public void fileControl(int friendNumber, int fileNumber, @NotNull ToxFileControl control) {
+            // Alice sees the pauses and resumes caused by Bob's budget. Chunks answered while paused are discarded
+            // and requested again after the resume, so she just keeps answering.
+            assertTrue(isAlice());
+            debug("file control " + control);
+        }
+
+        @Override
+        public void fileRequestChunk(final int friendNumber, final int fileNumber, final long position, final int length) {
+            assertTrue(isAlice());
+            if (length == 0) {
+                return;
+            }
+            addTask(new Task() {
+                @Override
+                public void perform(@NotNull ToxCore tox) throws ToxException {
+                    tox.fileSendChunk(friendNumber, fileNumber, position,
+                            Arrays.copyOfRange(fileData, (int) position, (int) position + length));
+                }
+            });
+        }
+
+        @Override
+        public void fileReceiveChunk(final int friendNumber, final int fileNumber, long position, @NotNull byte[] data) {
+            assertTrue(isBob());
+            assertEquals(this.position, position);
+            System.arraycopy(data, 0, receivedData, (int) position, data.length);
+            this.position += data.length;
+
+            if (this.position == receivedData.length) {
+                assertArrayEquals(fileData, receivedData);
+                addTask(new Task() {
+                    @Override
+                    public void perform(@NotNull ToxCore tox) throws ToxException {
+                        ToxEventBudgetStats stats = tox.getEventBudgetStats();
+                        debug("paused the transfer " + stats.getPaused() + " times");
+                        assertTrue(stats.getPaused() > 0);
+                        assertEquals(0, stats.getDropped());
+
+                        tox.setEventBudget(BUDGET, ToxEventOverflow.DROP_LOSSY);
+                        tox.sendLosslessPacket(friendNumber, new byte[] { LOSSLESS_ID, START_LOSSY });
+                    }
+                });
+            }
+        }
+
+        @Override
+        public void friendLosslessPacket(int friendNumber, @NotNull byte[] packet) {
+            assertTrue(isAlice());
+            assertEquals(LOSSLESS_ID, packet[0]);
+            if (packet[1] == START_LOSSY) {
+                sendingLossy = true;
+                addTask(new LossyBurst(friendNumber));
+            } else {
+                assertEquals(STOP_LOSSY, packet[1]);
+                sendingLossy = false;
+                finish();
+            }
+        }
+
+        // Sends more than the budget in lossy packets on every iteration until Bob asks to stop.
+        private final class LossyBurst extends Task {
+            private final int friendNumber;
+
+            LossyBurst(int friendNumber) {
+                this.friendNumber = friendNumber;
+            }
+
+            @Override
+            public void perform(@NotNull ToxCore tox) throws ToxException {
+                if (!sendingLossy) {
+                    return;
+                }
+                byte[] packet = new byte[1024];
+                packet[0] = LOSSY_ID;
+                for (int i = 0; i < 4 * BUDGET / packet.length; i++) {
+                    tox.sendLossyPacket(friendNumber, packet);
+                }
+                addTask(this);
+            }
+        }
+
+        @Override
+        public void friendLossyPacket(final int friendNumber, @NotNull byte[] packet) {
+            assertTrue(isBob());
+            assertEquals(LOSSY_ID, packet[0]);
+            if (!isChatting()) {
+                return;
+            }
+            addTask(new Task() {
+                @Override
+                public void perform(@NotNull ToxCore tox) throws ToxException {
+                    ToxEventBudgetStats stats = tox.getEventBudgetStats();
+                    if (stats.getDropped() == 0 || !isChatting()) {
+                        return;
+                    }
+                    debug("dropped " + stats.getDropped() + " lossy packets");
+                    assertTrue(stats.getPaused() > 0);
+                    tox.sendLosslessPacket(friendNumber, new byte[] { LOSSLESS_ID, STOP_LOSSY });
+                    finish();
+                }
+            });
+        }
+
+    }
+
+}
@@ -0,0 +1,131 @@
+package im.tox.tox4j.core.callbacks;
+
+import im.tox.tox4j.AliceBobTestBase;
+import im.tox.tox4j.annotations.NotNull;
+import im.tox.tox4j.core.ToxCore;
+import im.tox.tox4j.core.enums.ToxConnection;
+import im.tox.tox4j.core.enums.ToxFileControl;
+import im.tox.tox4j.core.enums.ToxFileKind;
+import im.tox.tox4j.exceptions.ToxException;
+
+import java.util.Arrays;
+import java.util.Random;
+
+import static org.junit.Assert.*;
+
+/**
+ * Bob pauses the transfer halfway and resumes it a little later. Alice drops every chunk request she has not answered
+ * when the pause arrives, so the transfer only completes if the native layer requests that data again.
+ */
+public class FilePauseResumeTest extends AliceBobTestBase {
+
+    @NotNull
+    @Override
+    protected ChatClient newAlice() {
+        return new Client();
+    }
+
+
+    private static class Client extends ChatClient {
+
+        private static final byte[] fileData = new byte[256 * 1024];
+        static {
+            new Random().nextBytes(fileData);
+        }
+
+        private final byte[] receivedData = new byte[fileData.length];
+        private long position = 0;
+        private boolean pausedOnce = false;
+        // Alice: incremented on every pause, so that requests from before it are dropped.
+        private int pauses = 0;
+
+        public void friendConnectionStatus(final int friendNumber, @NotNull ToxConnection connection) {
+            if (connection != ToxConnection.NONE) {
+                debug("is now connected to friend " + friendNumber);
+                assertEquals(FRIEND_NUMBER, friendNumber);
+                if (isBob()) return;
+                addTask(new Task() {
+                    @Override
+                    public void perform(@NotNull ToxCore tox) throws ToxException {
+                        tox.fileSend(friendNumber, ToxFileKind.DATA, fileData.length,
+                                ("file for " + getFriendName() + ".bin").getBytes());
+                    }
+                });
+            }
+        }
+
+        @Override
+        public void fileReceive(final int friendNumber, final int fileNumber, @NotNull ToxFileKind kind, long fileSize, @NotNull byte[] filename) {
+            assertTrue(isBob());
+            assertEquals(fileData.length, fileSize);
+            addTask(new Task() {
+                @Override
+                public void perform(@NotNull ToxCore tox) throws ToxException {
+                    tox.fileControl(friendNumber, fileNumber, ToxFileControl.RESUME);
+                }
+            });
+        }
+
+        @Override
+        public void fileControl(int friendNumber, int fileNumber, @NotNull ToxFileControl control) {
+            if (isAlice() && control == ToxFileControl.PAUSE) {
+                debug("dropping unanswered chunk requests");
+                pauses++;
+            }
+        }
+
+        @Override
+        public void fileRequestChunk(final int friendNumber, final int fileNumber, final long position, final int length) {
+            assertTrue(isAlice());
+            if (length == 0) {
+                finish();
+                return;
+            }
+            final int requestedBefore = pauses;
+            addTask(new Task() {
+                @Override
+                public void perform(@NotNull ToxCore tox) throws ToxException {
+                    if (requestedBefore != pauses) {
+                        return;
+                    }
+                    tox.fileSendChunk(friendNumber, fileNumber, position,
+                            Arrays.copyOfRange(fileData, (int) position, (int) position + length));
+                }
+            });
+        }
+
+        @Override
+        public void fileReceiveChunk(final int friendNumber, final int fileNumber, long position, @NotNull byte[] data) {
+            assertTrue(isBob());
+            assertEquals(this.position, position);
+            System.arraycopy(data, 0, receivedData, (int) position, data.length);
+            this.position += data.length;
+
+            if (!pausedOnce && this.position >= receivedData.length / 2) {
+                pausedOnce = true;
+                addTask(new Task() {
+                    @Override
+                    public void perform(@NotNull ToxCore tox) throws ToxException {
+                        tox.fileControl(friendNumber, fileNumber, ToxFileControl.PAUSE);
+                    }
+                });
+                addTask(new Task() {
+                    {
+                        sleep(10);
+                    }
+
+                    @Override
+                    public void perform(@NotNull ToxCore tox) throws ToxException {
+                        tox.fileControl(friendNumber, fileNumber, ToxFileControl.RESUME);
+                    }
+                });
+            }
+
+            if (this.position == receivedData.length) {
+                assertArrayEquals(fileData, receivedData);
+                finish();
+            }
+        }
+    }
+
+}
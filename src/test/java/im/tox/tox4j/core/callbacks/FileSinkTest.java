@@ -0,0 +1,115 @@
+package im.tox.tox4j.core.callbacks;
+
+import im.tox.tox4j.AliceBobTestBase;
+import im.tox.tox4j.annotations.NotNull;
+import im.tox.tox4j.core.ToxCore;
+import im.tox.tox4j.core.enums.ToxConnection;
+import im.tox.tox4j.core.enums.ToxFileControl;
+import im.tox.tox4j.core.enums.ToxFileKind;
+import im.tox.tox4j.exceptions.ToxException;
+
+import java.io.File;
+import java.io.IOException;
+import java.nio.file.Files;
+import java.util.Arrays;
+import java.util.Random;
+
+import static org.junit.Assert.*;
+
+/**
+ * Bob receives a file straight into a native sink, over an existing longer file, and only sees progress events, then
+ * checks the file on disk.
+ */
+public class FileSinkTest extends AliceBobTestBase {
+
+    @NotNull
+    @Override
+    protected ChatClient newAlice() {
+        return new Client();
+    }
+
+
+    private static class Client extends ChatClient {
+
+        private static final byte[] fileData = new byte[256 * 1024];
+        static {
+            new Random().nextBytes(fileData);
+        }
+
+        private File sink;
+        private long position = 0;
+
+        public void friendConnectionStatus(final int friendNumber, @NotNull ToxConnection connection) {
+            if (connection != ToxConnection.NONE) {
+                debug("is now connected to friend " + friendNumber);
+                assertEquals(FRIEND_NUMBER, friendNumber);
+                if (isBob()) return;
+                addTask(new Task() {
+                    @Override
+                    public void perform(@NotNull ToxCore tox) throws ToxException {
+                        tox.fileSend(friendNumber, ToxFileKind.DATA, fileData.length,
+                                ("file for " + getFriendName() + ".bin").getBytes());
+                    }
+                });
+            }
+        }
+
+        @Override
+        public void fileReceive(final int friendNumber, final int fileNumber, @NotNull ToxFileKind kind, long fileSize, @NotNull byte[] filename) {
+            assertTrue(isBob());
+            assertEquals(fileData.length, fileSize);
+            addTask(new Task() {
+                @Override
+                public void perform(@NotNull ToxCore tox) throws ToxException {
+                    try {
+                        sink = File.createTempFile("tox4j-sink", ".bin");
+                        sink.deleteOnExit();
+                        // A longer file is already there, whose tail must not survive the transfer.
+                        Files.write(sink.toPath(), new byte[fileData.length * 2]);
+                    } catch (IOException e) {
+                        throw new RuntimeException(e);
+                    }
+                    tox.fileSetSink(friendNumber, fileNumber, sink.getPath());
+                    tox.fileControl(friendNumber, fileNumber, ToxFileControl.RESUME);
+                }
+            });
+        }
+
+        @Override
+        public void fileRequestChunk(final int friendNumber, final int fileNumber, final long position, final int length) {
+            assertTrue(isAlice());
+            if (length == 0) {
+                finish();
+                return;
+            }
+            addTask(new Task() {
+                @Override
+                public void perform(@NotNull ToxCore tox) throws ToxException {
+                    tox.fileSendChunk(friendNumber, fileNumber, position,
+                            Arrays.copyOfRange(fileData, (int) position, (int) position + length));
+                }
+            });
+        }
+
+        @Override
+        public void fileReceiveChunk(int friendNumber, int fileNumber, long position, @NotNull byte[] data) {
+            fail("Chunks for a transfer with a sink should not reach the client");
+        }
+
+        @Override
+        public void fileProgress(int friendNumber, int fileNumber, long position) {
+            assertTrue(isBob());
+            assertTrue(position > this.position);
+            this.position = position;
+            if (position == fileData.length) {
+                try {
+                    assertArrayEquals(fileData, Files.readAllBytes(sink.toPath()));
+                } catch (IOException e) {
+                    throw new RuntimeException(e);
+                }
+                finish();
+            }
+        }
+    }
+
+}
@@ -0,0 +1,103 @@
+package im.tox.tox4j.core.callbacks;
+
+import im.tox.tox4j.AliceBobTestBase;
+import im.tox.tox4j.annotations.NotNull;
+import im.tox.tox4j.core.ToxCore;
+import im.tox.tox4j.core.enums.ToxConnection;
+import im.tox.tox4j.core.enums.ToxFileControl;
+import im.tox.tox4j.core.enums.ToxFileKind;
+import im.tox.tox4j.exceptions.ToxException;
+
+import java.io.File;
+import java.io.IOException;
+import java.nio.file.Files;
+import java.util.Random;
+
+import static org.junit.Assert.*;
+
+/**
+ * Alice sends a file straight from disk. She only sees progress events, while Bob receives the chunks as usual.
+ */
+public class FileSourceTest extends AliceBobTestBase {
+
+    @NotNull
+    @Override
+    protected ChatClient newAlice() {
+        return new Client();
+    }
+
+
+    private static class Client extends ChatClient {
+
+        private static final byte[] fileData = new byte[256 * 1024];
+        static {
+            new Random().nextBytes(fileData);
+        }
+
+        private final byte[] receivedData = new byte[fileData.length];
+        private long position = 0;
+
+        public void friendConnectionStatus(final int friendNumber, @NotNull ToxConnection connection) {
+            if (connection != ToxConnection.NONE) {
+                debug("is now connected to friend " + friendNumber);
+                assertEquals(FRIEND_NUMBER, friendNumber);
+                if (isBob()) return;
+                addTask(new Task() {
+                    @Override
+                    public void perform(@NotNull ToxCore tox) throws ToxException {
+                        File source;
+                        try {
+                            source = File.createTempFile("tox4j-source", ".bin");
+                            source.deleteOnExit();
+                            Files.write(source.toPath(), fileData);
+                        } catch (IOException e) {
+                            throw new RuntimeException(e);
+                        }
+                        tox.fileSendFromPath(friendNumber, ToxFileKind.DATA, source.getPath(),
+                                ("file for " + getFriendName() + ".bin").getBytes());
+                    }
+                });
+            }
+        }
+
+        @Override
+        public void fileReceive(final int friendNumber, final int fileNumber, @NotNull ToxFileKind kind, long fileSize, @NotNull byte[] filename) {
+            assertTrue(isBob());
+            assertEquals(fileData.length, fileSize);
+            addTask(new Task() {
+                @Override
+                public void perform(@NotNull ToxCore tox) throws ToxException {
+                    tox.fileControl(friendNumber, fileNumber, ToxFileControl.RESUME);
+                }
+            });
+        }
+
+        @Override
+        public void fileRequestChunk(int friendNumber, int fileNumber, long position, int length) {
+            fail("Chunks for a transfer from a file source should not be requested from the client");
+        }
+
+        @Override
+        public void fileProgress(int friendNumber, int fileNumber, long position) {
+            assertTrue(isAlice());
+            assertTrue(position >= this.position);
+            this.position = position;
+            if (position == fileData.length) {
+                finish();
+            }
+        }
+
+        @Override
+        public void fileReceiveChunk(int friendNumber, int fileNumber, long position, @NotNull byte[] data) {
+            assertTrue(isBob());
+            assertEquals(this.position, position);
+            System.arraycopy(data, 0, receivedData, (int) position, data.length);
+            this.position += data.length;
+            if (this.position == receivedData.length) {
+                assertArrayEquals(fileData, receivedData);
+                finish();
+            }
+        }
+    }
+
+}
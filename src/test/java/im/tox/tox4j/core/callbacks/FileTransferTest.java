@@ -90,7 +90,7 @@ public class FileTransferTest extends AliceBobTestBase {
                 @Override
                 public void perform(@NotNull ToxCore tox) throws ToxException {
                     debug("sending " + length + "B to " + friendNumber);
-                    tox.fileSendChunk(friendNumber, fileNumber,
+                    tox.fileSendChunk(friendNumber, fileNumber, position,
                             Arrays.copyOfRange(fileData, (int) position, Math.min((int) position + length, fileData.length)));
                 }
             });
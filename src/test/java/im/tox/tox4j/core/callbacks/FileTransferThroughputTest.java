@@ -0,0 +1,102 @@
+package im.tox.tox4j.core.callbacks;
+
+import im.tox.tox4j.AliceBobTestBase;
+import im.tox.tox4j.annotations.NotNull;
+import im.tox.tox4j.core.ToxCore;
+import im.tox.tox4j.core.enums.ToxConnection;
+import im.tox.tox4j.core.enums.ToxFileControl;
+import im.tox.tox4j.core.enums.ToxFileKind;
+import im.tox.tox4j.exceptions.ToxException;
+
+import java.util.Arrays;
+import java.util.Random;
+
+import static org.junit.Assert.*;
+
+/**
+ * Sends a larger file between Alice and Bob on the loopback interface and reports the achieved throughput. The native
+ * layer keeps several chunk requests outstanding per transfer, so this should be well above one chunk per iteration.
+ */
+public class FileTransferThroughputTest extends AliceBobTestBase {
+
+    @NotNull
+    @Override
+    protected ChatClient newAlice() {
+        return new Client();
+    }
+
+
+    private static class Client extends ChatClient {
+
+        private static final byte[] fileData = new byte[1024 * 1024];
+        static {
+            new Random().nextBytes(fileData);
+        }
+
+        private final byte[] receivedData = new byte[fileData.length];
+        private long position = 0;
+        private long startTime = 0;
+        private int chunks = 0;
+
+        public void friendConnectionStatus(final int friendNumber, @NotNull ToxConnection connection) {
+            if (connection != ToxConnection.NONE) {
+                debug("is now connected to friend " + friendNumber);
+                assertEquals(FRIEND_NUMBER, friendNumber);
+                if (isBob()) return;
+                addTask(new Task() {
+                    @Override
+                    public void perform(@NotNull ToxCore tox) throws ToxException {
+                        tox.fileSend(friendNumber, ToxFileKind.DATA, fileData.length,
+                                ("file for " + getFriendName() + ".bin").getBytes());
+                    }
+                });
+            }
+        }
+
+        @Override
+        public void fileReceive(final int friendNumber, final int fileNumber, @NotNull ToxFileKind kind, long fileSize, @NotNull byte[] filename) {
+            assertTrue(isBob());
+            assertEquals(fileData.length, fileSize);
+            addTask(new Task() {
+                @Override
+                public void perform(@NotNull ToxCore tox) throws ToxException {
+                    startTime = System.nanoTime();
+                    tox.fileControl(friendNumber, fileNumber, ToxFileControl.RESUME);
+                }
+            });
+        }
+
+        @Override
+        public void fileRequestChunk(final int friendNumber, final int fileNumber, final long position, final int length) {
+            assertTrue(isAlice());
+            if (length == 0) {
+                finish();
+                return;
+            }
+            addTask(new Task() {
+                @Override
+                public void perform(@NotNull ToxCore tox) throws ToxException {
+                    tox.fileSendChunk(friendNumber, fileNumber, position,
+                            Arrays.copyOfRange(fileData, (int) position, (int) position + length));
+                }
+            });
+        }
+
+        @Override
+        public void fileReceiveChunk(int friendNumber, int fileNumber, long position, @NotNull byte[] data) {
+            assertTrue(isBob());
+            assertEquals(this.position, position);
+            System.arraycopy(data, 0, receivedData, (int) position, data.length);
+            this.position += data.length;
+            chunks++;
+            if (this.position == receivedData.length) {
+                assertArrayEquals(fileData, receivedData);
+                double seconds = (System.nanoTime() - startTime) / 1e9;
+                debug(String.format("received %d bytes in %d chunks in %.3f s (%.1f KiB/s)",
+                        receivedData.length, chunks, seconds, receivedData.length / 1024d / seconds));
+                finish();
+            }
+        }
+    }
+
+}
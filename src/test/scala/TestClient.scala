@@ -129,6 +129,10 @@ object TestClient extends App {
       logger.info(s"[$id] fileReceiveChunk($friendNumber, $fileNumber, $position, ${new String(data)})")
     }
 
+    override def fileProgress(friendNumber: Int, fileNumber: Int, position: Long): Unit = {
+      logger.info(s"[$id] fileProgress($friendNumber, $fileNumber, $position)")
+    }
+
     override def friendLosslessPacket(friendNumber: Int, data: Array[Byte]): Unit = {
       logger.info(s"[$id] friendLosslessPacket($friendNumber, ${new String(data)})")
     }